@@ -4,11 +4,15 @@
  */
 
 #include "Apps.h"
+#include "ClockService.h"
+#include "ColorDraw.h"
 #include "DisplayManager.h"
 #include "Globals.h"
+#include "LoopWatchdog.h"
+#include "NotifyManager.h"
+#include "TimerManager.h"
 #include "Tools.h"
 #include <arduinoFFT.h>
-#include <time.h>
 
 // ==================================================================
 // 全局应用列表
@@ -16,8 +20,10 @@
 
 std::vector<AppData> Apps;
 
-// 覆盖层回调数组
-OverlayCallback overlays[] = {SpectrumOverlay};
+// 覆盖层回调数组 (按顺序绘制，响铃在最上层)
+OverlayCallback overlays[] = {SpectrumOverlay, TimerOverlay, NotifyOverlay,
+                              AlarmOverlay};
+const uint8_t overlayCount = sizeof(overlays) / sizeof(overlays[0]);
 
 // ==================================================================
 // FFT 变量 (频谱覆盖层专用)
@@ -26,12 +32,17 @@ OverlayCallback overlays[] = {SpectrumOverlay};
 #define FFT_SAMPLES 512
 #define SAMPLING_FREQ 10000
 #define SAMPLING_PERIOD_US (1000000UL / SAMPLING_FREQ)
-#define AMPLITUDE 300 // 灵敏度控制 (越小越灵敏)
-#define NUM_BANDS 32  // 32条频谱，对应32列
-#define NOISE 220     // 噪声阈值 (越小越灵敏)
+#define AMPLITUDE 300 // 初始灵敏度 (每格幅值，AGC 从此起步)
+#define NUM_BANDS SPECTRUM_BANDS
+#define NOISE 220     // 初始噪声阈值 (AGC 从此起步)
 #define MIC_PIN 33
 #define SPECTRUM_MODES 5 // 模式数量 (与参考代码一致)
 
+// 自动增益 (AGC) 与噪声底跟踪
+#define AGC_MIN_AMPLITUDE 40   // 每格幅值下限 (安静时最高灵敏度)
+#define AGC_MAX_AMPLITUDE 4000 // 每格幅值上限
+#define AGC_MIN_NOISE 60       // 噪声阈值下限
+
 static double vReal[FFT_SAMPLES];
 static double vImag[FFT_SAMPLES];
 static byte peak[NUM_BANDS] = {0};
@@ -41,15 +52,166 @@ static int bandValues[NUM_BANDS] = {0};
 static unsigned long peekDecayTime = 0;
 static int spectrumMode = 0; // 当前模式
 static int colorTime = 0;    // 颜色时间
+static int amplitude = AMPLITUDE;      // 当前每格幅值 (AGC)
+static int noiseThreshold = NOISE;     // 当前噪声阈值 (跟踪噪声底)
+static int32_t noiseFloorQ4 = NOISE * 16 * 2 / 3; // 噪声底估计 (×16 定点)
+static int32_t levelPeak = AMPLITUDE * 8;         // 最响频段的衰减峰值
+static double (*spectrumSource)(int) = nullptr; // 注入的音频输入 (渲染检查)
 
 ArduinoFFT<double> FFT(vReal, vImag, FFT_SAMPLES, (double)SAMPLING_FREQ);
 
-// 频段映射表 (32 bands, 低频到高频分布)
-// 每个频段覆盖的FFT索引范围
+// 经典频段表 (32 条，低频到高频)
+// 每个频段覆盖的FFT索引范围 [起, 止)
 
-static const int bandRanges[][2] = {
+static const uint8_t bandRanges[][2] = {
     {6, 9}, {9, 11}, {11, 13}, {13, 15}, {15, 17}, {17, 19}, {19, 21}, {21, 23}, {23, 25}, {25, 27}, {27, 29}, {29, 31}, {31, 33}, {33, 35}, {35, 38}, {38, 41}, {41, 44}, {44, 47}, {47, 50}, {50, 53}, {53, 56}, {56, 59}, {59, 62}, {62, 65}, {65, 68}, {68, 71}, {71, 74}, {74, 77}, {77, 80}, {80, 83}, {83, 87}, {87, 91}};
 
+static const uint8_t CLASSIC_BANDS = sizeof(bandRanges) / sizeof(bandRanges[0]);
+
+// FFT 频点 → 频段查找表 (0xFF=不属于任何频段)，布局变化时重建
+static uint8_t binBand[FFT_SAMPLES / 2];
+static uint16_t lutFirst = 0, lutEnd = 0; // 有效频点范围 [lutFirst, lutEnd)，范围内连续
+static uint8_t lutLayout = 0xFF;          // 构建查找表时的布局 (0xFF=未构建)
+static uint16_t lutMinHz = 0, lutMaxHz = 0;
+
+/**
+ * @brief 按当前布局重建查找表
+ *
+ * 经典布局直接展开 bandRanges (频谱条数与表不一致时改用对数布局)；
+ * 对数布局把 [SPECTRUM_MIN_HZ, SPECTRUM_MAX_HZ] 按等比分成 NUM_BANDS 段，
+ * 每段至少一个频点。
+ */
+static void spectrumBuildBands()
+{
+  lutLayout = SPECTRUM_BAND_LAYOUT;
+  lutMinHz = SPECTRUM_MIN_HZ;
+  lutMaxHz = SPECTRUM_MAX_HZ;
+  memset(binBand, 0xFF, sizeof(binBand));
+
+  if (lutLayout == SPECTRUM_LAYOUT_CLASSIC && CLASSIC_BANDS == NUM_BANDS)
+  {
+    for (uint8_t band = 0; band < CLASSIC_BANDS; band++)
+    {
+      for (uint8_t i = bandRanges[band][0]; i < bandRanges[band][1]; i++)
+        binBand[i] = band;
+    }
+    lutFirst = bandRanges[0][0];
+    lutEnd = bandRanges[CLASSIC_BANDS - 1][1];
+    return;
+  }
+
+  const float binHz = (float)SAMPLING_FREQ / FFT_SAMPLES;
+  const uint16_t maxBin = FFT_SAMPLES / 2;
+  uint16_t lo = lroundf(lutMinHz / binHz);
+  uint16_t hi = lroundf(lutMaxHz / binHz);
+  if (lo < 2) // 0/1 频点是直流残余
+    lo = 2;
+  if (hi > maxBin)
+    hi = maxBin;
+  if (hi <= lo)
+    hi = lo + 1;
+
+  const float ratio = (float)hi / lo;
+  uint16_t start = lo;
+  for (uint8_t band = 0; band < NUM_BANDS && start < maxBin; band++)
+  {
+    uint16_t end = lroundf(lo * powf(ratio, (float)(band + 1) / NUM_BANDS));
+    if (end <= start)
+      end = start + 1;
+    if (end > maxBin)
+      end = maxBin;
+    for (uint16_t i = start; i < end; i++)
+      binBand[i] = band;
+    start = end;
+  }
+  lutFirst = lo;
+  lutEnd = start;
+}
+
+// 布局设置变化后重建查找表
+static inline void spectrumEnsureBands()
+{
+  if (lutLayout != SPECTRUM_BAND_LAYOUT || lutMinHz != SPECTRUM_MIN_HZ ||
+      lutMaxHz != SPECTRUM_MAX_HZ)
+    spectrumBuildBands();
+}
+
+// 把 FFT 幅值累加到各频段: 查表单次遍历，整数比较与累加；
+// 顺便求有效频点的平均幅值，供噪声底跟踪使用
+uint32_t spectrumMapBands(const double *magnitudes, int *bands)
+{
+  spectrumEnsureBands();
+
+  uint32_t sum = 0;
+  for (uint16_t i = lutFirst; i < lutEnd; i++)
+  {
+    int m = (int)magnitudes[i];
+    sum += m;
+    if (m > noiseThreshold)
+      bands[binBand[i]] += m;
+  }
+  return lutEnd > lutFirst ? sum / (lutEnd - lutFirst) : 0;
+}
+
+/**
+ * @brief 每帧更新噪声底与增益 (频段累加之后、绘制之前)
+ *
+ * 噪声底: 跟踪平均幅值的下包络 (低于估计时快降 1/8，高于时慢升 1/128)，
+ * 阈值取噪声底的 1.5 倍，下一帧生效。
+ * 增益: 最响频段的峰值立即上升、每帧衰减 1/256 (约十几秒减半)，
+ * 每格幅值 = 峰值 / 8，最响的频段正好占满 8 格。
+ */
+static void spectrumAgcUpdate(uint32_t meanMagnitude, const int *bands)
+{
+  int32_t target = (int32_t)meanMagnitude * 16;
+  if (target < noiseFloorQ4)
+    noiseFloorQ4 -= (noiseFloorQ4 - target) >> 3;
+  else
+    noiseFloorQ4 += (target - noiseFloorQ4) >> 7;
+  int threshold = (noiseFloorQ4 * 3 / 2) >> 4;
+  noiseThreshold = threshold > AGC_MIN_NOISE ? threshold : AGC_MIN_NOISE;
+
+  int frameMax = 0;
+  for (int band = 0; band < NUM_BANDS; band++)
+  {
+    if (bands[band] > frameMax)
+      frameMax = bands[band];
+  }
+  if (frameMax > levelPeak)
+    levelPeak = frameMax;
+  else
+    levelPeak -= levelPeak >> 8;
+  amplitude = constrain(levelPeak / 8, AGC_MIN_AMPLITUDE, AGC_MAX_AMPLITUDE);
+}
+
+void spectrumBandsToJson(JsonObject out)
+{
+  spectrumEnsureBands();
+
+  const float binHz = (float)SAMPLING_FREQ / FFT_SAMPLES;
+  out["layout"] = SPECTRUM_BAND_LAYOUT == SPECTRUM_LAYOUT_CLASSIC &&
+                          CLASSIC_BANDS == NUM_BANDS
+                      ? "classic"
+                      : "log";
+  out["minHz"] = SPECTRUM_MIN_HZ;
+  out["maxHz"] = SPECTRUM_MAX_HZ;
+  out["binHz"] = binHz;
+  out["noiseThreshold"] = noiseThreshold;
+  out["amplitude"] = amplitude;
+
+  // 每条频谱的起始频率 (Hz)
+  JsonArray edges = out.createNestedArray("bandStartHz");
+  int last = -1;
+  for (uint16_t i = lutFirst; i < lutEnd; i++)
+  {
+    if (binBand[i] != 0xFF && binBand[i] != last)
+    {
+      last = binBand[i];
+      edges.add((int)(i * binHz));
+    }
+  }
+}
+
 // 切换频谱模式
 void spectrumNextMode()
 {
@@ -63,6 +225,34 @@ String spectrumGetModeName()
   return names[spectrumMode];
 }
 
+int spectrumGetMode() { return spectrumMode; }
+
+bool spectrumSetMode(int mode)
+{
+  if (mode < 0 || mode >= SPECTRUM_MODES)
+    return false;
+  spectrumMode = mode;
+  return true;
+}
+
+void spectrumInjectInput(double (*source)(int index))
+{
+  spectrumSource = source;
+}
+
+void spectrumReset()
+{
+  memset(peak, 0, sizeof(peak));
+  memset(peakSpeed, 0, sizeof(peakSpeed));
+  memset(oldBarHeights, 0, sizeof(oldBarHeights));
+  colorTime = 0;
+  peekDecayTime = millis();
+  amplitude = AMPLITUDE;
+  noiseThreshold = NOISE;
+  noiseFloorQ4 = NOISE * 16 * 2 / 3;
+  levelPeak = AMPLITUDE * 8;
+}
+
 // ==================================================================
 // 辅助函数
 // ==================================================================
@@ -81,15 +271,13 @@ static inline void applyAppColor(const String &colorHex)
 
 static void drawWeekdayBar(FastLED_NeoMatrix *matrix, int16_t x, int16_t y,
                            int16_t barStartX, int8_t barWidth,
-                           const struct tm *timeInfo,
                            const String &activeColorHex,
                            const String &inactiveColorHex)
 {
   if (!SHOW_WEEKDAY)
     return;
 
-  int dayOffset = START_ON_MONDAY ? 0 : 1;
-  int today = (timeInfo->tm_wday + 6 + dayOffset) % 7;
+  int today = ClockService.weekdayIndex();
 
   uint16_t activeColor = HEXtoColor(activeColorHex.c_str());
   uint16_t inactiveColor = HEXtoColor(inactiveColorHex.c_str());
@@ -112,26 +300,8 @@ void TimeApp(FastLED_NeoMatrix *matrix, MatrixDisplayUiState *state, int16_t x,
   CURRENT_APP = "Time";
   applyAppColor(TIME_COLOR);
 
-  time_t now = time(nullptr);
-  struct tm *timeInfo = localtime(&now);
-
-  char fmt[32];
-  strncpy(fmt, TIME_FORMAT.c_str(), sizeof(fmt));
-  fmt[sizeof(fmt) - 1] = '\0';
-
-  if (now % 2)
-  {
-    char *sep = strchr(fmt, ':');
-    if (!sep)
-      sep = strchr(fmt, ' ');
-    if (sep && strlen(TIME_FORMAT.c_str()) < 8)
-    {
-      *sep = ' ';
-    }
-  }
-
-  char text[32];
-  strftime(text, sizeof(text), fmt, timeInfo);
+  // 时间字符串由时钟服务每秒格式化一次，分隔符按秒内相位闪烁
+  const char *text = ClockService.timeText(ClockService.separatorVisible());
 
   int textPixelWidth = strlen(text) * 4 - 1;
   bool showIcon = (textPixelWidth <= 22);
@@ -157,8 +327,8 @@ void TimeApp(FastLED_NeoMatrix *matrix, MatrixDisplayUiState *state, int16_t x,
     DisplayManager.printText(textX + x, 6 + y, text, true, false);
   }
 
-  drawWeekdayBar(matrix, x, y, barStartX, barWidth, timeInfo,
-                 TIME_WEEKDAY_ACTIVE_COLOR, TIME_WEEKDAY_INACTIVE_COLOR);
+  drawWeekdayBar(matrix, x, y, barStartX, barWidth, TIME_WEEKDAY_ACTIVE_COLOR,
+                 TIME_WEEKDAY_INACTIVE_COLOR);
 }
 
 // ==================================================================
@@ -171,11 +341,7 @@ void DateApp(FastLED_NeoMatrix *matrix, MatrixDisplayUiState *state, int16_t x,
   CURRENT_APP = "Date";
   applyAppColor(DATE_COLOR);
 
-  time_t now = time(nullptr);
-  struct tm *timeInfo = localtime(&now);
-
-  char text[32];
-  strftime(text, sizeof(text), DATE_FORMAT.c_str(), timeInfo);
+  const char *text = ClockService.dateText();
 
   int textPixelWidth = strlen(text) * 4 - 1;
   bool showIcon = (textPixelWidth <= 24);
@@ -203,8 +369,8 @@ void DateApp(FastLED_NeoMatrix *matrix, MatrixDisplayUiState *state, int16_t x,
     DisplayManager.printText(textX + x, 6 + y, text, true, false);
   }
 
-  drawWeekdayBar(matrix, x, y, barStartX, barWidth, timeInfo,
-                 DATE_WEEKDAY_ACTIVE_COLOR, DATE_WEEKDAY_INACTIVE_COLOR);
+  drawWeekdayBar(matrix, x, y, barStartX, barWidth, DATE_WEEKDAY_ACTIVE_COLOR,
+                 DATE_WEEKDAY_INACTIVE_COLOR);
 }
 
 // ==================================================================
@@ -317,37 +483,96 @@ void WindApp(FastLED_NeoMatrix *matrix, MatrixDisplayUiState *state, int16_t x,
 // 频谱覆盖层 - 绘制模式 (参考代码风格)
 // ==================================================================
 
+// 调色板: 当前模式用到的全部颜色，模式切换或颜色相位变化时重建，
+// 绘制时只查表。下标含义随模式不同:
+//   彩虹条/镜像峰: 频段；紫色条/变色条: 从底部数的行 (0~8，8 为屏幕外)
+//   中心条: 条高 × 8 + 条内偏移；瀑布流: 强度 0~160，其后 7 项为历史行
+// 表项已是 LED 值 (hsvToCRGB 经 colorCorrect 校正)，绘制时原样写入缓冲区
+#define PALETTE_SIZE 168
+#define PALETTE_WATERFALL_HISTORY 161
+static_assert(NUM_BANDS <= PALETTE_SIZE, "palette too small for NUM_BANDS");
+static CRGB palette[PALETTE_SIZE];
+static int paletteMode = -1;
+static int paletteTime = -1;
+
+/// 调色板颜色 (LED 值)
+static inline CRGB paletteColor(uint16_t hue, uint8_t sat, uint8_t val)
+{
+  return colorCorrect(hsvToCRGB(hue, sat, val));
+}
+
+static void spectrumBuildPalette()
+{
+  paletteMode = spectrumMode;
+  paletteTime = colorTime;
+  switch (spectrumMode)
+  {
+  case 0:
+    for (int band = 0; band < NUM_BANDS; band++)
+      palette[band] = paletteColor(band * 8, 255, 255);
+    break;
+  case 1:
+    for (int band = 0; band < NUM_BANDS; band++)
+      palette[band] = paletteColor(band * 8 + colorTime * 2, 255, 255);
+    break;
+  case 2:
+    for (int row = 0; row <= 8; row++)
+      palette[row] = paletteColor(180 + row * 10, 255, 200);
+    break;
+  case 3:
+    for (int h = 1; h <= 7; h += 2)
+    {
+      for (int offset = 0; offset <= h; offset++)
+      {
+        int colorIdx = constrain(offset * 255 / (h + 1), 0, 255);
+        palette[h * 8 + offset] = paletteColor(colorIdx / 2, 255, 200);
+      }
+    }
+    break;
+  case 4:
+    for (int row = 0; row <= 8; row++)
+      palette[row] = paletteColor(row * 32 + colorTime * 3, 255, 255);
+    break;
+  case 5:
+    for (int i = 0; i <= 160; i++)
+      palette[i] = paletteColor(160 - i, 255, 255);
+    for (int row = 0; row < 7; row++)
+      palette[PALETTE_WATERFALL_HISTORY + row] =
+          paletteColor(160 - row * 10, 255, 200);
+    break;
+  }
+}
+
 // 模式0: 彩虹条 (rainbowBars)
-static void rainbowBars(FastLED_NeoMatrix *matrix, int band, int barHeight)
+static void rainbowBars(PixelTarget &target, int band, int barHeight)
 {
   for (int y = 7; y >= 7 - barHeight; y--)
   {
-    matrix->drawPixel(band, y, hsvToRgb(band * 8, 255, 255));
+    target.drawLed(band, y, palette[band]);
   }
 }
 
 // 模式1: 镜像峰 (outrunPeak) - 只显示峰值
-static void outrunPeak(FastLED_NeoMatrix *matrix, int band)
+static void outrunPeak(PixelTarget &target, int band)
 {
   int peakHeight = 7 - peak[band];
-  matrix->drawPixel(band, peakHeight, hsvToRgb(band * 8 + colorTime * 2, 255, 255));
+  target.drawLed(band, peakHeight, palette[band]);
 }
 
 // 模式2: 紫色条 (purpleBars)
-static void purpleBars(FastLED_NeoMatrix *matrix, int band, int barHeight)
+static void purpleBars(PixelTarget &target, int band, int barHeight)
 {
   for (int y = 7; y >= 7 - barHeight; y--)
   {
     // 紫色调: 根据y位置渐变
-    uint16_t color = hsvToRgb(180 + (7 - y) * 10, 255, 200);
-    matrix->drawPixel(band, y, color);
+    target.drawLed(band, y, palette[7 - y]);
   }
   // 峰值
-  matrix->drawPixel(band, 7 - peak[band], matrix->Color(255, 255, 255));
+  target.drawPixel(band, 7 - peak[band], CRGB(255, 255, 255));
 }
 
 // 模式3: 中心条 (centerBars) - 从中间向两边
-static void centerBars(FastLED_NeoMatrix *matrix, int band, int barHeight)
+static void centerBars(PixelTarget &target, int band, int barHeight)
 {
   if (barHeight % 2 == 0)
     barHeight--;
@@ -356,28 +581,26 @@ static void centerBars(FastLED_NeoMatrix *matrix, int band, int barHeight)
   for (int y = yStart; y <= yStart + barHeight; y++)
   {
     // 热力图色调: 黄->红
-    int colorIdx = constrain((y - yStart) * 255 / (barHeight + 1), 0, 255);
-    uint16_t color = hsvToRgb(colorIdx / 2, 255, 200);
-    matrix->drawPixel(band, y, color);
+    target.drawLed(band, y, palette[barHeight * 8 + (y - yStart)]);
   }
 }
 
 // 模式4: 变色条 (changingBars)
-static void changingBars(FastLED_NeoMatrix *matrix, int band, int barHeight)
+static void changingBars(PixelTarget &target, int band, int barHeight)
 {
   for (int y = 7; y >= 7 - barHeight; y--)
   {
     // 颜色随y和时间变化
-    matrix->drawPixel(band, y, hsvToRgb((7 - y) * 32 + colorTime * 3, 255, 255));
+    target.drawLed(band, y, palette[7 - y]);
   }
 }
 
 // 模式5: 瀑布流 (waterfall) - 使用旧的oldBarHeights绘制
-static void waterfall(FastLED_NeoMatrix *matrix, int band)
+static void waterfall(PixelTarget &target, int band)
 {
   // 底部显示当前值
   int intensity = constrain(bandValues[band] / 2000, 0, 160);
-  matrix->drawPixel(band, 7, hsvToRgb(160 - intensity, 255, 255));
+  target.drawLed(band, 7, palette[intensity]);
 
   // 上方显示历史值 (使用oldBarHeights作为历史)
   int historyHeight = oldBarHeights[band] / 100;
@@ -385,15 +608,15 @@ static void waterfall(FastLED_NeoMatrix *matrix, int band)
   {
     for (int y = 6; y >= 7 - historyHeight && y >= 0; y--)
     {
-      matrix->drawPixel(band, y, hsvToRgb(160 - (6 - y) * 10, 255, 200));
+      target.drawLed(band, y, palette[PALETTE_WATERFALL_HISTORY + 6 - y]);
     }
   }
 }
 
 // 峰值绘制 (白色峰值)
-static void whitePeak(FastLED_NeoMatrix *matrix, int band)
+static void whitePeak(PixelTarget &target, int band)
 {
-  matrix->drawPixel(band, 7 - peak[band], matrix->Color(255, 255, 255));
+  target.drawPixel(band, 7 - peak[band], CRGB(255, 255, 255));
 }
 
 // ==================================================================
@@ -405,6 +628,7 @@ void SpectrumOverlay(FastLED_NeoMatrix *matrix, MatrixDisplayUiState *state,
 {
   if (!SPECTRUM_ACTIVE)
     return;
+  state->requestFrame(0, FRAME_SPECTRUM);
 
   // 瀑布流模式不需要清屏
   if (spectrumMode != 5)
@@ -413,9 +637,15 @@ void SpectrumOverlay(FastLED_NeoMatrix *matrix, MatrixDisplayUiState *state,
   // 重置频段值
   memset(bandValues, 0, sizeof(bandValues));
 
-  // 采样
+  // 采样 (约 51ms 忙等) + FFT；注入输入时直接取样本，不等待
+  LoopWatchdog.stageBegin(LOOP_STAGE_SPECTRUM);
   unsigned long startTime;
-  for (int i = 0; i < FFT_SAMPLES; i++)
+  for (int i = 0; i < FFT_SAMPLES && spectrumSource; i++)
+  {
+    vReal[i] = spectrumSource(i);
+    vImag[i] = 0.0;
+  }
+  for (int i = 0; i < FFT_SAMPLES && !spectrumSource; i++)
   {
     startTime = micros();
     vReal[i] = (double)analogRead(MIC_PIN);
@@ -430,28 +660,23 @@ void SpectrumOverlay(FastLED_NeoMatrix *matrix, MatrixDisplayUiState *state,
   FFT.windowing(FFT_WIN_TYP_HAMMING, FFT_FORWARD, false);
   FFT.compute(FFT_FORWARD);
   FFT.complexToMagnitude();
+  LoopWatchdog.stageEnd(LOOP_STAGE_SPECTRUM);
 
-  // 解析频段 (参考代码的逻辑)
-  for (int i = 2; i < FFT_SAMPLES / 2; i++)
-  {
-    if (vReal[i] > NOISE)
-    {
-      for (int band = 0; band < NUM_BANDS; band++)
-      {
-        if (i >= bandRanges[band][0] && i < bandRanges[band][1])
-        {
-          bandValues[band] += (int)vReal[i];
-          break;
-        }
-      }
-    }
-  }
+  // 解析频段，更新噪声底与增益
+  uint32_t mean = spectrumMapBands(vReal, bandValues);
+  spectrumAgcUpdate(mean, bandValues);
+
+  // 镜像峰/变色条的颜色随 colorTime 变化，其余模式只在切换时重建
+  bool phased = spectrumMode == 1 || spectrumMode == 4;
+  if (spectrumMode != paletteMode || (phased && colorTime != paletteTime))
+    spectrumBuildPalette();
 
-  // 处理并绘制频谱条
+  // 处理并绘制频谱条 (调色板已是 LED 值，直接写缓冲区)
+  PixelTarget target(matrix);
   for (int band = 0; band < NUM_BANDS; band++)
   {
     // 缩放条形高度
-    int barHeight = bandValues[band] / AMPLITUDE;
+    int barHeight = bandValues[band] / amplitude;
     if (barHeight > 8)
       barHeight = 8;
 
@@ -479,25 +704,25 @@ void SpectrumOverlay(FastLED_NeoMatrix *matrix, MatrixDisplayUiState *state,
     switch (spectrumMode)
     {
     case 0:
-      rainbowBars(matrix, band, barHeight);
-      whitePeak(matrix, band);
+      rainbowBars(target, band, barHeight);
+      whitePeak(target, band);
       break;
     case 1:
       // 无条形，只绘制峰值
-      outrunPeak(matrix, band);
+      outrunPeak(target, band);
       break;
     case 2:
-      purpleBars(matrix, band, barHeight);
+      purpleBars(target, band, barHeight);
       break;
     case 3:
-      centerBars(matrix, band, barHeight);
+      centerBars(target, band, barHeight);
       break;
     case 4:
-      changingBars(matrix, band, barHeight);
-      whitePeak(matrix, band);
+      changingBars(target, band, barHeight);
+      whitePeak(target, band);
       break;
     case 5:
-      waterfall(matrix, band);
+      waterfall(target, band);
       break;
     }
 
@@ -505,29 +730,32 @@ void SpectrumOverlay(FastLED_NeoMatrix *matrix, MatrixDisplayUiState *state,
     oldBarHeights[band] = barHeight;
   }
 
-  // 颜色时间更新 (每60ms)
+  // 颜色时间更新 (每70ms)；360 是两种相位速度 (×2、×3) 的公共周期
   if ((millis() - peekDecayTime) >= 70)
   {
-    colorTime++;
+    colorTime = (colorTime + 1) % 360;
     peekDecayTime = millis();
   }
 }
 
 // ==================================================================
-// 其他覆盖层 (预留)
+// 闹钟 / 计时 / 通知覆盖层
 // ==================================================================
 
 void AlarmOverlay(FastLED_NeoMatrix *matrix, MatrixDisplayUiState *state,
                   FastFramePlayer *player)
 {
+  TimerManager.renderAlarm(matrix, state, player);
 }
 
 void TimerOverlay(FastLED_NeoMatrix *matrix, MatrixDisplayUiState *state,
                   FastFramePlayer *player)
 {
+  TimerManager.renderTimer(matrix, state, player);
 }
 
 void NotifyOverlay(FastLED_NeoMatrix *matrix, MatrixDisplayUiState *state,
                    FastFramePlayer *player)
 {
+  NotifyManager.render(matrix, state, player);
 }
@@ -13,7 +13,9 @@
 #define APPS_H
 
 #include "FastFramePlayer.h"
+#include "Globals.h"
 #include "MatrixDisplayUi.h"
+#include <ArduinoJson.h>
 #include <FastLED_NeoMatrix.h>
 #include <vector>
 
@@ -46,6 +48,29 @@ void NotifyOverlay(FastLED_NeoMatrix *matrix, MatrixDisplayUiState *state,
 void SpectrumOverlay(FastLED_NeoMatrix *matrix, MatrixDisplayUiState *state,
                      FastFramePlayer *player);
 
+/// 频谱频段布局 (SPECTRUM_BAND_LAYOUT)
+enum SpectrumLayout : uint8_t
+{
+  SPECTRUM_LAYOUT_CLASSIC = 0, ///< 经典 32 条频段表 (约 117~1777 Hz)
+  SPECTRUM_LAYOUT_LOG = 1      ///< SPECTRUM_MIN_HZ~SPECTRUM_MAX_HZ 等比分段
+};
+
+/// 频谱条数 (每列一条)
+#define SPECTRUM_BANDS MATRIX_WIDTH
+
+/**
+ * @brief 把 FFT 幅值累加到频谱条 (低于当前噪声阈值的忽略)
+ *
+ * 频点→频段查找表在布局设置变化时重建，每帧只遍历一次有效频点。
+ * @param magnitudes FFT 幅值 (FFT_SAMPLES / 2 个)
+ * @param bands 输出: SPECTRUM_BANDS 个频段的累加值 (调用方清零)
+ * @return 有效频点的平均幅值 (噪声底跟踪用)
+ */
+uint32_t spectrumMapBands(const double *magnitudes, int *bands);
+
+/// 当前频段布局 (布局名称、频率范围、各频段起始频率) 与 AGC 状态
+void spectrumBandsToJson(JsonObject out);
+
 /**
  * @brief 切换频谱显示模式
  */
@@ -57,6 +82,24 @@ void spectrumNextMode();
  */
 String spectrumGetModeName();
 
+/// 当前频谱模式
+int spectrumGetMode();
+
+/**
+ * @brief 设置频谱模式
+ * @return false=模式超出范围 (渲染检查据此枚举全部模式)
+ */
+bool spectrumSetMode(int mode);
+
+/**
+ * @brief 注入音频输入 (渲染检查用)
+ * @param source 返回第 index 个采样值 (0~4095)；nullptr=恢复麦克风采样
+ */
+void spectrumInjectInput(double (*source)(int index));
+
+/// 清空峰值/平滑历史、颜色时间与 AGC 状态，使下一帧只取决于输入
+void spectrumReset();
+
 /**
  * @brief 闹钟覆盖层
  * @param matrix 矩阵驱动指针
@@ -152,4 +195,7 @@ void WindApp(FastLED_NeoMatrix *matrix, MatrixDisplayUiState *state, int16_t x,
 /// 覆盖层回调数组 (声明为全局以避免局部变量生命周期问题)
 extern OverlayCallback overlays[];
 
+/// 覆盖层数量
+extern const uint8_t overlayCount;
+
 #endif
\ No newline at end of file
@@ -0,0 +1,328 @@
+/**
+ * @file Benchmark.cpp
+ * @brief 微基准测试实现 — 测试项、周期计数、NVS 基线
+ */
+
+#include "Benchmark.h"
+#include "Apps.h"
+#include "ColorDraw.h"
+#include "FastFramePlayer.h"
+#include "Globals.h"
+#include "Liveview.h"
+#include "Logger.h"
+#include "OffscreenCanvas.h"
+#include "ServerManager.h"
+#include "Tools.h"
+#include <Preferences.h>
+
+// ==================================================================
+// 测试项
+// ==================================================================
+
+static uint32_t benchTextWidth(uint32_t iterations)
+{
+  static const char *const texts[] = {"12:34", "2026-10-17",
+                                      "TEMPERATURE 23.5C HUMIDITY 45%",
+                                      "Hello, NeoClock!"};
+  uint32_t sum = 0;
+  for (uint32_t i = 0; i < iterations; i++)
+    sum += getTextWidth(texts[i & 3], false);
+  return sum;
+}
+
+static uint32_t benchHexToColor(uint32_t iterations)
+{
+  static const char *const colors[] = {"#FF8800", "00FF00", "#1a2B3c",
+                                       "#FFFFFF"};
+  uint32_t sum = 0;
+  for (uint32_t i = 0; i < iterations; i++)
+    sum += HEXtoColor(colors[i & 3]);
+  return sum;
+}
+
+static uint32_t benchHsvToRgb(uint32_t iterations)
+{
+  uint32_t sum = 0;
+  for (uint32_t i = 0; i < iterations; i++)
+    sum += hsvToRgb(i % 360, 255 - (i & 63), 255 - (i & 127));
+  return sum;
+}
+
+/// 查表前的逐项公式 (对照速度与误差)
+static uint16_t hsvReference(uint16_t hue, uint8_t sat, uint8_t val)
+{
+  uint8_t r, g, b;
+  if (sat == 0)
+  {
+    r = g = b = val;
+  }
+  else
+  {
+    hue = hue % 360;
+    uint8_t region = hue / 60;
+    uint8_t remainder = (hue - (region * 60)) * 256 / 60;
+    uint8_t p = (val * (255 - sat)) >> 8;
+    uint8_t q = (val * (255 - ((sat * remainder) >> 8))) >> 8;
+    uint8_t t = (val * (255 - ((sat * (255 - remainder)) >> 8))) >> 8;
+    switch (region)
+    {
+    case 0: r = val; g = t; b = p; break;
+    case 1: r = q; g = val; b = p; break;
+    case 2: r = p; g = val; b = t; break;
+    case 3: r = p; g = q; b = val; break;
+    case 4: r = t; g = p; b = val; break;
+    default: r = val; g = p; b = q; break;
+    }
+  }
+  return ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3);
+}
+
+static uint32_t benchHsvReference(uint32_t iterations)
+{
+  uint32_t sum = 0;
+  for (uint32_t i = 0; i < iterations; i++)
+    sum += hsvReference(i % 360, 255 - (i & 63), 255 - (i & 127));
+  return sum;
+}
+
+/// 查表结果与逐项公式的最大分量误差 (RGB565 单位)
+static uint8_t hsvMaxError()
+{
+  uint8_t maxErr = 0;
+  for (uint16_t hue = 0; hue < 360; hue++)
+  {
+    for (uint16_t sat = 0; sat < 256; sat += 15)
+    {
+      for (uint16_t val = 0; val < 256; val += 15)
+      {
+        uint16_t a = hsvToRgb(hue, sat, val);
+        uint16_t b = hsvReference(hue, sat, val);
+        int dr = abs((a >> 11) - (b >> 11));
+        int dg = abs(((a >> 5) & 0x3F) - ((b >> 5) & 0x3F));
+        int db = abs((a & 0x1F) - (b & 0x1F));
+        int d = dr > dg ? (dr > db ? dr : db) : (dg > db ? dg : db);
+        if (d > maxErr)
+          maxErr = d;
+      }
+    }
+  }
+  return maxErr;
+}
+
+/// 一帧 Liveview 数据 (32×8×3 + 前缀)
+uint32_t Benchmark_::benchCrc32(uint32_t iterations)
+{
+  static byte frame[3 + 32 * 8 * 3];
+  for (size_t i = 0; i < sizeof(frame); i++)
+    frame[i] = i * 31;
+  uint32_t sum = 0;
+  for (uint32_t i = 0; i < iterations; i++)
+  {
+    frame[0] = i;
+    sum += Liveview._crc32(frame, sizeof(frame));
+  }
+  return sum;
+}
+
+/// 从 PROGMEM 解码一帧系统图标 (8×8)
+uint32_t Benchmark_::benchFrameDecode(uint32_t iterations)
+{
+  static FastFramePlayer player;
+  player.loadSystem(0);
+  uint32_t sum = 0;
+  for (uint32_t i = 0; i < iterations; i++)
+  {
+    player._curFrame = i % (player._frameCount ? player._frameCount : 1);
+    player.loadCurrentFrame();
+    sum += player._frameBuffer[i & 63];
+  }
+  return sum;
+}
+
+/// 图标绘制用的离屏画布与一帧 8×8 RGB565 图像
+static OffscreenCanvas &benchCanvas()
+{
+  static OffscreenCanvas canvas;
+  return canvas;
+}
+
+static const uint16_t *benchIcon()
+{
+  static uint16_t icon[64];
+  for (int i = 0; i < 64; i++)
+    icon[i] = i * 1031;
+  return icon;
+}
+
+/// 8×8 图标经 GFX 逐像素绘制 (虚函数 + 库内 565 展开)
+static uint32_t benchIconGfx(uint32_t iterations)
+{
+  FastLED_NeoMatrix *gfx = benchCanvas().gfx();
+  const uint16_t *icon = benchIcon();
+  for (uint32_t i = 0; i < iterations; i++)
+    for (uint16_t p = 0; p < 64; p++)
+      gfx->drawPixel(i % 24 + p % 8, p / 8, icon[p]);
+  return benchCanvas().pixels()[0].r;
+}
+
+/// 8×8 图标经 PixelTarget 查表绘制 (FastFramePlayer::play 的路径)
+static uint32_t benchIconLut(uint32_t iterations)
+{
+  PixelTarget target(benchCanvas().gfx());
+  const uint16_t *icon = benchIcon();
+  for (uint32_t i = 0; i < iterations; i++)
+    target.drawImage565(i % 24, 0, icon, 8, 8);
+  return benchCanvas().pixels()[0].r;
+}
+
+/// 查找表与库的 565 展开不一致的颜色数 (应为 0)
+static uint32_t expandMismatch()
+{
+  FastLED_NeoMatrix *gfx = benchCanvas().gfx();
+  uint32_t mismatched = 0;
+  uint16_t color = 0;
+  do
+  {
+    gfx->drawPixel(0, 0, color);
+    mismatched += benchCanvas().getPixel(0, 0) != expand565(color);
+  } while (++color != 0);
+  return mismatched;
+}
+
+static uint32_t benchSpectrumBands(uint32_t iterations)
+{
+  static double magnitudes[256];
+  for (int i = 0; i < 256; i++)
+    magnitudes[i] = (i * 37 % 1000) + 100.0; // 一半以上超过噪声阈值
+  int bands[SPECTRUM_BANDS];
+  uint32_t sum = 0;
+  for (uint32_t i = 0; i < iterations; i++)
+  {
+    memset(bands, 0, sizeof(bands));
+    spectrumMapBands(magnitudes, bands);
+    sum += bands[i % SPECTRUM_BANDS];
+  }
+  return sum;
+}
+
+/// 完整命令往返: JSON 解析 → 分发 → 生成回复
+static uint32_t benchDispatch(uint32_t iterations)
+{
+  static const char cmd[] = "{\"type\":\"getStats\"}";
+  String response;
+  uint32_t sum = 0;
+  for (uint32_t i = 0; i < iterations; i++)
+  {
+    ServerManager.handleExternalCommand(nullptr, cmd, sizeof(cmd) - 1,
+                                        response);
+    sum += response.length();
+  }
+  return sum;
+}
+
+static const BenchCase CASES[] = {
+    {"textWidth", 1000, benchTextWidth},
+    {"hexToColor", 2000, benchHexToColor},
+    {"hsvToRgb", 2000, benchHsvToRgb},
+    {"hsvReference", 2000, benchHsvReference},
+    {"crc32", 50, Benchmark_::benchCrc32},
+    {"frameDecode", 200, Benchmark_::benchFrameDecode},
+    {"iconGfx", 100, benchIconGfx},
+    {"iconLut", 100, benchIconLut},
+    {"spectrumBands", 100, benchSpectrumBands},
+    {"dispatch", 20, benchDispatch}};
+
+// ==================================================================
+// 单例
+// ==================================================================
+
+Benchmark_ &Benchmark_::getInstance()
+{
+  static Benchmark_ instance;
+  return instance;
+}
+
+Benchmark_ &Benchmark = Benchmark_::getInstance();
+
+// ==================================================================
+// 运行
+// ==================================================================
+
+/// 运行一项，返回每次调用的纳秒数 (最快一次)
+static float measure(const BenchCase &c, uint32_t &checksum)
+{
+  checksum = c.run(c.iterations); // 预热 (缓存、惰性初始化)
+  uint32_t best = UINT32_MAX;
+  for (int r = 0; r < BENCH_RUNS; r++)
+  {
+    uint32_t start = ESP.getCycleCount();
+    checksum += c.run(c.iterations);
+    uint32_t cycles = ESP.getCycleCount() - start;
+    if (cycles < best)
+      best = cycles;
+  }
+  return (float)best * 1000.0f / ESP.getCpuFreqMHz() / c.iterations;
+}
+
+int Benchmark_::run(JsonObject out, const char *only, bool saveBaseline)
+{
+  Preferences prefs;
+  prefs.begin("bench", !saveBaseline);
+  String baselineFw = prefs.getString("fw", "");
+
+  out["firmware"] = FIRMWARE_VERSION;
+  out["cpuMHz"] = ESP.getCpuFreqMHz();
+  out["thresholdPct"] = BENCH_REGRESSION_PCT;
+  if (baselineFw.length() > 0)
+    out["baselineFirmware"] = baselineFw;
+  JsonArray results = out.createNestedArray("results");
+
+  int regressions = 0;
+  for (const BenchCase &c : CASES)
+  {
+    if (only && *only && !strstr(c.name, only))
+      continue;
+
+    uint32_t checksum;
+    float ns = measure(c, checksum);
+    float baseline = prefs.getFloat(c.name, 0.0f);
+
+    JsonObject r = results.createNestedObject();
+    r["name"] = c.name;
+    r["ns"] = ns;
+    r["checksum"] = checksum;
+    if (baseline > 0.0f)
+    {
+      float delta = (ns - baseline) * 100.0f / baseline;
+      r["baseline"] = baseline;
+      r["deltaPct"] = delta;
+      if (delta > BENCH_REGRESSION_PCT)
+      {
+        r["regressed"] = true;
+        regressions++;
+      }
+    }
+    LOG_INFO("[Bench] %-14s %9.1f ns (基线 %.1f)", c.name, ns, baseline);
+
+    if (saveBaseline)
+      prefs.putFloat(c.name, ns);
+  }
+
+  if (saveBaseline)
+    prefs.putString("fw", FIRMWARE_VERSION);
+  prefs.end();
+
+  // 色轮查表的精度 (与 hsvReference 的速度对照一起看)
+  if (!only || !*only || strstr("hsvToRgb", only))
+    out["hsvMaxError"] = hsvMaxError();
+
+  // 565 查找表与库展开是否逐值一致 (与 iconGfx/iconLut 的速度对照一起看)
+  if (!only || !*only || strstr("iconLut", only))
+    out["expandMismatch"] = expandMismatch();
+
+  out["regressions"] = regressions;
+  if (regressions > 0)
+    LOG_WARN("[Bench] %d 项比基线慢 %d%% 以上", regressions,
+             BENCH_REGRESSION_PCT);
+  return regressions;
+}
@@ -0,0 +1,74 @@
+/**
+ * @file Benchmark.h
+ * @brief 微基准测试 — 测量工具函数与编解码热点，与保存的基线对比
+ *
+ * 本文件定义：
+ *   - BenchCase 结构体: 一个测试项 (名称、迭代次数、被测函数)
+ *   - Benchmark_ 单例类: 运行测试项、读写基线、判断性能回退
+ *
+ * 测试项: getTextWidth、HEXtoColor、hsvToRgb (及查表前公式 hsvReference)、Liveview CRC32、
+ * FastFramePlayer 帧解码、图标绘制 (GFX 逐像素 iconGfx 与查表直写 iconLut)、
+ * 频谱频段映射、命令分发 (getStats 完整 JSON 往返)。
+ *
+ * 每项先预热一次，再运行 BENCH_RUNS 次取最快一次 (CPU 周期计数)，
+ * 换算为每次调用的纳秒数。基线保存在 NVS (命名空间 "bench")，
+ * 与基线相比变慢超过 BENCH_REGRESSION_PCT 即标记为回退。
+ * 运行 hsvToRgb 时同时报告色轮查表与逐项公式的最大误差 (hsvMaxError)，
+ * 运行 iconLut 时报告 565 查找表与库展开不一致的颜色数 (expandMismatch)。
+ *
+ * 用法 (WebSocket / HTTP API)：
+ *   {type:"runBenchmark"}               运行并与基线对比
+ *   {type:"runBenchmark", save:true}    运行并把结果保存为新基线
+ *   {type:"runBenchmark", only:"crc32"} 只运行名称包含该字符串的测试项
+ */
+
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+
+/// 每项重复次数 (取最快)
+#define BENCH_RUNS 5
+
+/// 回退阈值 (比基线慢超过此百分比)
+#define BENCH_REGRESSION_PCT 10
+
+/// 一个测试项
+struct BenchCase
+{
+  const char *name;    ///< 名称 (同时作为 NVS 键，≤15 字符)
+  uint32_t iterations; ///< 单次运行的调用次数
+  /// 被测函数: 调用 iterations 次，返回校验值 (防止被优化掉)
+  uint32_t (*run)(uint32_t iterations);
+};
+
+/**
+ * @class Benchmark_
+ * @brief 微基准测试
+ */
+class Benchmark_
+{
+public:
+  static Benchmark_ &getInstance();
+
+  /**
+   * @brief 运行测试项 (阻塞，总耗时约数百毫秒)
+   * @param out 结果 JSON
+   * @param only 只运行名称包含该字符串的测试项 (nullptr/空=全部)
+   * @param saveBaseline 把本次结果保存为基线
+   * @return 回退的测试项数
+   */
+  int run(JsonObject out, const char *only, bool saveBaseline);
+
+  /// 需要访问私有成员的测试项 (本类是 Liveview_ / FastFramePlayer 的友元)
+  static uint32_t benchCrc32(uint32_t iterations);
+  static uint32_t benchFrameDecode(uint32_t iterations);
+
+private:
+  Benchmark_() = default;
+};
+
+extern Benchmark_ &Benchmark;
+
+#endif
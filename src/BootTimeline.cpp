@@ -0,0 +1,134 @@
+/**
+ * @file BootTimeline.cpp
+ * @brief 启动时间线实现 — 阶段计时、NVS 持久化、JSON 输出
+ */
+
+#include "BootTimeline.h"
+#include "Globals.h"
+#include "Logger.h"
+#include <Preferences.h>
+
+/// 结构版本 ("BTL" + 版本号)，BootRecord 布局变化时递增
+#define BOOT_RECORD_MAGIC 0x42544C01
+
+/// 阶段名称 (与 BootPhase 顺序一致)
+static const char *const PHASE_NAMES[BOOT_PHASE_COUNT] = {
+    "display", "fs", "settings", "apps", "periphery",
+    "dht", "network", "websocket", "wifi"};
+
+// ==================================================================
+// 单例
+// ==================================================================
+
+BootTimeline_ &BootTimeline_::getInstance()
+{
+  static BootTimeline_ instance;
+  return instance;
+}
+
+BootTimeline_ &BootTimeline = BootTimeline_::getInstance();
+
+// ==================================================================
+// 记录
+// ==================================================================
+
+void BootTimeline_::begin()
+{
+  Preferences prefs;
+  prefs.begin("boot", true);
+  _hasPrevious = prefs.getBytesLength("last") == sizeof(BootRecord) &&
+                 prefs.getBytes("last", &_previous, sizeof(BootRecord)) == sizeof(BootRecord) &&
+                 _previous.magic == BOOT_RECORD_MAGIC;
+  prefs.end();
+
+  memset(&_current, 0, sizeof(_current));
+  _current.magic = BOOT_RECORD_MAGIC;
+  strncpy(_current.firmware, FIRMWARE_VERSION, sizeof(_current.firmware) - 1);
+  _finished = false;
+}
+
+void BootTimeline_::phaseBegin(BootPhase phase)
+{
+  _current.startUs[phase] = micros();
+}
+
+void BootTimeline_::phaseEnd(BootPhase phase)
+{
+  _current.durationUs[phase] = micros() - _current.startUs[phase];
+
+  // WiFi 通常在启动状态机完成之后才连上，补写一次
+  if (_finished && phase == BOOT_PHASE_WIFI)
+  {
+    _save();
+  }
+}
+
+void BootTimeline_::markFirstFrame()
+{
+  if (_current.firstFrameUs == 0)
+    _current.firstFrameUs = micros();
+}
+
+void BootTimeline_::markFirstApp()
+{
+  if (_current.firstAppUs == 0)
+    _current.firstAppUs = micros();
+}
+
+void BootTimeline_::finish()
+{
+  _current.doneUs = micros();
+  _finished = true;
+  _save();
+
+  LOG_INFO("[Boot] 首帧 %lu us, 首个应用 %lu us, 完成 %lu us",
+           (unsigned long)_current.firstFrameUs,
+           (unsigned long)_current.firstAppUs,
+           (unsigned long)_current.doneUs);
+  for (int i = 0; i < BOOT_PHASE_COUNT; i++)
+  {
+    if (_current.durationUs[i] > 0)
+    {
+      LOG_DEBUG("[Boot]   %-10s +%lu us (%lu us)", PHASE_NAMES[i],
+                (unsigned long)_current.startUs[i],
+                (unsigned long)_current.durationUs[i]);
+    }
+  }
+}
+
+void BootTimeline_::_save()
+{
+  Preferences prefs;
+  prefs.begin("boot", false);
+  prefs.putBytes("last", &_current, sizeof(BootRecord));
+  prefs.end();
+}
+
+// ==================================================================
+// JSON 输出
+// ==================================================================
+
+void BootTimeline_::_recordToJson(const BootRecord &rec, JsonObject out)
+{
+  out["firmware"] = rec.firmware;
+  out["firstFrameUs"] = rec.firstFrameUs;
+  out["firstAppUs"] = rec.firstAppUs;
+  out["doneUs"] = rec.doneUs;
+
+  JsonObject phases = out.createNestedObject("phases");
+  for (int i = 0; i < BOOT_PHASE_COUNT; i++)
+  {
+    if (rec.durationUs[i] == 0)
+      continue;
+    JsonObject p = phases.createNestedObject(PHASE_NAMES[i]);
+    p["start"] = rec.startUs[i];
+    p["dur"] = rec.durationUs[i];
+  }
+}
+
+void BootTimeline_::toJson(JsonObject out) const
+{
+  _recordToJson(_current, out.createNestedObject("current"));
+  if (_hasPrevious)
+    _recordToJson(_previous, out.createNestedObject("previous"));
+}
@@ -0,0 +1,117 @@
+/**
+ * @file BootTimeline.h
+ * @brief 启动时间线 — 记录各启动阶段的 μs 时间戳
+ *
+ * 本文件定义：
+ *   - BootPhase 枚举: 启动阶段 (显示、文件系统、设置、外设、WiFi 等)
+ *   - BootRecord 结构体: 单次启动的时间线 (可直接写入 NVS)
+ *   - BootTimeline_ 单例类: 记录本次启动，并保留上一次启动的时间线
+ *
+ * 上一次启动的时间线保存在 NVS (命名空间 "boot")，OTA 升级后仍可读取，
+ * 配合 firmware 字段即可对比不同固件版本的启动耗时。
+ */
+
+#ifndef BOOT_TIMELINE_H
+#define BOOT_TIMELINE_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+
+// ==================================================================
+// 启动阶段
+// ==================================================================
+
+/// 启动阶段枚举 (顺序即 JSON 输出顺序)
+enum BootPhase
+{
+  BOOT_PHASE_DISPLAY = 0, ///< DisplayManager.setup()
+  BOOT_PHASE_FS,          ///< LittleFS 挂载
+  BOOT_PHASE_SETTINGS,    ///< loadSettings()
+  BOOT_PHASE_APPS,        ///< loadNativeApps() + applyAllSettings()
+  BOOT_PHASE_PERIPHERY,   ///< PeripheryManager.setup() (含首次 DHT 读取)
+  BOOT_PHASE_DHT,         ///< 首次 DHT22 读取 (PERIPHERY 的子阶段)
+  BOOT_PHASE_NETWORK,     ///< WebConfigManager.setup() + WeatherManager.setup()
+  BOOT_PHASE_WEBSOCKET,   ///< ServerManager.setup()
+  BOOT_PHASE_WIFI,        ///< 发起连接 → WiFi 已连接
+  BOOT_PHASE_COUNT
+};
+
+// ==================================================================
+// 单次启动记录
+// ==================================================================
+
+/// 单次启动的时间线 (POD，整体写入 NVS)
+struct BootRecord
+{
+  uint32_t magic;                        ///< 结构版本校验
+  char firmware[16];                     ///< 固件版本 (FIRMWARE_VERSION)
+  uint32_t startUs[BOOT_PHASE_COUNT];    ///< 阶段开始时间 (μs，自上电起)
+  uint32_t durationUs[BOOT_PHASE_COUNT]; ///< 阶段耗时 (μs，0=未记录)
+  uint32_t firstFrameUs;                 ///< 首帧输出时间
+  uint32_t firstAppUs;                   ///< 首次显示应用 (时钟) 的时间
+  uint32_t doneUs;                       ///< 启动状态机完成时间
+};
+
+// ==================================================================
+// 启动时间线类
+// ==================================================================
+
+/**
+ * @class BootTimeline_
+ * @brief 启动阶段计时器
+ *
+ * 用法：
+ *   BootTimeline.begin();                       // setup() 最开始
+ *   BootTimeline.phaseBegin(BOOT_PHASE_FS);
+ *   LittleFS.begin(...);
+ *   BootTimeline.phaseEnd(BOOT_PHASE_FS);
+ *   ...
+ *   BootTimeline.finish();                      // 启动状态机完成，写入 NVS
+ */
+class BootTimeline_
+{
+public:
+  static BootTimeline_ &getInstance();
+
+  /// 读取上一次启动的时间线并开始记录本次启动
+  void begin();
+
+  /// 标记阶段开始
+  void phaseBegin(BootPhase phase);
+
+  /// 标记阶段结束
+  void phaseEnd(BootPhase phase);
+
+  /// 标记首帧已输出 (仅首次调用生效)
+  void markFirstFrame();
+
+  /// 标记首次显示应用 (仅首次调用生效)
+  void markFirstApp();
+
+  /// 启动状态机完成，保存本次时间线
+  void finish();
+
+  /// 本次启动是否已完成
+  bool isFinished() const { return _finished; }
+
+  /**
+   * @brief 输出本次与上一次启动时间线
+   * @param out 目标 JSON 对象 (写入 current / previous 两个字段)
+   */
+  void toJson(JsonObject out) const;
+
+private:
+  BootTimeline_() {}
+
+  BootRecord _current = {};
+  BootRecord _previous = {};
+  bool _hasPrevious = false;
+  bool _finished = false;
+
+  void _save();
+  static void _recordToJson(const BootRecord &rec, JsonObject out);
+};
+
+extern BootTimeline_ &BootTimeline;
+
+#endif
@@ -0,0 +1,188 @@
+/**
+ * @file Canvas.h
+ * @brief 编译期布局画布 — 矩阵尺寸、拼接与走线方式作为模板参数
+ *
+ * 本文件定义：
+ *   - MatrixLayout 模板: 编译期布局参数与 constexpr XY()
+ *   - MatrixLayout0 ~ MatrixLayout5: setMatrixLayout() 支持的各布局
+ *   - Canvas 模板: 直接写 LED 缓冲区的画布 (无虚函数，按布局内联寻址)
+ *   - canvasRemap(): FastLED_NeoMatrix 的重映射函数 (GFX 兼容适配)
+ *
+ * FastLED_NeoMatrix 每画一个像素都要按运行时的拼接/蛇形参数重新推导
+ * 物理序号。这里把布局参数变成模板常量，XY() 折叠为几次移位和加法
+ * (宽高都是 2 的幂)。
+ *
+ * 现有应用仍通过 FastLED_NeoMatrix / Adafruit_GFX 绘制：DisplayManager
+ * 创建矩阵时用 setRemapFunction(canvasRemap<布局>) 接管寻址，颜色转换、
+ * 裁剪等行为不变。新代码可以直接用 Canvas<布局> 写缓冲区。
+ *
+ * 拼接块只支持从左上角逐行、同向排列 (NEO_TILE_TOP + LEFT + ROWS +
+ * PROGRESSIVE，即拼接参数全为 0)，这也是本项目所有布局使用的方式。
+ */
+
+#ifndef CANVAS_H
+#define CANVAS_H
+
+#include <FastLED.h>
+#include <FastLED_NeoMatrix.h>
+
+// ==================================================================
+// 编译期布局
+// ==================================================================
+
+/**
+ * @brief 编译期矩阵布局
+ * @tparam TW, TH 单块宽高 (像素)
+ * @tparam TX, TY 横向/纵向块数
+ * @tparam TYPE NEO_MATRIX_* 组合 (起始角、行/列、逐行/蛇形)
+ */
+template <uint8_t TW, uint8_t TH, uint8_t TX, uint8_t TY, uint8_t TYPE>
+struct MatrixLayout
+{
+  static_assert((TYPE & 0xF0) == 0, "only top-left progressive tiling");
+
+  static constexpr uint8_t TILE_W = TW;
+  static constexpr uint8_t TILE_H = TH;
+  static constexpr uint8_t TILES_X = TX;
+  static constexpr uint8_t TILES_Y = TY;
+  static constexpr uint8_t MATRIX_TYPE = TYPE;
+  static constexpr int16_t WIDTH = TW * TX;
+  static constexpr int16_t HEIGHT = TH * TY;
+
+  /// 逻辑坐标 → LED 缓冲区序号 (调用方保证坐标在范围内)
+  static constexpr uint16_t XY(int16_t x, int16_t y)
+  {
+    return tileOffset(x, y) + inTile(flipX(x % TW), flipY(y % TH));
+  }
+
+private:
+  /// 块序号 × 每块像素数
+  static constexpr uint16_t tileOffset(int16_t x, int16_t y)
+  {
+    return ((y / TH) * TX + x / TW) * (TW * TH);
+  }
+
+  static constexpr int16_t flipX(int16_t x)
+  {
+    return (TYPE & NEO_MATRIX_RIGHT) ? TW - 1 - x : x;
+  }
+
+  static constexpr int16_t flipY(int16_t y)
+  {
+    return (TYPE & NEO_MATRIX_BOTTOM) ? TH - 1 - y : y;
+  }
+
+  /// 块内序号: 按行排列时行为主轴，按列排列时列为主轴
+  static constexpr uint16_t inTile(int16_t x, int16_t y)
+  {
+    return (TYPE & NEO_MATRIX_COLUMNS) ? sequence(x, y, TH)
+                                       : sequence(y, x, TW);
+  }
+
+  /// 蛇形走线的奇数行/列反向
+  static constexpr uint16_t sequence(int16_t major, int16_t minor,
+                                     int16_t minorScale)
+  {
+    return ((TYPE & NEO_MATRIX_ZIGZAG) && (major & 1))
+               ? (major + 1) * minorScale - 1 - minor
+               : major * minorScale + minor;
+  }
+};
+
+/// 布局 0: 32x8 单块，按列蛇形
+typedef MatrixLayout<32, 8, 1, 1,
+                     NEO_MATRIX_TOP + NEO_MATRIX_LEFT + NEO_MATRIX_COLUMNS +
+                         NEO_MATRIX_ZIGZAG>
+    MatrixLayout0;
+
+/// 布局 2: 32x8 单块，按行蛇形
+typedef MatrixLayout<32, 8, 1, 1,
+                     NEO_MATRIX_TOP + NEO_MATRIX_LEFT + NEO_MATRIX_ROWS +
+                         NEO_MATRIX_ZIGZAG>
+    MatrixLayout2;
+
+/// 布局 3: 32x8 单块，从底部按列逐列
+typedef MatrixLayout<32, 8, 1, 1,
+                     NEO_MATRIX_BOTTOM + NEO_MATRIX_LEFT + NEO_MATRIX_COLUMNS +
+                         NEO_MATRIX_PROGRESSIVE>
+    MatrixLayout3;
+
+/// 布局 4: 4 块 8x8 横向拼接，块内按行蛇形
+typedef MatrixLayout<8, 8, 4, 1,
+                     NEO_MATRIX_TOP + NEO_MATRIX_LEFT + NEO_MATRIX_ROWS +
+                         NEO_MATRIX_ZIGZAG>
+    MatrixLayout4;
+
+/// 布局 5 (默认，布局 1 同此): 4 块 8x8 横向拼接，块内按行逐行
+typedef MatrixLayout<8, 8, 4, 1,
+                     NEO_MATRIX_TOP + NEO_MATRIX_LEFT + NEO_MATRIX_ROWS +
+                         NEO_MATRIX_PROGRESSIVE>
+    MatrixLayout5;
+
+// ==================================================================
+// 画布
+// ==================================================================
+
+/**
+ * @brief 直接写 LED 缓冲区的画布
+ *
+ * 所有方法都是内联的非虚函数，坐标越界时忽略 (与 GFX 的裁剪一致)。
+ */
+template <class Layout> class Canvas
+{
+public:
+  explicit Canvas(CRGB *leds) : _leds(leds) {}
+
+  static constexpr int16_t width() { return Layout::WIDTH; }
+  static constexpr int16_t height() { return Layout::HEIGHT; }
+
+  /// 逻辑坐标 → LED 缓冲区序号
+  static constexpr uint16_t XY(int16_t x, int16_t y)
+  {
+    return Layout::XY(x, y);
+  }
+
+  static constexpr bool contains(int16_t x, int16_t y)
+  {
+    return x >= 0 && y >= 0 && x < Layout::WIDTH && y < Layout::HEIGHT;
+  }
+
+  void drawPixel(int16_t x, int16_t y, const CRGB &color)
+  {
+    if (contains(x, y))
+      _leds[XY(x, y)] = color;
+  }
+
+  CRGB getPixel(int16_t x, int16_t y) const
+  {
+    return contains(x, y) ? _leds[XY(x, y)] : CRGB(0, 0, 0);
+  }
+
+  /// 竖线 (频谱条等按列绘制的场景)
+  void drawVLine(int16_t x, int16_t y, int16_t h, const CRGB &color)
+  {
+    for (int16_t i = 0; i < h; i++)
+      drawPixel(x, y + i, color);
+  }
+
+  void fill(const CRGB &color)
+  {
+    for (uint16_t i = 0; i < Layout::WIDTH * Layout::HEIGHT; i++)
+      _leds[i] = color;
+  }
+
+private:
+  CRGB *_leds;
+};
+
+// ==================================================================
+// GFX 兼容适配
+// ==================================================================
+
+/// FastLED_NeoMatrix::setRemapFunction() 用的寻址函数
+template <class Layout> uint16_t canvasRemap(uint16_t x, uint16_t y)
+{
+  return Layout::XY(x, y);
+}
+
+#endif
@@ -0,0 +1,130 @@
+/**
+ * @file ClockService.cpp
+ * @brief 时钟服务实现 — 秒边界检测与格式化缓存
+ */
+
+#include "ClockService.h"
+#include "Globals.h"
+#include <sys/time.h>
+
+// ==================================================================
+// 单例
+// ==================================================================
+
+ClockService_ &ClockService_::getInstance()
+{
+  static ClockService_ instance;
+  return instance;
+}
+
+ClockService_ &ClockService = ClockService_::getInstance();
+
+// ==================================================================
+// 秒边界
+// ==================================================================
+
+void ClockService_::tick()
+{
+  if (_frozen)
+    return;
+
+  struct timeval tv;
+  gettimeofday(&tv, nullptr);
+  if (tv.tv_sec == _epoch)
+  {
+    if (!_halfPassed && tv.tv_usec >= 500000)
+    {
+      _halfPassed = true;
+      _edge++;
+      _edgeMs = _secondStartMs + 500;
+      _edgeMarked = false;
+    }
+    return;
+  }
+
+  _epoch = tv.tv_sec;
+  _secondStartMs = millis() - tv.tv_usec / 1000;
+  _halfPassed = tv.tv_usec >= 500000;
+  _edge++;
+  _edgeMs = _secondStartMs;
+  _edgeMarked = false;
+  localtime_r(&_epoch, &_local);
+  _format();
+}
+
+uint16_t ClockService_::phaseMs() const
+{
+  if (_frozen)
+    return 0;
+  unsigned long phase = millis() - _secondStartMs;
+  return phase < 1000 ? phase : 999;
+}
+
+// ==================================================================
+// 冻结
+// ==================================================================
+
+void ClockService_::freeze(time_t epoch)
+{
+  _frozen = true;
+  _epoch = epoch;
+  localtime_r(&_epoch, &_local);
+  _format();
+}
+
+void ClockService_::thaw()
+{
+  _frozen = false;
+  _epoch = 0;
+}
+
+// ==================================================================
+// 边沿对齐统计
+// ==================================================================
+
+void ClockService_::markEdgeFrame()
+{
+  if (_edgeMarked)
+    return;
+  _edgeMarked = true;
+  unsigned long lag = millis() - _edgeMs;
+  _edgeFrames++;
+  _edgeLagSum += lag;
+  if (lag > _edgeLagMax)
+    _edgeLagMax = lag > 0xFFFF ? 0xFFFF : lag;
+}
+
+void ClockService_::edgeStats(JsonObject out) const
+{
+  out["edgeFrames"] = _edgeFrames;
+  out["edgeLagAvgMs"] = _edgeFrames ? (float)_edgeLagSum / _edgeFrames : 0.0f;
+  out["edgeLagMaxMs"] = _edgeLagMax;
+}
+
+/**
+ * @brief 格式化时间/日期
+ *
+ * 闪烁版本把第一个 ':' (没有则第一个空格) 替换为空格；
+ * 格式较长 (≥8 字符) 时不闪烁，避免文字宽度跳变。
+ */
+void ClockService_::_format()
+{
+  strftime(_timeText, sizeof(_timeText), TIME_FORMAT.c_str(), &_local);
+  strftime(_dateText, sizeof(_dateText), DATE_FORMAT.c_str(), &_local);
+
+  char fmt[CLOCK_TEXT_LEN];
+  strncpy(fmt, TIME_FORMAT.c_str(), sizeof(fmt));
+  fmt[sizeof(fmt) - 1] = '\0';
+  if (TIME_FORMAT.length() < 8)
+  {
+    char *sep = strchr(fmt, ':');
+    if (!sep)
+      sep = strchr(fmt, ' ');
+    if (sep)
+      *sep = ' ';
+  }
+  strftime(_timeBlink, sizeof(_timeBlink), fmt, &_local);
+
+  int dayOffset = START_ON_MONDAY ? 0 : 1;
+  _weekdayIndex = (_local.tm_wday + 6 + dayOffset) % 7;
+}
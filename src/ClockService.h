@@ -0,0 +1,112 @@
+/**
+ * @file ClockService.h
+ * @brief 时钟服务 — 每秒计算一次分解时间与格式化字符串，供各应用读取
+ *
+ * 本文件定义：
+ *   - ClockService_ 单例类: 秒边界检测、时间/日期字符串缓存、秒内相位
+ *
+ * 主循环每次调用 tick()，只有跨过秒边界 (或格式变化) 时才执行
+ * localtime_r() / strftime()。时间应用、日期应用、星期指示条直接读取缓存，
+ * 每帧不再做时间换算和字符串格式化。
+ *
+ * 秒内相位 (phaseMs) 以秒边界为零点，用于分隔符闪烁等与秒对齐的动画。
+ *
+ * 显示边沿 (edge): 秒边界与半秒 (分隔符切换) 处各计一次。显示引擎发现
+ * 边沿计数变化时立即渲染一帧，新的秒/分钟与分隔符闪烁落在真实的秒边界上，
+ * 而不是等到下一个固定帧间隔；markEdgeFrame() 统计边沿到出帧的延迟。
+ */
+
+#ifndef CLOCK_SERVICE_H
+#define CLOCK_SERVICE_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <time.h>
+
+/// 格式化字符串缓冲区长度
+#define CLOCK_TEXT_LEN 32
+
+/**
+ * @class ClockService_
+ * @brief 时钟服务
+ */
+class ClockService_
+{
+public:
+  static ClockService_ &getInstance();
+
+  /// 主循环调用：跨过秒边界时刷新缓存
+  void tick();
+
+  /// 时间/日期格式已修改，下一次 tick() 立即重新格式化
+  void invalidate() { _epoch = 0; }
+
+  /// 当前 Unix 时间 (秒)
+  time_t epoch() const { return _epoch; }
+
+  /// 当前本地时间 (分解)
+  const struct tm &local() const { return _local; }
+
+  /// 秒内相位 (0~999 毫秒，秒边界为 0)
+  uint16_t phaseMs() const;
+
+  /// 冒号分隔符本帧是否显示 (每秒前半秒显示)
+  bool separatorVisible() const { return phaseMs() < 500; }
+
+  /**
+   * @brief 按 TIME_FORMAT 格式化的时间
+   * @param separator true=带分隔符，false=分隔符替换为空格 (闪烁用)
+   */
+  const char *timeText(bool separator) const
+  {
+    return separator ? _timeText : _timeBlink;
+  }
+
+  /// 按 DATE_FORMAT 格式化的日期
+  const char *dateText() const { return _dateText; }
+
+  /// 星期指示条中今天的位置 (0~6，按 START_ON_MONDAY)
+  uint8_t weekdayIndex() const { return _weekdayIndex; }
+
+  /// 显示边沿计数 (秒边界、半秒各加一)
+  uint32_t edge() const { return _edge; }
+
+  /// 显示引擎在边沿触发的帧送出后调用，记录边沿到出帧的延迟
+  void markEdgeFrame();
+
+  /// 边沿对齐统计 (并入 getTimeSync 回复)
+  void edgeStats(JsonObject out) const;
+
+  /// 冻结在给定时间 (秒边界，相位 0)，直到 thaw()
+  void freeze(time_t epoch);
+
+  /// 解除冻结，下一次 tick() 重新读取系统时间
+  void thaw();
+
+private:
+  ClockService_() = default;
+
+  time_t _epoch = 0;
+  struct tm _local = {};
+  unsigned long _secondStartMs = 0; ///< 当前秒开始时的 millis()
+  bool _frozen = false;
+
+  uint32_t _edge = 0;
+  unsigned long _edgeMs = 0; ///< 最近一个边沿的 millis()
+  bool _halfPassed = false;  ///< 本秒的半秒边沿已计数
+  bool _edgeMarked = true;   ///< 最近一个边沿已出帧
+  uint32_t _edgeFrames = 0;
+  uint32_t _edgeLagSum = 0;
+  uint16_t _edgeLagMax = 0;
+
+  char _timeText[CLOCK_TEXT_LEN] = "";
+  char _timeBlink[CLOCK_TEXT_LEN] = "";
+  char _dateText[CLOCK_TEXT_LEN] = "";
+  uint8_t _weekdayIndex = 0;
+
+  void _format();
+};
+
+extern ClockService_ &ClockService;
+
+#endif
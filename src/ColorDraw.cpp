@@ -0,0 +1,133 @@
+/**
+ * @file ColorDraw.cpp
+ * @brief CRGB 原生绘制实现 — 查找表探测、绘制目标登记
+ */
+
+#include "ColorDraw.h"
+#include "Logger.h"
+
+uint8_t colorExpandR[32];
+uint8_t colorExpandG[64];
+uint8_t colorExpandB[32];
+uint8_t colorCurve[256];
+
+// ==================================================================
+// 颜色查找表
+// ==================================================================
+
+void colorDrawInit()
+{
+  // 1×1 的探测矩阵：每个分量值画一次，读回库展开的结果 (含库内 gamma)
+  CRGB px;
+  FastLED_NeoMatrix probe(&px, 1, 1,
+                          NEO_MATRIX_TOP + NEO_MATRIX_LEFT + NEO_MATRIX_ROWS +
+                              NEO_MATRIX_PROGRESSIVE);
+  for (uint8_t i = 0; i < 32; i++)
+  {
+    probe.drawPixel(0, 0, (uint16_t)(i << 11));
+    colorExpandR[i] = px.r;
+    probe.drawPixel(0, 0, (uint16_t)i);
+    colorExpandB[i] = px.b;
+  }
+  for (uint8_t i = 0; i < 64; i++)
+  {
+    probe.drawPixel(0, 0, (uint16_t)(i << 5));
+    colorExpandG[i] = px.g;
+  }
+
+  // 8 位曲线: 在 6 位绿色的 64 个点之间线性插值，0 和 255 落在端点上
+  for (uint16_t v = 0; v < 256; v++)
+  {
+    uint32_t pos = (uint32_t)v * 63 * 256 / 255; // 8.8 定点
+    uint8_t i = pos >> 8;
+    uint8_t frac = pos & 0xFF;
+    uint8_t lo = colorExpandG[i];
+    uint8_t hi = i < 63 ? colorExpandG[i + 1] : lo;
+    colorCurve[v] = lo + (((int16_t)hi - lo) * frac >> 8);
+  }
+
+  LOG_INFO("[Color] 565 展开表: 中灰 %d/%d/%d", colorExpandR[16],
+           colorExpandG[32], colorExpandB[16]);
+}
+
+// ==================================================================
+// 绘制目标
+// ==================================================================
+
+static struct
+{
+  FastLED_NeoMatrix *gfx;
+  CRGB *leds;
+} bindings[COLOR_DRAW_MAX_TARGETS];
+
+void colorDrawBind(FastLED_NeoMatrix *gfx, CRGB *leds)
+{
+  for (auto &b : bindings)
+  {
+    if (b.gfx == gfx)
+    {
+      b.leds = leds;
+      return;
+    }
+  }
+  for (auto &b : bindings)
+  {
+    if (!b.gfx)
+    {
+      b.gfx = gfx;
+      b.leds = leds;
+      return;
+    }
+  }
+  LOG_WARN("[Color] 绘制目标已满 (%d)，该目标退回 GFX 绘制",
+           COLOR_DRAW_MAX_TARGETS);
+}
+
+void colorDrawUnbind(FastLED_NeoMatrix *gfx)
+{
+  for (auto &b : bindings)
+  {
+    if (b.gfx == gfx)
+    {
+      b.gfx = nullptr;
+      b.leds = nullptr;
+    }
+  }
+}
+
+PixelTarget::PixelTarget(FastLED_NeoMatrix *gfx)
+    : _gfx(gfx), _leds(nullptr), _width(gfx->width()),
+      _height(gfx->height())
+{
+  for (const auto &b : bindings)
+  {
+    if (b.gfx == gfx)
+    {
+      _leds = b.leds;
+      break;
+    }
+  }
+}
+
+void PixelTarget::drawImage565(int16_t x, int16_t y, const uint16_t *pixels,
+                               uint16_t w, uint16_t h)
+{
+  for (uint16_t row = 0; row < h; row++)
+  {
+    int16_t py = y + row;
+    if (py < 0 || py >= _height)
+      continue;
+    const uint16_t *src = pixels + row * w;
+    for (uint16_t col = 0; col < w; col++)
+    {
+      int16_t px = x + col;
+      if (px < 0 || px >= _width)
+        continue;
+      CRGB led = expand565(src[col]);
+      if (_leds)
+        _leds[_gfx->XY(px, py)] = led;
+      else
+        _gfx->drawPixel(px, py, led);
+    }
+  }
+}
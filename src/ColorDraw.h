@@ -0,0 +1,115 @@
+/**
+ * @file ColorDraw.h
+ * @brief CRGB 原生绘制 — 颜色直接写 LED 缓冲区，不经 RGB565 往返
+ *
+ * 本文件定义：
+ *   - expand565() / colorCorrect(): RGB565 → LED 值、CRGB → LED 值 (查表)
+ *   - colorDrawBind(): 登记绘制目标 (GFX 对象 ↔ 其 LED 缓冲区)
+ *   - PixelTarget 类: 按登记的缓冲区直接写像素，未登记时退回 GFX
+ *
+ * GFX 路径的颜色是 RGB565：HEXtoColor()/hsvToRgb() 先截断到 565，
+ * FastLED_NeoMatrix 每画一个像素再经虚函数和 gamma 表展开回 888。
+ * 这里的查找表在启动时由 colorDrawInit() 用同一个库探测得到，
+ * expand565() 与库的展开逐值一致，旧内容 (图标帧、565 颜色) 画面不变；
+ * colorCorrect() 是同一条曲线的 8 位插值版本，CRGB 颜色不再丢低位，
+ * 与 565 内容放在一起观感一致。
+ *
+ * 用法：
+ *   PixelTarget t(matrix);               // 每次绘制前构造 (查一次登记表)
+ *   t.drawPixel(x, y, hsvToCRGB(...));   // CRGB 颜色 (按曲线校正)
+ *   t.drawImage565(x, y, frame, w, h);   // RGB565 图像 (查表展开)
+ *
+ * 文字等仍走 GFX；两条路径写同一个缓冲区，可以混用。
+ */
+
+#ifndef COLOR_DRAW_H
+#define COLOR_DRAW_H
+
+#include <FastLED.h>
+#include <FastLED_NeoMatrix.h>
+
+/// 最多同时登记的绘制目标 (显示屏 + 若干离屏画布)
+#define COLOR_DRAW_MAX_TARGETS 4
+
+// ==================================================================
+// 颜色查找表
+// ==================================================================
+
+extern uint8_t colorExpandR[32]; ///< 5 位红 → LED 值
+extern uint8_t colorExpandG[64]; ///< 6 位绿 → LED 值
+extern uint8_t colorExpandB[32]; ///< 5 位蓝 → LED 值
+extern uint8_t colorCurve[256];  ///< 8 位分量 → LED 值 (同一曲线插值)
+
+/// 探测 FastLED_NeoMatrix 的 565 展开，建立查找表 (启动时调用一次)
+void colorDrawInit();
+
+/// RGB565 → LED 值，与 FastLED_NeoMatrix::drawPixel(uint16_t) 的结果一致
+inline CRGB expand565(uint16_t color)
+{
+  return CRGB(colorExpandR[color >> 11], colorExpandG[(color >> 5) & 0x3F],
+              colorExpandB[color & 0x1F]);
+}
+
+/// CRGB 颜色 → LED 值 (8 位精度，曲线与 expand565 相同)
+inline CRGB colorCorrect(const CRGB &color)
+{
+  return CRGB(colorCurve[color.r], colorCurve[color.g], colorCurve[color.b]);
+}
+
+// ==================================================================
+// 绘制目标
+// ==================================================================
+
+/// 登记 GFX 对象对应的 LED 缓冲区 (同一对象重复登记时更新缓冲区)
+void colorDrawBind(FastLED_NeoMatrix *gfx, CRGB *leds);
+
+/// 取消登记 (GFX 对象销毁前调用)
+void colorDrawUnbind(FastLED_NeoMatrix *gfx);
+
+/**
+ * @class PixelTarget
+ * @brief 一个 GFX 对象的直接写入视图
+ *
+ * 构造时查找登记的缓冲区；寻址用 gfx->XY() (即布局的 canvasRemap)，
+ * 坐标越界时忽略。未登记的对象退回 GFX 的 drawPixel。
+ */
+class PixelTarget
+{
+public:
+  explicit PixelTarget(FastLED_NeoMatrix *gfx);
+
+  /// CRGB 颜色 (按 colorCorrect 校正)
+  void drawPixel(int16_t x, int16_t y, const CRGB &color)
+  {
+    drawLed(x, y, colorCorrect(color));
+  }
+
+  /// RGB565 颜色 (查表展开)
+  void drawPixel565(int16_t x, int16_t y, uint16_t color)
+  {
+    drawLed(x, y, expand565(color));
+  }
+
+  /// 已是 LED 值的颜色 (预先校正过的调色板等)，原样写入
+  void drawLed(int16_t x, int16_t y, const CRGB &led)
+  {
+    if (x < 0 || y < 0 || x >= _width || y >= _height)
+      return;
+    if (_leds)
+      _leds[_gfx->XY(x, y)] = led;
+    else
+      _gfx->drawPixel(x, y, led);
+  }
+
+  /// RGB565 图像 (逐行，w × h 个像素)
+  void drawImage565(int16_t x, int16_t y, const uint16_t *pixels, uint16_t w,
+                    uint16_t h);
+
+private:
+  FastLED_NeoMatrix *_gfx;
+  CRGB *_leds; ///< 登记的缓冲区 (nullptr=退回 GFX)
+  int16_t _width;
+  int16_t _height;
+};
+
+#endif
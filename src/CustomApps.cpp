@@ -0,0 +1,284 @@
+/**
+ * @file CustomApps.cpp
+ * @brief 自定义应用实现 — 槽位管理、文字预渲染、渲染
+ */
+
+#include "CustomApps.h"
+#include "DisplayManager.h"
+#include "Globals.h"
+#include "Logger.h"
+#include "Tools.h"
+
+// ==================================================================
+// 单例
+// ==================================================================
+
+CustomApps_ &CustomApps_::getInstance()
+{
+  static CustomApps_ instance;
+  return instance;
+}
+
+CustomApps_ &CustomApps = CustomApps_::getInstance();
+
+// ==================================================================
+// 槽位回调 (每个槽位一个固定的 AppCallback)
+// ==================================================================
+
+template <uint8_t N>
+static void customAppCallback(FastLED_NeoMatrix *matrix,
+                              MatrixDisplayUiState *state, int16_t x,
+                              int16_t y, FastFramePlayer *player)
+{
+  CustomApps.render(N, matrix, state, x, y, player);
+}
+
+static const AppCallback SLOT_CALLBACKS[CUSTOM_APP_SLOTS] = {
+    customAppCallback<0>, customAppCallback<1>, customAppCallback<2>,
+    customAppCallback<3>, customAppCallback<4>, customAppCallback<5>,
+    customAppCallback<6>, customAppCallback<7>};
+
+// ==================================================================
+// 槽位管理
+// ==================================================================
+
+/**
+ * @brief 应用显示时长
+ *
+ * 未指定时长的滚动文字取整数圈滚动时间 (不短于全局时长)，
+ * 切走时文字正好完整滚出；其余返回 0 (全局时长)。
+ */
+static uint16_t appDuration(const CustomAppSlot &slot)
+{
+  if (slot.duration || !slot.text.scroll)
+    return slot.duration;
+  uint32_t cycle = slot.text.cycleMs();
+  uint32_t rounds = (TIME_PER_APP + cycle - 1) / cycle;
+  uint32_t duration = rounds * cycle;
+  return duration > 0xFFFF ? 0xFFFF : duration;
+}
+
+int CustomApps_::_find(const char *name)
+{
+  for (int i = 0; i < CUSTOM_APP_SLOTS; i++)
+  {
+    if (_slots[i].used && strcmp(_slots[i].name, name) == 0)
+      return i;
+  }
+  return -1;
+}
+
+/**
+ * @brief 创建或更新自定义应用
+ *
+ * 已存在的应用只更新提供的字段；新建应用未提供的字段取默认值。
+ * 文字变化或图标变化时重新排版。
+ */
+bool CustomApps_::update(JsonObject cmd, String &error)
+{
+  const char *name = cmd["name"] | "";
+  if (*name == '\0' || strlen(name) >= CUSTOM_APP_NAME_LEN)
+  {
+    error = "invalid name";
+    return false;
+  }
+
+  int index = _find(name);
+  bool created = false;
+  if (index < 0)
+  {
+    for (int i = 0; i < CUSTOM_APP_SLOTS; i++)
+    {
+      if (!_slots[i].used)
+      {
+        index = i;
+        break;
+      }
+    }
+    if (index < 0)
+    {
+      error = "no free slot";
+      return false;
+    }
+
+    CustomAppSlot &slot = _slots[index];
+    memset(&slot, 0, sizeof(slot));
+    slot.text.clear();
+    slot.used = true;
+    strncpy(slot.name, name, CUSTOM_APP_NAME_LEN - 1);
+    slot.systemIcon = -1;
+    slot.color = TEXTCOLOR_565;
+    slot.position = CUSTOM_APP_DEFAULT_POSITION + index;
+    created = true;
+  }
+
+  CustomAppSlot &slot = _slots[index];
+  uint16_t oldDuration = appDuration(slot);
+
+  if (cmd.containsKey("icon"))
+  {
+    const char *icon = cmd["icon"] | "";
+    slot.icon[0] = '\0';
+    slot.systemIcon = -1;
+    if (*icon >= '0' && *icon <= '9')
+    {
+      int sys = atoi(icon);
+      if (sys < (int)(sizeof(ICON_LIB) / sizeof(ICON_LIB[0])))
+        slot.systemIcon = sys;
+    }
+    else
+    {
+      strncpy(slot.icon, icon, CUSTOM_APP_ICON_LEN - 1);
+      slot.icon[CUSTOM_APP_ICON_LEN - 1] = '\0';
+    }
+  }
+  if (cmd.containsKey("color"))
+    slot.color = HEXtoColor(cmd["color"] | "");
+  if (cmd.containsKey("duration"))
+    slot.duration = cmd["duration"].as<uint16_t>();
+  if (cmd.containsKey("position"))
+    slot.position = cmd["position"].as<int>();
+  if (cmd.containsKey("lifetime"))
+  {
+    // 寿命 (秒)，0 = 永不过期；到期后自动移除
+    uint32_t lifetime = cmd["lifetime"].as<uint32_t>();
+    slot.expiresAt = lifetime ? millis() + lifetime * 1000UL : 0;
+    if (slot.expiresAt == 0 && lifetime)
+      slot.expiresAt = 1;
+  }
+
+  if (cmd.containsKey("scrollSpeed"))
+    slot.text.setSpeed(cmd["scrollSpeed"].as<float>());
+
+  // 文字变化时重新渲染列位图；图标变化会改变文字区域，总是重新计算
+  if (cmd.containsKey("text"))
+  {
+    slot.text.clear();
+    slot.text.appendJson(cmd["text"], slot.color);
+  }
+  else if (cmd.containsKey("color"))
+  {
+    slot.text.setColor(slot.color);
+  }
+  bool hasIcon = slot.systemIcon >= 0 || slot.icon[0] != '\0';
+  int16_t areaX = hasIcon ? 9 : 0;
+  slot.text.reflow(areaX, MATRIX_WIDTH - areaX);
+  slot.shownAt = millis();
+
+  if (created)
+  {
+    LOG_INFO("[CustomApp] 新建应用 '%s' (槽位 %d)", slot.name, index);
+    _reload();
+  }
+  else if (appDuration(slot) != oldDuration)
+  {
+    _reload(); // 滚动长度变化，更新自动时长
+  }
+  return true;
+}
+
+bool CustomApps_::remove(const char *name)
+{
+  int index = _find(name);
+  if (index < 0)
+    return false;
+
+  _slots[index].used = false;
+  LOG_INFO("[CustomApp] 删除应用 '%s'", name);
+  _reload();
+  return true;
+}
+
+void CustomApps_::tick()
+{
+  bool changed = false;
+  for (auto &slot : _slots)
+  {
+    if (slot.used && slot.expiresAt && (long)(millis() - slot.expiresAt) >= 0)
+    {
+      LOG_INFO("[CustomApp] 应用 '%s' 已过期", slot.name);
+      slot.used = false;
+      changed = true;
+    }
+  }
+  if (changed)
+    _reload();
+}
+
+/// 应用列表变化，重建 UI 应用列表 (在主循环中调用，不会与渲染并发)
+void CustomApps_::_reload() { DisplayManager.loadNativeApps(); }
+
+void CustomApps_::appendApps(std::vector<AppData> &apps)
+{
+  for (int i = 0; i < CUSTOM_APP_SLOTS; i++)
+  {
+    const CustomAppSlot &slot = _slots[i];
+    if (slot.used)
+      apps.push_back({slot.name, SLOT_CALLBACKS[i], true, slot.position,
+                      appDuration(slot)});
+  }
+}
+
+void CustomApps_::toJson(JsonArray out)
+{
+  for (const auto &slot : _slots)
+  {
+    if (!slot.used)
+      continue;
+    JsonObject app = out.createNestedObject();
+    app["name"] = slot.name;
+    if (slot.systemIcon >= 0)
+      app["icon"] = slot.systemIcon;
+    else if (slot.icon[0])
+      app["icon"] = slot.icon;
+    app["duration"] = appDuration(slot);
+    app["position"] = slot.position;
+    app["width"] = slot.text.width;
+    app["scroll"] = slot.text.scroll;
+    if (slot.expiresAt)
+      app["expiresIn"] = (long)(slot.expiresAt - millis()) / 1000;
+  }
+}
+
+// ==================================================================
+// 渲染
+// ==================================================================
+
+/**
+ * @brief 渲染自定义应用
+ *
+ * 只拷贝列位图中文字区域的窗口 (Marquee::draw)。
+ * 应用重新出现 (切换过来) 时滚动从头开始，与自动时长对齐。
+ */
+void CustomApps_::render(uint8_t index, FastLED_NeoMatrix *matrix,
+                         MatrixDisplayUiState *state, int16_t x, int16_t y,
+                         FastFramePlayer *player)
+{
+  CustomAppSlot &slot = _slots[index];
+  if (!slot.used)
+    return;
+
+  if (CURRENT_APP != slot.name)
+    CURRENT_APP = slot.name;
+
+  // 超过 100ms 未绘制说明刚切换过来
+  unsigned long now = millis();
+  if (now - slot.drawnAt > 100)
+    slot.shownAt = now;
+  slot.drawnAt = now;
+
+  slot.text.draw(matrix, x, y, now - slot.shownAt);
+  if (slot.text.scroll)
+    state->requestFrame(0, FRAME_SCROLL);
+
+  // 图标绘制在文字之上，遮住滚入图标区域的文字
+  if (slot.text.areaX > 0)
+  {
+    matrix->fillRect(x, y, slot.text.areaX, 8, 0);
+    if (slot.systemIcon >= 0)
+      player->loadSystem(slot.systemIcon);
+    else
+      player->loadUser(slot.icon);
+    player->play(x, y);
+  }
+}
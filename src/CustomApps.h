@@ -0,0 +1,124 @@
+/**
+ * @file CustomApps.h
+ * @brief 自定义应用 — 通过 WebSocket / HTTP / MQTT 推送的数据驱动应用
+ *
+ * 本文件定义：
+ *   - CustomAppSlot 结构体: 固定大小的应用槽 (文字、图标、颜色、时长、寿命)
+ *   - CustomApps_ 单例类: 槽位管理、文字预排版、渲染
+ *
+ * 文字在更新时一次性渲染成列位图 (见 Marquee)，渲染时只拷贝文字区域窗口，
+ * 与原生应用一样不做任何字符串处理或堆分配。
+ * 滚动文字未指定 duration 时，显示时长自动取整数圈滚动时间。
+ *
+ * 命令 (dispatchCommand)：
+ *   {type:"customApp", name, text, icon, color, duration, lifetime, position,
+ *    scrollSpeed}
+ *   text 为字符串，或多段颜色数组 [{t:"文字", c:"#FF0000"}, ...]
+ *   {type:"removeCustomApp", name}
+ *   {type:"getCustomApps"}
+ */
+
+#ifndef CUSTOM_APPS_H
+#define CUSTOM_APPS_H
+
+#include "FastFramePlayer.h"
+#include "MatrixDisplayUi.h"
+#include "Marquee.h"
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <vector>
+
+// ==================================================================
+// 自定义应用配置
+// ==================================================================
+
+/// 自定义应用槽位数量
+#define CUSTOM_APP_SLOTS 8
+
+/// 应用名称最大长度 (含结尾 '\0')
+#define CUSTOM_APP_NAME_LEN 16
+
+/// 图标文件名最大长度 (含结尾 '\0')
+#define CUSTOM_APP_ICON_LEN 32
+
+/// 自定义应用的默认排序位置 (排在原生应用之后)
+#define CUSTOM_APP_DEFAULT_POSITION 100
+
+// ==================================================================
+// 应用槽
+// ==================================================================
+
+/// 单个自定义应用 (定长，无堆分配)
+struct CustomAppSlot
+{
+  bool used;                      ///< 槽位是否占用
+  char name[CUSTOM_APP_NAME_LEN]; ///< 应用名称 (唯一标识)
+  char icon[CUSTOM_APP_ICON_LEN]; ///< 用户图标文件名 (空=无图标)
+  int16_t systemIcon;             ///< 内置图标索引 (-1=无)
+  uint16_t color;                 ///< 文字颜色 (RGB565)
+  uint16_t duration;              ///< 显示时长 (ms，0=自动)
+  int position;                   ///< 排序位置
+  unsigned long expiresAt;        ///< 过期时间 (millis，0=永不过期)
+  unsigned long shownAt;          ///< 本次显示开始时间 (滚动起点)
+  unsigned long drawnAt;          ///< 最近一次绘制时间
+
+  Marquee text;                   ///< 预渲染的文字
+};
+
+// ==================================================================
+// 自定义应用管理器类
+// ==================================================================
+
+/**
+ * @class CustomApps_
+ * @brief 自定义应用管理器
+ *
+ * 每个槽位对应一个固定的 AppCallback，应用增删时通过
+ * DisplayManager.loadNativeApps() 重建应用列表。
+ */
+class CustomApps_
+{
+public:
+  static CustomApps_ &getInstance();
+
+  /**
+   * @brief 创建或更新自定义应用
+   * @param cmd customApp 命令 (name 必填，其余字段可选)
+   * @param error 输出: 失败原因
+   * @return true=成功
+   */
+  bool update(JsonObject cmd, String &error);
+
+  /**
+   * @brief 删除自定义应用
+   * @param name 应用名称
+   * @return true=已删除
+   */
+  bool remove(const char *name);
+
+  /// 主循环 - 清理过期应用
+  void tick();
+
+  /// 将已占用槽位追加到应用列表 (由 DisplayManager.loadNativeApps() 调用)
+  void appendApps(std::vector<AppData> &apps);
+
+  /// 输出所有自定义应用
+  void toJson(JsonArray out);
+
+  /// 渲染指定槽位 (由槽位回调调用；滚动文字时请求最高帧率)
+  void render(uint8_t index, FastLED_NeoMatrix *matrix,
+              MatrixDisplayUiState *state, int16_t x, int16_t y,
+              FastFramePlayer *player);
+
+private:
+  CustomApps_() {}
+
+  CustomAppSlot _slots[CUSTOM_APP_SLOTS] = {};
+
+  int _find(const char *name);
+  void _reload();
+};
+
+extern CustomApps_ &CustomApps;
+
+#endif
@@ -12,10 +12,19 @@
 #include <ArduinoJson.h>
 
 #include "Apps.h"
+#include "Canvas.h"
+#include "ClockService.h"
+#include "ColorDraw.h"
+#include "CustomApps.h"
 #include "DisplayManager.h"
 #include "Globals.h"
+#include "HeapTelemetry.h"
+#include "LedOutput.h"
 #include "Liveview.h"
 #include "Logger.h"
+#include "NotifyManager.h"
+#include "OffscreenCanvas.h"
+#include "TimerManager.h"
 #include "Tools.h"
 
 // ==================================================================
@@ -71,7 +80,9 @@ DisplayManager_ &DisplayManager = DisplayManager.getInstance();
  */
 void DisplayManager_::setup()
 {
-  FastLED.addLeds<WS2812B, MATRIX_PIN, GRB>(leds, MATRIX_WIDTH * MATRIX_HEIGHT);
+  HeapTagScope heapTag(HEAP_TAG_DISPLAY);
+  LedOutput.begin(leds);
+  colorDrawInit();
   setMatrixLayout(MATRIX_LAYOUT);
 
   // FastLED.setCorrection(COLOR_CORRECTION);
@@ -81,7 +92,7 @@ void DisplayManager_::setup()
   ui->setTargetFPS(MATRIX_FPS);
   ui->setTimePerApp(TIME_PER_APP);
   ui->setTimePerTransition(TIME_PER_TRANSITION);
-  ui->setOverlays(overlays, 1);
+  ui->setOverlays(overlays, overlayCount);
   ui->init();
 
   // 初始化 Liveview 模块
@@ -89,7 +100,6 @@ void DisplayManager_::setup()
   Liveview.setInterval(250);
 
   _state = DisplayState();
-  _state.scrollX = MATRIX_WIDTH;
 }
 
 // ==================================================================
@@ -133,10 +143,30 @@ void DisplayManager_::defaultTextColor() { setTextColor(TEXTCOLOR_565); }
 // 矩阵布局
 // ==================================================================
 
+/**
+ * @brief 按编译期布局创建矩阵
+ *
+ * 构造参数取自布局常量，寻址交给 canvasRemap<Layout> (编译期展开)，
+ * 不再由 FastLED_NeoMatrix 逐像素推导拼接/蛇形序号。
+ */
+template <class Layout> static FastLED_NeoMatrix *createMatrix()
+{
+  FastLED_NeoMatrix *m;
+  if (Layout::TILES_X > 1 || Layout::TILES_Y > 1)
+    m = new FastLED_NeoMatrix(leds, Layout::TILE_W, Layout::TILE_H,
+                              Layout::TILES_X, Layout::TILES_Y,
+                              Layout::MATRIX_TYPE);
+  else
+    m = new FastLED_NeoMatrix(leds, Layout::TILE_W, Layout::TILE_H,
+                              Layout::MATRIX_TYPE);
+  m->setRemapFunction(canvasRemap<Layout>);
+  return m;
+}
+
 /**
  * @brief 设置矩阵布局模式
  *
- * 支持多种硬件拼接方式：
+ * 支持多种硬件拼接方式 (参数见 Canvas.h 中的 MatrixLayout0~5)：
  *   - 0: 32x8 单块 Col+Zigzag
  *   - 2: 32x8 单块 Row+Zigzag
  *   - 3: 32x8 单块 Bottom+Col+Prog
@@ -147,56 +177,30 @@ void DisplayManager_::defaultTextColor() { setTextColor(TEXTCOLOR_565); }
  */
 void DisplayManager_::setMatrixLayout(int layout)
 {
+  colorDrawUnbind(matrix);
   delete matrix;
 
-  // 简化布局枚举切换分支
-  uint8_t type = NEO_MATRIX_TOP + NEO_MATRIX_LEFT + NEO_MATRIX_ROWS +
-                 NEO_MATRIX_PROGRESSIVE;
-  int w = 8, h = 8, tilesX = 4, tilesY = 1;
-
   switch (layout)
   {
-  case 0: // 32x8 单块 Col+Zigzag
-    w = 32;
-    h = 8;
-    tilesX = 1;
-    tilesY = 1;
-    type = NEO_MATRIX_TOP + NEO_MATRIX_LEFT + NEO_MATRIX_COLUMNS +
-           NEO_MATRIX_ZIGZAG;
+  case 0:
+    matrix = createMatrix<MatrixLayout0>();
     break;
-  case 2: // 32x8 单块 Row+Zigzag
-    w = 32;
-    h = 8;
-    tilesX = 1;
-    tilesY = 1;
-    type =
-        NEO_MATRIX_TOP + NEO_MATRIX_LEFT + NEO_MATRIX_ROWS + NEO_MATRIX_ZIGZAG;
+  case 2:
+    matrix = createMatrix<MatrixLayout2>();
     break;
-  case 3: // 32x8 单块 Bottom+Col+Prog
-    w = 32;
-    h = 8;
-    tilesX = 1;
-    tilesY = 1;
-    type = NEO_MATRIX_BOTTOM + NEO_MATRIX_LEFT + NEO_MATRIX_COLUMNS +
-           NEO_MATRIX_PROGRESSIVE;
+  case 3:
+    matrix = createMatrix<MatrixLayout3>();
     break;
-  case 4: // 4x1 拼 Row+Zigzag
-    type =
-        NEO_MATRIX_TOP + NEO_MATRIX_LEFT + NEO_MATRIX_ROWS + NEO_MATRIX_ZIGZAG;
+  case 4:
+    matrix = createMatrix<MatrixLayout4>();
     break;
   case 5: // Default
   default:
+    matrix = createMatrix<MatrixLayout5>();
     break;
   }
 
-  if (tilesX > 1)
-  {
-    matrix = new FastLED_NeoMatrix(leds, w, h, tilesX, tilesY, type);
-  }
-  else
-  {
-    matrix = new FastLED_NeoMatrix(leds, w, h, type);
-  }
+  colorDrawBind(matrix, leds);
 
   delete ui;
   ui = new MatrixDisplayUi(matrix);
@@ -215,27 +219,12 @@ void DisplayManager_::setMatrixLayout(int layout)
  */
 void DisplayManager_::tick()
 {
+  HeapTagScope heapTag(HEAP_TAG_DISPLAY);
   if (_state.status != DISPLAY_NORMAL)
   {
     matrix->clear();
-    switch (_state.status)
-    {
-    case DISPLAY_AP_MODE:
-      _renderAPMode();
-      break;
-    case DISPLAY_CONNECTING:
-      _renderConnecting();
-      break;
-    case DISPLAY_CONNECTED:
-      _renderConnected();
-      break;
-    case DISPLAY_CONNECT_FAILED:
-      _renderConnectFailed();
-      break;
-    default:
-      break;
-    }
-    matrix->show();
+    _renderStatus();
+    show();
   }
   else
   {
@@ -243,6 +232,30 @@ void DisplayManager_::tick()
   }
 }
 
+void DisplayManager_::_renderStatus()
+{
+  switch (_state.status)
+  {
+  case DISPLAY_AP_MODE:
+    _renderAPMode();
+    break;
+  case DISPLAY_CONNECTING:
+    _renderConnecting();
+    break;
+  case DISPLAY_CONNECTED:
+    _renderConnected();
+    break;
+  case DISPLAY_CONNECT_FAILED:
+    _renderConnectFailed();
+    break;
+  case DISPLAY_BOOT:
+    _renderBoot();
+    break;
+  default:
+    break;
+  }
+}
+
 // ==================================================================
 // 基础绘制
 // ==================================================================
@@ -251,7 +264,108 @@ void DisplayManager_::tick()
 void DisplayManager_::clear() { matrix->clear(); }
 
 /// 将缓冲区数据输出到 LED
-void DisplayManager_::show() { matrix->show(); }
+void DisplayManager_::show() { LedOutput.present(); }
+
+FastLED_NeoMatrix *DisplayManager_::getMatrix() { return matrix; }
+
+void DisplayManager_::frameStatsToJson(JsonObject out) { ui->frameStatsToJson(out); }
+
+void DisplayManager_::resetFrameStats() { ui->resetFrameStats(); }
+
+void DisplayManager_::captureFrame(uint8_t *rgb) const
+{
+  for (int16_t y = 0; y < MATRIX_HEIGHT; y++)
+  {
+    for (int16_t x = 0; x < MATRIX_WIDTH; x++)
+    {
+      const CRGB &c = leds[matrix->XY(x, y)];
+      *rgb++ = c.r;
+      *rgb++ = c.g;
+      *rgb++ = c.b;
+    }
+  }
+}
+
+// ==================================================================
+// 离屏画布
+// ==================================================================
+
+void DisplayManager_::renderToCanvas(AppCallback app, OffscreenCanvas &canvas,
+                                     FastFramePlayer *player,
+                                     MatrixDisplayUiState *state)
+{
+  // 应用经 DisplayManager 绘制文字，渲染期间把全局绘制目标切到画布
+  FastLED_NeoMatrix *live = matrix;
+  matrix = canvas.gfx();
+  canvas.clear();
+  player->setMatrix(matrix);
+  app(matrix, state, 0, 0, player);
+  player->setMatrix(live);
+  matrix = live;
+}
+
+void DisplayManager_::_renderStatusToCanvas(OffscreenCanvas &canvas)
+{
+  FastLED_NeoMatrix *live = matrix;
+  matrix = canvas.gfx();
+  canvas.clear();
+  _renderStatus();
+  matrix = live;
+}
+
+/**
+ * @brief 计算画布与屏幕的重叠区域
+ * @return false=完全在屏幕外
+ */
+static bool clipCanvas(int16_t dx, int16_t dy, int16_t &x0, int16_t &y0,
+                       int16_t &x1, int16_t &y1)
+{
+  x0 = dx < 0 ? -dx : 0;
+  y0 = dy < 0 ? -dy : 0;
+  x1 = MATRIX_WIDTH - dx < OffscreenCanvas::WIDTH ? MATRIX_WIDTH - dx
+                                                  : OffscreenCanvas::WIDTH;
+  y1 = MATRIX_HEIGHT - dy < OffscreenCanvas::HEIGHT ? MATRIX_HEIGHT - dy
+                                                    : OffscreenCanvas::HEIGHT;
+  return x0 < x1 && y0 < y1;
+}
+
+void DisplayManager_::blit(const OffscreenCanvas &canvas, int16_t dx,
+                           int16_t dy)
+{
+  int16_t x0, y0, x1, y1;
+  if (!clipCanvas(dx, dy, x0, y0, x1, y1))
+    return;
+  const CRGB *src = canvas.pixels();
+  for (int16_t y = y0; y < y1; y++)
+  {
+    for (int16_t x = x0; x < x1; x++)
+      leds[matrix->XY(x + dx, y + dy)] = src[OffscreenLayout::XY(x, y)];
+  }
+}
+
+void DisplayManager_::composite(const OffscreenCanvas &canvas, int16_t dx,
+                                int16_t dy, uint8_t alpha,
+                                bool blackIsTransparent)
+{
+  int16_t x0, y0, x1, y1;
+  if (alpha == 0 || !clipCanvas(dx, dy, x0, y0, x1, y1))
+    return;
+  const CRGB *src = canvas.pixels();
+  for (int16_t y = y0; y < y1; y++)
+  {
+    for (int16_t x = x0; x < x1; x++)
+    {
+      const CRGB &c = src[OffscreenLayout::XY(x, y)];
+      if (blackIsTransparent && !c.r && !c.g && !c.b)
+        continue;
+      CRGB &dst = leds[matrix->XY(x + dx, y + dy)];
+      if (alpha == 255)
+        dst = c;
+      else
+        nblend(dst, c, alpha);
+    }
+  }
+}
 
 /**
  * @brief 打印文字到指定位置
@@ -327,12 +441,15 @@ void DisplayManager_::applyAllSettings()
     ui->enablesetAutoTransition();
   else
     ui->disablesetAutoTransition();
+
+  // 时间/日期格式、一周起始日可能已修改
+  ClockService.invalidate();
 }
 
 /**
  * @brief 加载内置应用列表
  *
- * 将时间、日期、温度、湿度、天气、风速应用添加到 Apps 列表，
+ * 将时间、日期、温度、湿度、天气、风速应用及自定义应用添加到 Apps 列表，
  * 并按 position 排序
  */
 void DisplayManager_::loadNativeApps()
@@ -347,6 +464,9 @@ void DisplayManager_::loadNativeApps()
                   WEATHER_DURATION});
   Apps.push_back({"wind", WindApp, SHOW_WIND, WIND_POSITION, WIND_DURATION});
 
+  // 自定义应用 (WebSocket / HTTP / MQTT 推送)
+  CustomApps.appendApps(Apps);
+
   std::sort(Apps.begin(), Apps.end(), [](const AppData &a, const AppData &b)
             { return a.position < b.position; });
 
@@ -360,7 +480,12 @@ void DisplayManager_::nextApp() { ui->nextApp(); }
 void DisplayManager_::previousApp() { ui->previousApp(); }
 void DisplayManager_::leftButton() { ui->previousApp(); }
 void DisplayManager_::rightButton() { ui->nextApp(); }
-void DisplayManager_::selectButton() {}
+void DisplayManager_::selectButton()
+{
+  // 先关闭响铃，没有响铃时关闭通知
+  if (!TimerManager.dismiss())
+    NotifyManager.dismiss();
+}
 
 // ==================================================================
 // 状态显示系统
@@ -372,12 +497,13 @@ void DisplayManager_::setDisplayStatus(DisplayStatus status,
   _state.status = status;
   _state.line1 = line1;
   _state.line2 = line2;
-  _state.scrollX = MATRIX_WIDTH + 4;
-  _state.scrollTextWidth = getTextWidth(line2.c_str(), false);
-  _state.startTime = millis();
+  _state.startTime = _now();
   _state.animFrame = 0;
-  _state.lastAnimTime = millis();
-  _state.lastScrollTime = millis();
+  _state.lastAnimTime = _now();
+
+  // 副文字只在状态切换时渲染一次；有图标的画面文字区域从第 9 列开始
+  int16_t areaX = (status == DISPLAY_AP_MODE || status == DISPLAY_CONNECTED) ? 9 : 0;
+  _state.marquee.layout(line2.c_str(), 0xFFFF, areaX, MATRIX_WIDTH - areaX);
 
   LOG_INFO("[Display] 状态切换: %d, L1='%s', L2='%s'", status, line1.c_str(), line2.c_str());
 }
@@ -398,51 +524,21 @@ void DisplayManager_::_drawWiFiIcon(int16_t x, int16_t y, uint16_t color)
   matrix->drawPixel(x + 3, y + 6, color);
 }
 
-void DisplayManager_::_drawScrollText(int16_t y, const String &text,
-                                      uint16_t color)
-{
-  if (millis() - _state.lastScrollTime >= 50)
-  {
-    _state.lastScrollTime = millis();
-    _state.scrollX--;
-    if (_state.scrollX < -_state.scrollTextWidth)
-    {
-      _state.scrollX = MATRIX_WIDTH + 2;
-    }
-  }
-  matrix->setTextColor(color);
-  matrix->setCursor(_state.scrollX, y);
-  matrix->print(text);
-}
-
 void DisplayManager_::_renderAPMode()
 {
   // 固定颜色 #6366F1
   uint16_t iconColor = 0x633E;
 
-  // 1. 绘制滚动文字 (背景层)
-  if (millis() - _state.lastScrollTime >= 50)
-  {
-    _state.lastScrollTime = millis();
-    _state.scrollX--;
-    if (_state.scrollX < 9 - _state.scrollTextWidth)
-      _state.scrollX = MATRIX_WIDTH + 2;
-  }
-  matrix->setTextColor(0xFFFF);
-  matrix->setCursor(_state.scrollX, 6);
-  matrix->print(_state.line2);
-
-  // 2. 清除左侧图标区域 (遮罩)
-  // 填充黑色矩形覆盖文字，防止文字穿透图标
-  matrix->fillRect(0, 0, 9, 8, 0);
+  // 1. 绘制滚动文字 (只绘制图标右侧区域，无需遮罩)
+  _state.marquee.draw(matrix, 0, 0, _now() - _state.startTime);
 
-  // 3. 绘制图标 (前景层)
+  // 2. 绘制图标
   _drawWiFiIcon(0, 0, iconColor);
 }
 
 void DisplayManager_::_renderConnecting()
 {
-  unsigned long now = millis();
+  unsigned long now = _now();
   if (now - _state.lastAnimTime >= 150)
   {
     _state.lastAnimTime = now;
@@ -465,21 +561,13 @@ void DisplayManager_::_renderConnecting()
     }
   }
 
-  if (millis() - _state.lastScrollTime >= 55)
-  {
-    _state.lastScrollTime = millis();
-    _state.scrollX--;
-    if (_state.scrollX < -_state.scrollTextWidth)
-      _state.scrollX = MATRIX_WIDTH + 2;
-  }
-  matrix->setTextColor(0xFFFF);
-  matrix->setCursor(_state.scrollX, 7);
-  matrix->print(_state.line2);
+  // 文字下移一行，让出顶行的扫描点
+  _state.marquee.draw(matrix, 0, 1, _now() - _state.startTime);
 }
 
 void DisplayManager_::_renderConnected()
 {
-  unsigned long elapsed = millis() - _state.startTime;
+  unsigned long elapsed = _now() - _state.startTime;
   if (elapsed > 5000)
   {
     _state.status = DISPLAY_NORMAL;
@@ -490,22 +578,10 @@ void DisplayManager_::_renderConnected()
   // 固定颜色 #10B430
   uint16_t checkColor = 0x1586;
 
-  // 1. 绘制滚动文字 (背景层)
-  if (millis() - _state.lastScrollTime >= 50)
-  {
-    _state.lastScrollTime = millis();
-    _state.scrollX--;
-    if (_state.scrollX < 9 - _state.scrollTextWidth)
-      _state.scrollX = MATRIX_WIDTH + 2;
-  }
-  matrix->setTextColor(0xFFFF);
-  matrix->setCursor(_state.scrollX, 6);
-  matrix->print(_state.line2);
-
-  // 2. 清除 Check 图标区域 (遮罩)
-  matrix->fillRect(0, 0, 9, 8, 0);
+  // 1. 绘制滚动文字 (只绘制图标右侧区域，无需遮罩)
+  _state.marquee.draw(matrix, 0, 0, _now() - _state.startTime);
 
-  // 3. 绘制 Check 图标 (前景层)
+  // 2. 绘制 Check 图标
   const int8_t checkX[] = {1, 2, 3, 4, 5, 6, 7};
   const int8_t checkY[] = {5, 6, 7, 6, 5, 4, 3};
   for (int i = 0; i < 7; i++)
@@ -514,7 +590,7 @@ void DisplayManager_::_renderConnected()
 
 void DisplayManager_::_renderConnectFailed()
 {
-  unsigned long elapsed = millis() - _state.startTime;
+  unsigned long elapsed = _now() - _state.startTime;
   if (elapsed > 3000)
   {
     setDisplayStatus(DISPLAY_AP_MODE, _state.line1, "192.168.4.1");
@@ -535,3 +611,24 @@ void DisplayManager_::_renderConnectFailed()
   matrix->setCursor(10, 6);
   matrix->print("FAIL");
 }
+
+
+void DisplayManager_::_renderBoot()
+{
+  unsigned long now = _now();
+  if (now - _state.lastAnimTime >= 40)
+  {
+    _state.lastAnimTime = now;
+    _state.animFrame = (_state.animFrame + 1) % MATRIX_WIDTH;
+  }
+
+  matrix->setTextColor(TEXTCOLOR_565);
+  printText(0, 6, _state.line1.c_str(), true, true);
+
+  // 底部扫描点 (#6366F1, #303078)，表示启动阶段仍在进行
+  uint16_t dotColor = 0x633E;
+  uint16_t trailColor = 0x318F;
+  matrix->drawPixel(_state.animFrame, 7, dotColor);
+  matrix->drawPixel((_state.animFrame - 1 + MATRIX_WIDTH) % MATRIX_WIDTH, 7,
+                    trailColor);
+}
\ No newline at end of file
@@ -12,12 +12,18 @@
 #define DISPLAY_MANAGER_H
 
 #include "Globals.h"
+#include "Marquee.h"
 #include "MatrixDisplayUi.h"
 #include <Arduino.h>
+#include <ArduinoJson.h>
 #include <FastLED.h>
 #include <FastLED_NeoMatrix.h>
 #include <vector>
 
+class OffscreenCanvas;
+struct MatrixDisplayUiState;
+class FastFramePlayer;
+
 // ==================================================================
 // 显示状态枚举
 // ==================================================================
@@ -29,7 +35,8 @@ enum DisplayStatus
   DISPLAY_AP_MODE,       ///< AP 配网模式 - 显示热点名称和 IP
   DISPLAY_CONNECTING,    ///< WiFi 连接中动画
   DISPLAY_CONNECTED,     ///< 连接成功 - 短暂显示 IP 地址
-  DISPLAY_CONNECT_FAILED ///< 连接失败提示
+  DISPLAY_CONNECT_FAILED, ///< 连接失败提示
+  DISPLAY_BOOT            ///< 启动画面 (启动阶段进行中)
 };
 
 // ==================================================================
@@ -58,9 +65,7 @@ private:
     DisplayStatus status = DISPLAY_NORMAL; ///< 当前显示状态
     String line1;                          ///< 主显示文字
     String line2;                          ///< 副显示文字 (滚动)
-    int16_t scrollX = 0;                   ///< 滚动位置
-    int16_t scrollTextWidth = 0;           ///< 滚动文字像素宽度
-    unsigned long lastScrollTime = 0;      ///< 上次滚动时间
+    Marquee marquee;                       ///< 预渲染的副显示文字
     unsigned long startTime = 0;           ///< 状态开始时间
     uint8_t animFrame = 0;                 ///< 动画帧索引
     unsigned long lastAnimTime = 0;        ///< 上次动画更新时间
@@ -82,11 +87,28 @@ private:
   /// 渲染 WiFi 连接失败画面
   void _renderConnectFailed();
 
+  /// 渲染启动画面
+  void _renderBoot();
+
   /// 绘制 WiFi 图标
   void _drawWiFiIcon(int16_t x, int16_t y, uint16_t color);
 
-  /// 绘制滚动文字
-  void _drawScrollText(int16_t y, const String &text, uint16_t color);
+  /// 按 _state.status 渲染状态画面 (不 show)
+  void _renderStatus();
+
+  /// 按 _state.status 把状态画面渲染到离屏画布 (显示缓冲区不变)
+  void _renderStatusToCanvas(OffscreenCanvas &canvas);
+
+  // ==================================================================
+  // 状态画面时钟 (渲染检查时冻结)
+  // ==================================================================
+  bool _clockFrozen = false;
+  unsigned long _frozenMs = 0;
+
+  /// 状态画面使用的毫秒时间 (冻结时返回固定值)
+  unsigned long _now() const { return _clockFrozen ? _frozenMs : millis(); }
+
+  friend class RenderCheck_; ///< 渲染检查直接驱动状态画面
 
 public:
   /**
@@ -108,9 +130,56 @@ public:
   /// 清空显示缓冲区
   void clear();
 
-  /// 将缓冲区数据输出到 LED
+  /// 将缓冲区数据输出到 LED (提交给 LedOutput，异步发送)
   void show();
 
+  /// 矩阵驱动 (布局切换后会重建，不要长期保存)
+  FastLED_NeoMatrix *getMatrix();
+
+  /// UI 帧率统计 (有效帧率、节省的 CPU 时间，见 MatrixDisplayUi)
+  void frameStatsToJson(JsonObject out);
+  void resetFrameStats();
+
+  /**
+   * @brief 按逻辑坐标读取显示缓冲区
+   * @param rgb 输出: MATRIX_WIDTH × MATRIX_HEIGHT × 3 字节 (RGB，行优先)
+   */
+  void captureFrame(uint8_t *rgb) const;
+
+  // ==================================================================
+  // 离屏画布
+  // ==================================================================
+
+  /**
+   * @brief 把应用渲染到离屏画布 (显示缓冲区不变)
+   *
+   * 渲染期间 DisplayManager 的文字/颜色调用和 player 都指向画布。
+   * @param app 应用绘制函数 (AppCallback；本头文件先于 MatrixDisplayUi.h
+   *            展开，这里写出完整类型)
+   * @param canvas 目标画布 (先清空)
+   * @param player 动画播放器 (渲染后重新指向显示屏)
+   * @param state UI 状态
+   */
+  void renderToCanvas(void (*app)(FastLED_NeoMatrix *, MatrixDisplayUiState *,
+                                  int16_t, int16_t, FastFramePlayer *),
+                      OffscreenCanvas &canvas, FastFramePlayer *player,
+                      MatrixDisplayUiState *state);
+
+  /**
+   * @brief 把画布复制到显示缓冲区
+   * @param dx, dy 画布左上角在屏幕上的位置 (超出屏幕的部分裁剪)
+   */
+  void blit(const OffscreenCanvas &canvas, int16_t dx = 0, int16_t dy = 0);
+
+  /**
+   * @brief 把画布叠加到显示缓冲区
+   * @param dx, dy 画布左上角在屏幕上的位置 (超出屏幕的部分裁剪)
+   * @param alpha 不透明度 (255=完全覆盖)
+   * @param blackIsTransparent 画布中的黑色像素不绘制
+   */
+  void composite(const OffscreenCanvas &canvas, int16_t dx, int16_t dy,
+                 uint8_t alpha = 255, bool blackIsTransparent = true);
+
   // ==================================================================
   // 亮度与颜色设置
   // ==================================================================
@@ -187,7 +256,7 @@ public:
   /// 左按钮 - 切换到上一个应用
   void leftButton();
 
-  /// 选择按钮 - 当前未实现
+  /// 选择按钮 - 关闭响铃，没有响铃时关闭当前通知
   void selectButton();
 
   /// 右按钮 - 切换到下一个应用
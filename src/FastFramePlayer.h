@@ -7,11 +7,15 @@
  *   - 移除 String _currentPath，改为 int _currentId 和 char _currentFile[32]
  *   - loadSystem: 整数比较防抖 (零开销)
  *   - loadUser:   C 字符串比较防抖 (无堆分配)
+ *   2026-10-17:
+ *   - play: 经 PixelTarget 查表展开 RGB565，直接写 LED 缓冲区
+ *   - takePlayed / msUntilNextFrame: 供 MatrixDisplayUi 按图标动画调节帧率
  */
 
 #ifndef FAST_FRAME_PLAYER_H
 #define FAST_FRAME_PLAYER_H
 
+#include "ColorDraw.h"
 #include "Icons.h"
 #include <FastLED_NeoMatrix.h>
 #include <LittleFS.h>
@@ -40,10 +44,13 @@ private:
   unsigned long _lastTime = 0; // 上次切帧时间
   uint16_t _width = 0;
   uint16_t _height = 0;
+  bool _played = false;        // 自上次 takePlayed() 以来是否绘制过
 
   // 帧缓冲区 (RGB565)
   uint16_t _frameBuffer[MAX_ICON_PIXELS];
 
+  friend class Benchmark_; ///< 微基准测试直接测量 loadCurrentFrame
+
 public:
   FastFramePlayer() : mtx(nullptr) { _currentUserFile[0] = '\0'; }
 
@@ -160,13 +167,27 @@ public:
       }
     }
 
-    // 2. 绘制
-    uint16_t count = _width * _height;
-    for (uint16_t i = 0; i < count; i++)
-    {
-      // 简单取模计算坐标
-      mtx->drawPixel(x + (i % _width), y + (i / _width), _frameBuffer[i]);
-    }
+    _played = true;
+
+    // 2. 绘制 (查表展开 565，直接写缓冲区)
+    PixelTarget(mtx).drawImage565(x, y, _frameBuffer, _width, _height);
+  }
+
+  /// 自上次调用以来是否绘制过 (读取后清除，帧率调节用)
+  bool takePlayed()
+  {
+    bool played = _played;
+    _played = false;
+    return played;
+  }
+
+  /// 距下一次切帧的毫秒数 (静态图标返回 UINT32_MAX)
+  uint32_t msUntilNextFrame() const
+  {
+    if (_frameCount <= 1 || _frameDelay == 0)
+      return UINT32_MAX;
+    uint32_t elapsed = millis() - _lastTime;
+    return elapsed >= _frameDelay ? 0 : _frameDelay - elapsed;
   }
 
 private:
@@ -10,6 +10,7 @@
 
 #include "Globals.h"
 #include "Logger.h"
+#include "LoopWatchdog.h"
 #include <Preferences.h>
 
 // ==================================================================
@@ -41,6 +42,9 @@ bool SHOW_WIND = true;
 
 // 音乐频谱
 bool SPECTRUM_ACTIVE = false;
+uint8_t SPECTRUM_BAND_LAYOUT = 0;
+uint16_t SPECTRUM_MIN_HZ = 100;
+uint16_t SPECTRUM_MAX_HZ = 4000;
 
 String CURRENT_APP = "";
 
@@ -169,6 +173,11 @@ void loadSettings()
   WEATHER_POSITION = preferences.getInt("weatherPos", 4);
   WIND_POSITION = preferences.getInt("windPos", 5);
 
+  // 加载频谱频段布局
+  SPECTRUM_BAND_LAYOUT = preferences.getUChar("specLayout", 0);
+  SPECTRUM_MIN_HZ = preferences.getUShort("specMinHz", 100);
+  SPECTRUM_MAX_HZ = preferences.getUShort("specMaxHz", 4000);
+
   preferences.end(); // 关闭 Preferences
 
   LOG_INFO("[Globals] 设置加载完成");
@@ -186,6 +195,7 @@ void loadSettings()
  */
 void saveSettings()
 {
+  LoopStageScope scope(LOOP_STAGE_NVS);
   preferences.begin("neo-clock", false); // 读写模式保存
 
   preferences.putUInt("appTime", TIME_PER_APP);
@@ -235,6 +245,11 @@ void saveSettings()
   preferences.putInt("weatherPos", WEATHER_POSITION);
   preferences.putInt("windPos", WIND_POSITION);
 
+  // 保存频谱频段布局
+  preferences.putUChar("specLayout", SPECTRUM_BAND_LAYOUT);
+  preferences.putUShort("specMinHz", SPECTRUM_MIN_HZ);
+  preferences.putUShort("specMaxHz", SPECTRUM_MAX_HZ);
+
   preferences.end(); // 关闭 Preferences
 
   LOG_INFO("[Globals] 设置已保存");
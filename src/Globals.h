@@ -17,6 +17,15 @@
 #include <Arduino.h>
 #include <vector>
 
+// ==================================================================
+// 固件信息
+// ==================================================================
+
+/// 固件版本 (可在 build_flags 中覆盖，用于区分启动时间线等记录)
+#ifndef FIRMWARE_VERSION
+#define FIRMWARE_VERSION "1.0"
+#endif
+
 // ==================================================================
 // 硬件引脚定义
 // ==================================================================
@@ -92,6 +101,12 @@ extern bool SHOW_WIND;
 // ==================================================================
 // 音乐频谱
 extern bool SPECTRUM_ACTIVE;
+/// 频谱频段布局 (SpectrumLayout: 0=经典表, 1=对数)
+extern uint8_t SPECTRUM_BAND_LAYOUT;
+/// 对数布局的最低频率 (Hz)
+extern uint16_t SPECTRUM_MIN_HZ;
+/// 对数布局的最高频率 (Hz，不超过采样率一半)
+extern uint16_t SPECTRUM_MAX_HZ;
 /// 当前正在显示的应用名称
 extern String CURRENT_APP;
 
@@ -0,0 +1,275 @@
+/**
+ * @file GlyphCache.cpp
+ * @brief 中文字库实现 — 块索引查找、LRU 缓存、统计
+ */
+
+#include "GlyphCache.h"
+#include "Logger.h"
+#include <LittleFS.h>
+
+/// 链表空指针
+static const uint8_t NIL = 0xFF;
+
+/// 未使用的缓存槽码点
+static const uint32_t NO_CODEPOINT = 0xFFFFFFFF;
+
+// ==================================================================
+// 单例
+// ==================================================================
+
+GlyphCache_ &GlyphCache_::getInstance()
+{
+  static GlyphCache_ instance;
+  return instance;
+}
+
+GlyphCache_ &GlyphCache = GlyphCache_::getInstance();
+
+GlyphCache_::GlyphCache_()
+{
+  memset(_buckets, NIL, sizeof(_buckets));
+  for (uint8_t i = 0; i < GLYPH_CACHE_SIZE; i++)
+  {
+    _slots[i].codepoint = NO_CODEPOINT;
+    _slots[i].prev = i == 0 ? NIL : i - 1;
+    _slots[i].next = i == GLYPH_CACHE_SIZE - 1 ? NIL : i + 1;
+    _slots[i].hashNext = NIL;
+  }
+  _head = 0;
+  _tail = GLYPH_CACHE_SIZE - 1;
+}
+
+// ==================================================================
+// 字库
+// ==================================================================
+
+/// 首次查找时打开字库 (LittleFS 此时已挂载)，文件句柄常驻
+void GlyphCache_::_open()
+{
+  _opened = true;
+  if (!LittleFS.exists(GLYPH_FONT_PATH))
+  {
+    LOG_INFO("[Glyph] 未找到字库 %s，中文字符显示为方框", GLYPH_FONT_PATH);
+    return;
+  }
+
+  _file = LittleFS.open(GLYPH_FONT_PATH, "r");
+  uint8_t header[16];
+  if (!_file || _file.read(header, sizeof(header)) != sizeof(header) ||
+      memcmp(header, "NCF1", 4) != 0)
+  {
+    LOG_WARN("[Glyph] 字库格式无效");
+    _file.close();
+    return;
+  }
+
+  _glyphCount = header[4] | header[5] << 8;
+  _cellBytes = header[7];
+  _blockSize = header[8] | header[9] << 8;
+  _blockCount = header[10] | header[11] << 8;
+  if (_cellBytes == 0 || _cellBytes > GLYPH_MAX_WIDTH || _blockSize == 0 ||
+      _blockSize > GLYPH_MAX_BLOCK || _blockCount > GLYPH_MAX_BLOCKS ||
+      (uint32_t)_blockCount * _blockSize < _glyphCount)
+  {
+    LOG_WARN("[Glyph] 字库参数超出限制");
+    _file.close();
+    return;
+  }
+
+  if (_file.read((uint8_t *)_blockFirst, _blockCount * 4) != _blockCount * 4u)
+  {
+    LOG_WARN("[Glyph] 字库块表读取失败");
+    _file.close();
+    return;
+  }
+
+  _loaded = true;
+  LOG_INFO("[Glyph] 字库已加载: %u 字, %u 块", _glyphCount, _blockCount);
+}
+
+/**
+ * @brief 从字库读取一个字形
+ *
+ * 块表二分定位块 → 读该块索引二分 → 读位图。共两次 Flash 读取。
+ */
+bool GlyphCache_::_read(uint32_t codepoint, CachedGlyph &glyph)
+{
+  // 最后一个 first <= codepoint 的块
+  int lo = 0, hi = _blockCount - 1, block = -1;
+  while (lo <= hi)
+  {
+    int mid = (lo + hi) / 2;
+    if (_blockFirst[mid] <= codepoint)
+    {
+      block = mid;
+      lo = mid + 1;
+    }
+    else
+    {
+      hi = mid - 1;
+    }
+  }
+  if (block < 0)
+    return false;
+
+  uint32_t first = (uint32_t)block * _blockSize;
+  if (first >= _glyphCount)
+    return false;
+  uint16_t count = _glyphCount - first < _blockSize ? _glyphCount - first
+                                                     : _blockSize;
+  uint32_t entries[GLYPH_MAX_BLOCK];
+  uint32_t indexBase = 16 + _blockCount * 4;
+  if (!_file.seek(indexBase + first * 4) ||
+      _file.read((uint8_t *)entries, count * 4) != count * 4u)
+    return false;
+
+  lo = 0;
+  hi = count - 1;
+  while (lo <= hi)
+  {
+    int mid = (lo + hi) / 2;
+    uint32_t cp = entries[mid] >> 8;
+    if (cp == codepoint)
+    {
+      uint32_t bitmap = indexBase + (uint32_t)_glyphCount * 4 +
+                        (first + mid) * _cellBytes;
+      memset(glyph.columns, 0, sizeof(glyph.columns));
+      if (!_file.seek(bitmap) ||
+          _file.read(glyph.columns, _cellBytes) != _cellBytes)
+        return false;
+      glyph.advance = entries[mid] & 0xFF;
+      if (glyph.advance > GLYPH_MAX_WIDTH)
+        glyph.advance = GLYPH_MAX_WIDTH;
+      return glyph.advance > 0;
+    }
+    if (cp < codepoint)
+      lo = mid + 1;
+    else
+      hi = mid - 1;
+  }
+  return false;
+}
+
+// ==================================================================
+// 缓存
+// ==================================================================
+
+void GlyphCache_::_unlink(uint8_t slot)
+{
+  CachedGlyph &g = _slots[slot];
+  if (g.prev != NIL)
+    _slots[g.prev].next = g.next;
+  else
+    _head = g.next;
+  if (g.next != NIL)
+    _slots[g.next].prev = g.prev;
+  else
+    _tail = g.prev;
+}
+
+void GlyphCache_::_pushFront(uint8_t slot)
+{
+  CachedGlyph &g = _slots[slot];
+  g.prev = NIL;
+  g.next = _head;
+  if (_head != NIL)
+    _slots[_head].prev = slot;
+  _head = slot;
+  if (_tail == NIL)
+    _tail = slot;
+}
+
+void GlyphCache_::_hashRemove(uint8_t slot)
+{
+  uint8_t *link = &_buckets[_bucket(_slots[slot].codepoint)];
+  while (*link != NIL)
+  {
+    if (*link == slot)
+    {
+      *link = _slots[slot].hashNext;
+      return;
+    }
+    link = &_slots[*link].hashNext;
+  }
+}
+
+const CachedGlyph *GlyphCache_::lookup(uint32_t codepoint)
+{
+  uint32_t start = ESP.getCycleCount();
+
+  // 命中：移到 LRU 头部
+  uint8_t bucket = _bucket(codepoint);
+  for (uint8_t i = _buckets[bucket]; i != NIL; i = _slots[i].hashNext)
+  {
+    if (_slots[i].codepoint == codepoint)
+    {
+      if (i != _head)
+      {
+        _unlink(i);
+        _pushFront(i);
+      }
+      _hits++;
+      _hitCycles += ESP.getCycleCount() - start;
+      return _slots[i].advance ? &_slots[i] : nullptr;
+    }
+  }
+
+  if (!_opened)
+    _open();
+  if (!_loaded)
+    return nullptr;
+
+  // 未命中：淘汰 LRU 尾部，从 Flash 读入
+  uint8_t slot = _tail;
+  CachedGlyph &g = _slots[slot];
+  if (g.codepoint != NO_CODEPOINT)
+  {
+    _hashRemove(slot);
+    _evictions++;
+  }
+  _unlink(slot);
+
+  g.codepoint = codepoint;
+  if (!_read(codepoint, g))
+  {
+    g.advance = 0; // 缓存 "没有此字"，避免重复读 Flash
+    _missing++;
+  }
+  g.hashNext = _buckets[bucket];
+  _buckets[bucket] = slot;
+  _pushFront(slot);
+
+  uint32_t cycles = ESP.getCycleCount() - start;
+  _misses++;
+  _missCycles += cycles;
+  if (cycles > _maxMissCycles)
+    _maxMissCycles = cycles;
+  return g.advance ? &g : nullptr;
+}
+
+void GlyphCache_::resetStats()
+{
+  _hits = _misses = _missing = _evictions = 0;
+  _hitCycles = _missCycles = 0;
+  _maxMissCycles = 0;
+}
+
+void GlyphCache_::toJson(JsonObject out)
+{
+  uint32_t mhz = ESP.getCpuFreqMHz();
+  uint32_t lookups = _hits + _misses;
+
+  out["enabled"] = GLYPH_CJK_FONT != 0;
+  out["loaded"] = _loaded;
+  out["glyphs"] = _glyphCount;
+  out["cacheSize"] = GLYPH_CACHE_SIZE;
+  out["hits"] = _hits;
+  out["misses"] = _misses;
+  out["missing"] = _missing;
+  out["evictions"] = _evictions;
+  out["hitRate"] = lookups ? (float)_hits * 100.0f / lookups : 0.0f;
+  // 单字平均耗时 (微秒)
+  out["hitUs"] = _hits ? (float)_hitCycles / _hits / mhz : 0.0f;
+  out["missUs"] = _misses ? (float)_missCycles / _misses / mhz : 0.0f;
+  out["maxMissUs"] = (float)_maxMissCycles / mhz;
+}
@@ -0,0 +1,139 @@
+/**
+ * @file GlyphCache.h
+ * @brief 中文字库 — LittleFS 中的点阵字库子集 + 内存 LRU 字形缓存
+ *
+ * 本文件定义：
+ *   - CachedGlyph 结构体: 缓存中的一个字形 (列位图)
+ *   - GlyphCache_ 单例类: 字库加载、按码点查找、命中率统计
+ *
+ * 字库文件 (GLYPH_FONT_PATH，由 tools/bdf2ncf.py 从 BDF 字体生成)：
+ *   头部 16 字节:  "NCF1" | 字数 u16 | 高度 u8 | 单字字节数 u8 |
+ *                  每块条目数 u16 | 块数 u16 | 保留 u32
+ *   块表:          块数 × u32 (每块第一个码点)
+ *   索引:          字数 × u32 (码点 << 8 | 字宽)，按码点升序
+ *   位图:          字数 × 单字字节数 (列位图，bit n = 第 n 行，与 Marquee 相同)
+ *
+ * 字库文件尚未随固件数据提供 (见 tools/fonts/README.md)，中文显示默认关闭：
+ * GLYPH_CJK_FONT 为 0 时 Marquee 不查字库，多字节字符按原来的 utf8ascii
+ * 处理 (非 Latin-1 字符不显示)。生成并上传字库后以 -D GLYPH_CJK_FONT=1 构建。
+ *
+ * 查找：
+ *   - 命中: 哈希表 O(1) 找到缓存槽，移到 LRU 头部，不访问 Flash
+ *   - 未命中: 内存块表二分 → 读一个索引块 (≤256 字节) 二分 → 读位图，
+ *     淘汰 LRU 尾部；字库中没有的码点也缓存 (避免重复读 Flash)
+ */
+
+#ifndef GLYPH_CACHE_H
+#define GLYPH_CACHE_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <FS.h>
+
+// ==================================================================
+// 字库配置
+// ==================================================================
+
+/// 中文显示 (1=Marquee 从字库取中文字形，需要 LittleFS 中有字库文件)
+#ifndef GLYPH_CJK_FONT
+#define GLYPH_CJK_FONT 0
+#endif
+
+/// 字库文件路径
+#define GLYPH_FONT_PATH "/fonts/cjk.ncf"
+
+/// 缓存字形数
+#define GLYPH_CACHE_SIZE 64
+
+/// 哈希桶数 (2 的幂)
+#define GLYPH_HASH_BUCKETS 128
+
+/// 单字最大宽度 (列数)
+#define GLYPH_MAX_WIDTH 8
+
+/// 每块最大条目数
+#define GLYPH_MAX_BLOCK 64
+
+/// 最大块数 (块表常驻内存)
+#define GLYPH_MAX_BLOCKS 256
+
+// ==================================================================
+// 字形缓存
+// ==================================================================
+
+/// 缓存中的字形
+struct CachedGlyph
+{
+  uint32_t codepoint;                ///< Unicode 码点
+  uint8_t advance;                   ///< 字宽 (含间距，0=字库中没有)
+  uint8_t columns[GLYPH_MAX_WIDTH];  ///< 列位图
+  uint8_t prev;                      ///< LRU 链表
+  uint8_t next;
+  uint8_t hashNext;                  ///< 哈希桶链表
+};
+
+/**
+ * @class GlyphCache_
+ * @brief 中文字形缓存
+ */
+class GlyphCache_
+{
+public:
+  static GlyphCache_ &getInstance();
+
+  /**
+   * @brief 查找字形
+   * @param codepoint Unicode 码点
+   * @return 字形 (字库中没有或字库未加载时返回 nullptr)；
+   *         指针在下一次 lookup 前有效
+   */
+  const CachedGlyph *lookup(uint32_t codepoint);
+
+  /// 输出字库与缓存统计 (命中率、单字耗时)
+  void toJson(JsonObject out);
+
+  /// 清零统计
+  void resetStats();
+
+private:
+  GlyphCache_();
+
+  // --- 字库 ---
+  bool _opened = false; ///< 已尝试打开 (只尝试一次)
+  bool _loaded = false;
+  File _file;
+  uint16_t _glyphCount = 0;
+  uint8_t _cellBytes = 0;
+  uint16_t _blockSize = 0;
+  uint16_t _blockCount = 0;
+  uint32_t _blockFirst[GLYPH_MAX_BLOCKS];
+
+  // --- 缓存 ---
+  CachedGlyph _slots[GLYPH_CACHE_SIZE];
+  uint8_t _buckets[GLYPH_HASH_BUCKETS];
+  uint8_t _head; ///< 最近使用
+  uint8_t _tail; ///< 最久未用
+
+  // --- 统计 ---
+  uint32_t _hits = 0;
+  uint32_t _misses = 0;
+  uint32_t _missing = 0;    ///< 字库中没有的码点 (首次查找)
+  uint32_t _evictions = 0;
+  uint64_t _hitCycles = 0;  ///< 命中累计 CPU 周期
+  uint64_t _missCycles = 0; ///< 未命中累计 CPU 周期 (含读 Flash)
+  uint32_t _maxMissCycles = 0;
+
+  void _open();
+  bool _read(uint32_t codepoint, CachedGlyph &glyph);
+  void _unlink(uint8_t slot);
+  void _pushFront(uint8_t slot);
+  void _hashRemove(uint8_t slot);
+  static uint8_t _bucket(uint32_t codepoint)
+  {
+    return (codepoint * 2654435761u) >> 25 & (GLYPH_HASH_BUCKETS - 1);
+  }
+};
+
+extern GlyphCache_ &GlyphCache;
+
+#endif
@@ -0,0 +1,324 @@
+/**
+ * @file HeapTelemetry.cpp
+ * @brief 堆内存遥测实现 — malloc 包装钩子、存活块表、采样
+ */
+
+#include "HeapTelemetry.h"
+#include <esp_heap_caps.h>
+
+/// 子系统名称 (与 HeapTag 顺序一致)
+static const char *const TAG_NAMES[HEAP_TAG_COUNT] = {
+    "none", "server", "weather", "display", "liveview", "logger"};
+
+// ==================================================================
+// 钩子共享状态 (任意任务中调用，全部在 trackMux 保护下访问)
+// ==================================================================
+
+/// 存活块: 指针 → 大小 (高 24 位) | 标记 (低 8 位)
+struct LiveBlock
+{
+  void *ptr;
+  uint32_t info;
+};
+
+static LiveBlock liveTable[HEAP_TRACK_SLOTS];
+static uint16_t liveCount = 0;
+static uint32_t trackOverflow = 0; ///< 达到负载上限未能跟踪的分配次数
+static HeapTagStats tagStats[HEAP_TAG_COUNT];
+
+static TaskHandle_t loopTask = nullptr;
+static volatile HeapTag loopTag = HEAP_TAG_NONE;
+static struct
+{
+  TaskHandle_t task;
+  HeapTag tag;
+} taskTags[HEAP_TAGGED_TASKS];
+
+static portMUX_TYPE trackMux = portMUX_INITIALIZER_UNLOCKED;
+
+static inline uint16_t IRAM_ATTR slotOf(const void *ptr)
+{
+  return ((uint32_t)(uintptr_t)ptr >> 3) * 2654435761u >>
+         (32 - 9); // log2(HEAP_TRACK_SLOTS)
+}
+
+static_assert(HEAP_TRACK_SLOTS == 512, "slotOf() 的移位需与表大小一致");
+
+/// 当前任务的标记
+static HeapTag IRAM_ATTR currentTag()
+{
+  TaskHandle_t task = xTaskGetCurrentTaskHandle();
+  if (task == nullptr)
+    return HEAP_TAG_NONE;
+  if (task == loopTask)
+    return loopTag;
+  for (uint8_t i = 0; i < HEAP_TAGGED_TASKS; i++)
+  {
+    if (taskTags[i].task == task)
+      return taskTags[i].tag;
+  }
+  return HEAP_TAG_NONE;
+}
+
+/// 记录一个带标记的分配
+static void IRAM_ATTR track(void *ptr, size_t size, HeapTag tag)
+{
+  portENTER_CRITICAL(&trackMux);
+  if (liveCount >= HEAP_TRACK_MAX_LIVE)
+  {
+    trackOverflow++;
+    portEXIT_CRITICAL(&trackMux);
+    return;
+  }
+  uint16_t i = slotOf(ptr);
+  while (liveTable[i].ptr != nullptr)
+    i = (i + 1) & (HEAP_TRACK_SLOTS - 1);
+  liveTable[i].ptr = ptr;
+  liveTable[i].info = (uint32_t)size << 8 | tag;
+  liveCount++;
+
+  HeapTagStats &s = tagStats[tag];
+  s.allocs++;
+  s.liveBlocks++;
+  s.liveBytes += size;
+  if (s.liveBytes > s.peakBytes)
+    s.peakBytes = s.liveBytes;
+  portEXIT_CRITICAL(&trackMux);
+}
+
+/**
+ * @brief 移除一个分配 (线性探测表，向后移位删除，无墓碑)
+ * @param[out] size 原大小
+ * @return 原标记 (未跟踪为 HEAP_TAG_NONE)
+ */
+static HeapTag IRAM_ATTR untrack(void *ptr, size_t *size)
+{
+  HeapTag tag = HEAP_TAG_NONE;
+  portENTER_CRITICAL(&trackMux);
+  if (liveCount > 0)
+  {
+    uint16_t i = slotOf(ptr);
+    while (liveTable[i].ptr != nullptr && liveTable[i].ptr != ptr)
+      i = (i + 1) & (HEAP_TRACK_SLOTS - 1);
+
+    if (liveTable[i].ptr == ptr)
+    {
+      tag = (HeapTag)(liveTable[i].info & 0xFF);
+      *size = liveTable[i].info >> 8;
+      HeapTagStats &s = tagStats[tag];
+      s.frees++;
+      s.liveBlocks--;
+      s.liveBytes -= *size;
+      liveCount--;
+
+      // 后续同簇条目前移，保持探测链连续
+      uint16_t hole = i;
+      uint16_t j = i;
+      for (;;)
+      {
+        j = (j + 1) & (HEAP_TRACK_SLOTS - 1);
+        if (liveTable[j].ptr == nullptr)
+          break;
+        uint16_t home = slotOf(liveTable[j].ptr);
+        // home 不在 (hole, j] 区间内时可移到 hole
+        bool movable = hole <= j ? (home <= hole || home > j)
+                                 : (home <= hole && home > j);
+        if (movable)
+        {
+          liveTable[hole] = liveTable[j];
+          hole = j;
+        }
+      }
+      liveTable[hole].ptr = nullptr;
+    }
+  }
+  portEXIT_CRITICAL(&trackMux);
+  return tag;
+}
+
+// ==================================================================
+// 分配器包装 (-Wl,--wrap=...)
+// ==================================================================
+
+extern "C"
+{
+  void *__real_malloc(size_t size);
+  void __real_free(void *ptr);
+  void *__real_realloc(void *ptr, size_t size);
+  void *__real_calloc(size_t n, size_t size);
+
+  void *IRAM_ATTR __wrap_malloc(size_t size)
+  {
+    void *ptr = __real_malloc(size);
+    HeapTag tag = currentTag();
+    if (ptr && tag != HEAP_TAG_NONE)
+      track(ptr, size, tag);
+    return ptr;
+  }
+
+  void *IRAM_ATTR __wrap_calloc(size_t n, size_t size)
+  {
+    void *ptr = __real_calloc(n, size);
+    HeapTag tag = currentTag();
+    if (ptr && tag != HEAP_TAG_NONE)
+      track(ptr, n * size, tag);
+    return ptr;
+  }
+
+  void IRAM_ATTR __wrap_free(void *ptr)
+  {
+    // 先移出表再释放：释放后同一地址可能立即被其他任务重新分配
+    size_t size;
+    if (ptr)
+      untrack(ptr, &size);
+    __real_free(ptr);
+  }
+
+  void *IRAM_ATTR __wrap_realloc(void *ptr, size_t size)
+  {
+    // 扩容后的块沿用原块的归属；原块未跟踪时记到当前子系统
+    size_t oldSize = 0;
+    HeapTag tag = ptr ? untrack(ptr, &oldSize) : HEAP_TAG_NONE;
+    if (tag == HEAP_TAG_NONE)
+      tag = currentTag();
+    void *result = __real_realloc(ptr, size);
+    if (result && tag != HEAP_TAG_NONE)
+      track(result, size, tag);
+    else if (!result && ptr && size && oldSize)
+      track(ptr, oldSize, tag); // 失败时原块仍有效
+    return result;
+  }
+}
+
+// ==================================================================
+// 单例
+// ==================================================================
+
+HeapTelemetry_ &HeapTelemetry_::getInstance()
+{
+  static HeapTelemetry_ instance;
+  return instance;
+}
+
+HeapTelemetry_ &HeapTelemetry = HeapTelemetry_::getInstance();
+
+// ==================================================================
+// 标记
+// ==================================================================
+
+void HeapTelemetry_::begin()
+{
+  loopTask = xTaskGetCurrentTaskHandle();
+}
+
+HeapTag HeapTelemetry_::setTag(HeapTag tag)
+{
+  HeapTag prev = loopTag;
+  loopTag = tag;
+  return prev;
+}
+
+void HeapTelemetry_::tagTask(TaskHandle_t task, HeapTag tag)
+{
+  portENTER_CRITICAL(&trackMux);
+  int8_t freeSlot = -1;
+  for (uint8_t i = 0; i < HEAP_TAGGED_TASKS; i++)
+  {
+    if (taskTags[i].task == task)
+    {
+      freeSlot = i;
+      break;
+    }
+    if (freeSlot < 0 && taskTags[i].task == nullptr)
+      freeSlot = i;
+  }
+  if (freeSlot >= 0)
+  {
+    taskTags[freeSlot].task = tag == HEAP_TAG_NONE ? nullptr : task;
+    taskTags[freeSlot].tag = tag;
+  }
+  portEXIT_CRITICAL(&trackMux);
+}
+
+// ==================================================================
+// 采样
+// ==================================================================
+
+void HeapTelemetry_::tick()
+{
+  if (_sampled && millis() - _lastSample < HEAP_SAMPLE_INTERVAL_MS)
+    return;
+  _sampled = true;
+  _lastSample = millis();
+  _sample();
+}
+
+void HeapTelemetry_::_sample()
+{
+  HeapSample &s = _samples[_sampleHead];
+  s.uptimeS = millis() / 1000;
+  s.free = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+  s.largest = heap_caps_get_largest_free_block(MALLOC_CAP_8BIT);
+  s.minFree = heap_caps_get_minimum_free_size(MALLOC_CAP_8BIT);
+  if (s.largest < _minLargest)
+    _minLargest = s.largest;
+
+  _sampleHead = (_sampleHead + 1) % HEAP_SAMPLES;
+  if (_sampleCount < HEAP_SAMPLES)
+    _sampleCount++;
+}
+
+// ==================================================================
+// JSON 输出
+// ==================================================================
+
+void HeapTelemetry_::toJson(JsonObject out)
+{
+  uint32_t free = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+  uint32_t largest = heap_caps_get_largest_free_block(MALLOC_CAP_8BIT);
+  if (largest < _minLargest)
+    _minLargest = largest;
+
+  out["free"] = free;
+  out["largest"] = largest;
+  out["minFree"] = heap_caps_get_minimum_free_size(MALLOC_CAP_8BIT);
+  out["minLargest"] = _minLargest;
+  // 碎片率: 最大块占空闲的比例越低，碎片越严重
+  out["fragPct"] = free ? 100 - largest * 100 / free : 0;
+
+  HeapTagStats stats[HEAP_TAG_COUNT];
+  uint16_t tracked;
+  uint32_t overflow;
+  portENTER_CRITICAL(&trackMux);
+  memcpy(stats, tagStats, sizeof(stats));
+  tracked = liveCount;
+  overflow = trackOverflow;
+  portEXIT_CRITICAL(&trackMux);
+
+  out["trackedBlocks"] = tracked;
+  out["trackCapacity"] = HEAP_TRACK_MAX_LIVE;
+  out["trackOverflow"] = overflow;
+  JsonObject tags = out.createNestedObject("tags");
+  for (int i = HEAP_TAG_NONE + 1; i < HEAP_TAG_COUNT; i++)
+  {
+    JsonObject t = tags.createNestedObject(TAG_NAMES[i]);
+    t["live"] = stats[i].liveBytes;
+    t["peak"] = stats[i].peakBytes;
+    t["blocks"] = stats[i].liveBlocks;
+    t["allocs"] = stats[i].allocs;
+    t["frees"] = stats[i].frees;
+  }
+
+  // 采样环: [秒, 空闲, 最大块, 最低空闲]，最旧在前
+  JsonArray samples = out.createNestedArray("samples");
+  uint8_t oldest = (_sampleHead + HEAP_SAMPLES - _sampleCount) % HEAP_SAMPLES;
+  for (uint8_t i = 0; i < _sampleCount; i++)
+  {
+    const HeapSample &s = _samples[(oldest + i) % HEAP_SAMPLES];
+    JsonArray row = samples.createNestedArray();
+    row.add(s.uptimeS);
+    row.add(s.free);
+    row.add(s.largest);
+    row.add(s.minFree);
+  }
+}
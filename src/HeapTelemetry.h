@@ -0,0 +1,136 @@
+/**
+ * @file HeapTelemetry.h
+ * @brief 堆内存遥测 — 按子系统统计分配、定期采样空闲/最大块/历史最低
+ *
+ * 本文件定义：
+ *   - HeapTag 枚举: 分配归属的子系统 (Server, Weather, Display, Liveview, Logger)
+ *   - HeapTagStats 结构体: 单个子系统的分配计数与存活字节
+ *   - HeapSample 结构体: 一次堆采样
+ *   - HeapTelemetry_ 单例类: 子系统标记、采样环、JSON 输出
+ *   - HeapTagScope: 作用域内把主循环的分配记到指定子系统
+ *
+ * 分配钩子: platformio.ini 用 -Wl,--wrap=malloc/free/realloc/calloc 把所有
+ * malloc 系调用 (含 new、String、ArduinoJson、lwIP) 转到本模块的 __wrap_*，
+ * 再调用真正的分配器。不改变内存布局，未经包装的调用方 (ROM) 混用也安全。
+ *
+ * 归属: 主循环任务按当前 HeapTagScope 标记；后台任务 (天气) 用 tagTask()
+ * 整体标记。只有带标记的分配写入存活块表 (指针 → 大小/标记)，
+ * 释放时查表扣减，即可得到各子系统当前占用的字节数。
+ * 未标记的分配 (WiFi 驱动等) 只参与整体采样。
+ *
+ * 长时间运行后最大空闲块缩小 (碎片化) 时，可对照各子系统的存活字节
+ * 与峰值找出长期占用堆的模块。
+ */
+
+#ifndef HEAP_TELEMETRY_H
+#define HEAP_TELEMETRY_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+
+/// 存活块表大小 (2 的幂)
+#define HEAP_TRACK_SLOTS 512
+
+/// 最多跟踪的存活块数 (负载 3/4)：每次 free() 都在临界区内查表，
+/// 未跟踪的指针要探测到空槽为止，负载上限使平均探测约 8.5 次
+#define HEAP_TRACK_MAX_LIVE (HEAP_TRACK_SLOTS * 3 / 4)
+
+/// 采样间隔 (毫秒)
+#define HEAP_SAMPLE_INTERVAL_MS 120000UL
+
+/// 采样环大小 (30 × 2 分钟 = 最近 1 小时)
+#define HEAP_SAMPLES 30
+
+/// 可标记的后台任务数
+#define HEAP_TAGGED_TASKS 4
+
+// ==================================================================
+// 子系统标记
+// ==================================================================
+
+/// 分配归属 (顺序即 JSON 输出顺序)
+enum HeapTag : uint8_t
+{
+  HEAP_TAG_NONE = 0, ///< 未标记 (不跟踪)
+  HEAP_TAG_SERVER,   ///< WebSocket / HTTP API / MQTT
+  HEAP_TAG_WEATHER,  ///< 天气后台任务
+  HEAP_TAG_DISPLAY,  ///< 显示引擎与应用
+  HEAP_TAG_LIVEVIEW, ///< Liveview 推送
+  HEAP_TAG_LOGGER,   ///< 日志 (串口驱动)
+  HEAP_TAG_COUNT
+};
+
+/// 单个子系统的分配统计
+struct HeapTagStats
+{
+  uint32_t allocs;    ///< 分配次数
+  uint32_t frees;     ///< 释放次数
+  uint32_t liveBytes; ///< 当前存活字节
+  uint32_t peakBytes; ///< 存活字节峰值
+  uint16_t liveBlocks; ///< 当前存活块数
+};
+
+/// 一次堆采样
+struct HeapSample
+{
+  uint32_t uptimeS; ///< 采样时间 (秒)
+  uint32_t free;    ///< 空闲字节
+  uint32_t largest; ///< 最大空闲块
+  uint32_t minFree; ///< 启动以来最低空闲
+};
+
+// ==================================================================
+// 遥测类
+// ==================================================================
+
+/**
+ * @class HeapTelemetry_
+ * @brief 堆内存遥测
+ */
+class HeapTelemetry_
+{
+public:
+  static HeapTelemetry_ &getInstance();
+
+  /// setup() 最开始调用 (在主循环任务中)：开始跟踪主循环任务的分配
+  void begin();
+
+  /// 主循环调用：按间隔采样
+  void tick();
+
+  /**
+   * @brief 设置主循环任务的当前标记 (仅主循环任务调用)
+   * @return 之前的标记
+   */
+  HeapTag setTag(HeapTag tag);
+
+  /// 把某个后台任务的全部分配记到指定子系统 (HEAP_TAG_NONE=取消)
+  void tagTask(TaskHandle_t task, HeapTag tag);
+
+  /// 完整报告: 当前值、各子系统统计、采样环
+  void toJson(JsonObject out);
+
+private:
+  HeapTelemetry_() = default;
+
+  void _sample();
+
+  HeapSample _samples[HEAP_SAMPLES];
+  uint8_t _sampleHead = 0;
+  uint8_t _sampleCount = 0;
+  unsigned long _lastSample = 0;
+  bool _sampled = false;
+  uint32_t _minLargest = 0xFFFFFFFF; ///< 启动以来最小的 "最大空闲块"
+};
+
+extern HeapTelemetry_ &HeapTelemetry;
+
+/// 作用域内把主循环任务的分配记到指定子系统 (可嵌套)
+struct HeapTagScope
+{
+  HeapTag prev;
+  HeapTagScope(HeapTag tag) : prev(HeapTelemetry.setTag(tag)) {}
+  ~HeapTagScope() { HeapTelemetry.setTag(prev); }
+};
+
+#endif
@@ -0,0 +1,386 @@
+/**
+ * @file HttpApi.cpp
+ * @brief STA 模式 HTTP JSON API 实现
+ *
+ * 本文件实现：
+ *   - 非阻塞的 HTTP/1.1 请求解析 (固定缓冲区，支持流水线/keep-alive)
+ *   - 路由到 ServerManager 的命令处理 (与 WebSocket 完全一致)
+ *   - 连接槽管理 (空闲超时、最大请求数、满载 503)
+ */
+
+#include "HttpApi.h"
+#include "HeapTelemetry.h"
+#include "Logger.h"
+#include "ServerManager.h"
+#include "WebConfigManager.h"
+#include <ArduinoJson.h>
+
+// ==================================================================
+// 单例
+// ==================================================================
+
+HttpApi_ &HttpApi_::getInstance()
+{
+  static HttpApi_ instance;
+  return instance;
+}
+
+HttpApi_ &HttpApi = HttpApi_::getInstance();
+
+// ==================================================================
+// 辅助函数
+// ==================================================================
+
+/// HTTP 状态码 → 原因短语
+static const char *statusText(int status)
+{
+  switch (status)
+  {
+  case 200:
+    return "OK";
+  case 204:
+    return "No Content";
+  case 400:
+    return "Bad Request";
+  case 404:
+    return "Not Found";
+  case 405:
+    return "Method Not Allowed";
+  case 413:
+    return "Payload Too Large";
+  case 503:
+    return "Service Unavailable";
+  default:
+    return "Error";
+  }
+}
+
+/**
+ * @brief 在请求头中查找指定字段 (不区分大小写)
+ * @param headers 请求头起始 (请求行之后)
+ * @param end 请求头结束位置
+ * @param name 字段名 (不含冒号)
+ * @param out 输出缓冲区
+ * @param outLen 输出缓冲区大小
+ * @return true=找到
+ */
+static bool findHeader(const char *headers, const char *end, const char *name,
+                       char *out, size_t outLen)
+{
+  size_t nameLen = strlen(name);
+  const char *line = headers;
+  while (line < end)
+  {
+    const char *eol = strstr(line, "\r\n");
+    if (!eol || eol > end)
+      eol = end;
+
+    if ((size_t)(eol - line) > nameLen && line[nameLen] == ':' &&
+        strncasecmp(line, name, nameLen) == 0)
+    {
+      const char *v = line + nameLen + 1;
+      while (v < eol && *v == ' ')
+        v++;
+      size_t n = eol - v;
+      if (n >= outLen)
+        n = outLen - 1;
+      memcpy(out, v, n);
+      out[n] = '\0';
+      return true;
+    }
+    line = eol + 2;
+  }
+  return false;
+}
+
+// ==================================================================
+// 生命周期
+// ==================================================================
+
+void HttpApi_::begin()
+{
+  HeapTagScope heapTag(HEAP_TAG_SERVER);
+  if (_server)
+    return;
+
+  _server = new WiFiServer(HTTP_API_PORT);
+  _server->begin();
+  _server->setNoDelay(true);
+  LOG_INFO("[HttpApi] HTTP API 已启动 (端口 %d)", HTTP_API_PORT);
+}
+
+void HttpApi_::stop()
+{
+  if (!_server)
+    return;
+
+  for (auto &slot : _slots)
+  {
+    if (slot.active)
+      _close(slot);
+  }
+  _server->stop();
+  delete _server;
+  _server = nullptr;
+  LOG_INFO("[HttpApi] HTTP API 已停止");
+}
+
+void HttpApi_::tick()
+{
+  HeapTagScope heapTag(HEAP_TAG_SERVER);
+  if (!_server)
+    return;
+
+  _accept();
+
+  for (auto &slot : _slots)
+  {
+    if (slot.active)
+      _poll(slot);
+  }
+}
+
+// ==================================================================
+// 连接管理
+// ==================================================================
+
+void HttpApi_::_accept()
+{
+  WiFiClient client = _server->available();
+  if (!client)
+    return;
+
+  for (auto &slot : _slots)
+  {
+    if (!slot.active)
+    {
+      slot.client = client;
+      slot.client.setNoDelay(true);
+      slot.active = true;
+      slot.len = 0;
+      slot.served = 0;
+      slot.lastActivity = millis();
+      return;
+    }
+  }
+
+  // 连接槽已满
+  static const char busy[] =
+      "HTTP/1.1 503 Service Unavailable\r\nContent-Length: 0\r\n"
+      "Connection: close\r\n\r\n";
+  client.write((const uint8_t *)busy, sizeof(busy) - 1);
+  client.stop();
+  LOG_WARN("[HttpApi] 连接数已满，拒绝新连接");
+}
+
+void HttpApi_::_close(Slot &slot)
+{
+  slot.client.stop();
+  slot.active = false;
+  slot.len = 0;
+}
+
+void HttpApi_::_poll(Slot &slot)
+{
+  // 读取已到达的数据 (不等待)
+  int avail = slot.client.available();
+  if (avail > 0)
+  {
+    size_t room = HTTP_API_BUFFER_SIZE - slot.len;
+    if (room == 0)
+    {
+      _sendResponse(slot, 413,
+                    "{\"type\":\"error\",\"ok\":false,\"message\":\"request too large\"}",
+                    false);
+      return;
+    }
+    int n = slot.client.read((uint8_t *)slot.buf + slot.len,
+                             min((size_t)avail, room));
+    if (n > 0)
+    {
+      slot.len += n;
+      slot.buf[slot.len] = '\0';
+      slot.lastActivity = millis();
+    }
+  }
+
+  // 处理缓冲区中所有完整的请求 (支持流水线)
+  while (slot.active && slot.len > 0 && _processRequest(slot))
+  {
+  }
+
+  if (!slot.active)
+    return;
+
+  if (!slot.client.connected() && slot.client.available() == 0)
+  {
+    _close(slot);
+  }
+  else if (millis() - slot.lastActivity > HTTP_API_KEEPALIVE_TIMEOUT)
+  {
+    _close(slot);
+  }
+}
+
+// ==================================================================
+// 请求解析
+// ==================================================================
+
+bool HttpApi_::_processRequest(Slot &slot)
+{
+  char *headerEnd = strstr(slot.buf, "\r\n\r\n");
+  if (!headerEnd)
+  {
+    if (slot.len >= HTTP_API_BUFFER_SIZE)
+    {
+      _sendResponse(slot, 413,
+                    "{\"type\":\"error\",\"ok\":false,\"message\":\"header too large\"}",
+                    false);
+    }
+    return false;
+  }
+  size_t headerLen = (headerEnd - slot.buf) + 4;
+
+  // --- 请求行: METHOD SP PATH SP VERSION ---
+  char method[8] = {0};
+  char path[64] = {0};
+  char *lineEnd = strstr(slot.buf, "\r\n");
+  char *sp1 = (char *)memchr(slot.buf, ' ', lineEnd - slot.buf);
+  char *sp2 = sp1 ? (char *)memchr(sp1 + 1, ' ', lineEnd - sp1 - 1) : nullptr;
+  if (!sp1 || !sp2 || (size_t)(sp1 - slot.buf) >= sizeof(method) ||
+      (size_t)(sp2 - sp1 - 1) >= sizeof(path))
+  {
+    _sendResponse(slot, 400,
+                  "{\"type\":\"error\",\"ok\":false,\"message\":\"bad request line\"}",
+                  false);
+    return false;
+  }
+  memcpy(method, slot.buf, sp1 - slot.buf);
+  memcpy(path, sp1 + 1, sp2 - sp1 - 1);
+  char *query = strchr(path, '?');
+  if (query)
+    *query = '\0';
+  bool http10 = strncmp(sp2 + 1, "HTTP/1.0", 8) == 0;
+
+  // --- 请求头 ---
+  char value[16];
+  size_t contentLength = 0;
+  if (findHeader(lineEnd + 2, headerEnd + 2, "Content-Length", value,
+                 sizeof(value)))
+  {
+    contentLength = strtoul(value, nullptr, 10);
+  }
+  bool keepAlive = !http10;
+  if (findHeader(lineEnd + 2, headerEnd + 2, "Connection", value,
+                 sizeof(value)))
+  {
+    if (strncasecmp(value, "close", 5) == 0)
+      keepAlive = false;
+    else if (strncasecmp(value, "keep-alive", 10) == 0)
+      keepAlive = true;
+  }
+
+  if (headerLen + contentLength > HTTP_API_BUFFER_SIZE)
+  {
+    _sendResponse(slot, 413,
+                  "{\"type\":\"error\",\"ok\":false,\"message\":\"body too large\"}",
+                  false);
+    return false;
+  }
+  if (slot.len < headerLen + contentLength)
+    return false; // 请求体尚未收全
+
+  // --- 处理 ---
+  String response;
+  int status = _route(method, path, slot.buf + headerLen, contentLength,
+                      response);
+
+  slot.served++;
+  if (slot.served >= HTTP_API_KEEPALIVE_MAX)
+    keepAlive = false;
+  _sendResponse(slot, status, response, keepAlive);
+  if (!slot.active)
+    return false;
+
+  // 移除已处理的请求，保留流水线中的后续数据
+  size_t consumed = headerLen + contentLength;
+  memmove(slot.buf, slot.buf + consumed, slot.len - consumed);
+  slot.len -= consumed;
+  slot.buf[slot.len] = '\0';
+  return true;
+}
+
+// ==================================================================
+// 路由
+// ==================================================================
+
+int HttpApi_::_route(const char *method, const char *path, const char *body,
+                     size_t bodyLen, String &response)
+{
+  bool isGet = strcmp(method, "GET") == 0;
+  bool isPost = strcmp(method, "POST") == 0;
+
+  if (strcmp(method, "OPTIONS") == 0)
+    return 204; // CORS 预检
+
+  if (strcmp(path, "/api/stats") == 0 && isGet)
+  {
+    response = ServerManager.buildStatsJson();
+    return 200;
+  }
+  if (strcmp(path, "/api/config") == 0 && isGet)
+  {
+    response = ServerManager.buildConfigJson();
+    return 200;
+  }
+  if (strcmp(path, "/status") == 0 && isGet)
+  {
+    DynamicJsonDocument doc(2048);
+    WebConfigManager.buildStatusJson(doc);
+    serializeJson(doc, response);
+    return 200;
+  }
+
+  if (strncmp(path, "/api/", 5) == 0)
+  {
+    if (!isPost)
+    {
+      response = "{\"type\":\"error\",\"ok\":false,\"message\":\"use POST\"}";
+      return 405;
+    }
+    const char *type = path + 5;
+    if (strcmp(type, "cmd") == 0)
+      type = nullptr; // 类型取自请求体
+    return ServerManager.handleExternalCommand(type, body, bodyLen, response);
+  }
+
+  response = "{\"type\":\"error\",\"ok\":false,\"message\":\"not found\"}";
+  return 404;
+}
+
+// ==================================================================
+// 响应
+// ==================================================================
+
+void HttpApi_::_sendResponse(Slot &slot, int status, const String &body,
+                             bool keepAlive)
+{
+  char header[256];
+  int n = snprintf(header, sizeof(header),
+                   "HTTP/1.1 %d %s\r\n"
+                   "Content-Type: application/json\r\n"
+                   "Content-Length: %u\r\n"
+                   "Access-Control-Allow-Origin: *\r\n"
+                   "Access-Control-Allow-Methods: GET, POST, OPTIONS\r\n"
+                   "Access-Control-Allow-Headers: Content-Type\r\n"
+                   "Connection: %s\r\n\r\n",
+                   status, statusText(status), (unsigned)body.length(),
+                   keepAlive ? "keep-alive" : "close");
+  slot.client.write((const uint8_t *)header, n);
+  if (body.length() > 0)
+    slot.client.write((const uint8_t *)body.c_str(), body.length());
+  slot.lastActivity = millis();
+
+  if (!keepAlive)
+    _close(slot);
+}
@@ -0,0 +1,112 @@
+/**
+ * @file HttpApi.h
+ * @brief STA 模式 HTTP JSON API — 与 WebSocket 共用命令处理
+ *
+ * 本文件定义：
+ *   - HttpApi_ 单例类: 端口 80 上的轻量 HTTP/1.1 服务器
+ *   - 固定数量的连接槽，每槽固定大小的请求缓冲区 (无堆分配)
+ *   - 支持 keep-alive，空闲超时后关闭
+ *
+ * 路由：
+ *   GET  /api/stats        → 同 WebSocket getStats
+ *   GET  /api/config       → 同 WebSocket getConfig
+ *   GET  /status           → 设备状态 (同 AP 配网模式的 /status)
+ *   POST /api/cmd          → 请求体即 WebSocket 命令 ({"type":"setBrightness","value":50})
+ *   POST /api/<type>       → 命令类型取自路径 (POST /api/setBrightness {"value":50})
+ *
+ * 端口 80 在 AP 配网模式下由 WebConfigManager 的 WebServer 使用，
+ * 因此仅在 STA 模式 (配网门户未激活) 下启动。
+ */
+
+#ifndef HTTP_API_H
+#define HTTP_API_H
+
+#include <Arduino.h>
+#include <WiFi.h>
+
+// ==================================================================
+// HTTP API 配置
+// ==================================================================
+
+/// HTTP API 端口
+#define HTTP_API_PORT 80
+
+/// 最大并发连接数 (超出时返回 503)
+#define HTTP_API_MAX_CLIENTS 3
+
+/// 单个请求 (请求行 + 头 + 体) 的最大字节数，超出返回 413
+#define HTTP_API_BUFFER_SIZE 1536
+
+/// keep-alive 空闲超时 (毫秒)
+#define HTTP_API_KEEPALIVE_TIMEOUT 5000
+
+/// 单个连接最多处理的请求数，之后关闭连接
+#define HTTP_API_KEEPALIVE_MAX 100
+
+// ==================================================================
+// HTTP API 类
+// ==================================================================
+
+/**
+ * @class HttpApi_
+ * @brief 轻量 HTTP JSON API 服务器
+ *
+ * 完全非阻塞：tick() 只读取已到达的数据，请求完整后才处理，
+ * 不会因为慢速客户端阻塞渲染循环。
+ */
+class HttpApi_
+{
+public:
+  static HttpApi_ &getInstance();
+
+  /// 启动监听 (重复调用无副作用)
+  void begin();
+
+  /// 停止监听并关闭所有连接 (在 AP 配网模式启动前调用，释放端口 80)
+  void stop();
+
+  /// 主循环 - 接受连接、读取请求、发送响应
+  void tick();
+
+  /// 是否正在监听
+  bool isRunning() const { return _server != nullptr; }
+
+private:
+  HttpApi_() {}
+
+  /// 连接槽
+  struct Slot
+  {
+    WiFiClient client;
+    bool active = false;
+    char buf[HTTP_API_BUFFER_SIZE + 1]; ///< 请求缓冲区 (+1 用于结尾 '\0')
+    uint16_t len = 0;                   ///< 已接收字节数
+    unsigned long lastActivity = 0;     ///< 上次收发数据的时间
+    uint8_t served = 0;                 ///< 本连接已处理的请求数
+  };
+
+  WiFiServer *_server = nullptr;
+  Slot _slots[HTTP_API_MAX_CLIENTS];
+
+  void _accept();
+  void _poll(Slot &slot);
+  void _close(Slot &slot);
+
+  /**
+   * @brief 尝试从缓冲区解析并处理一个完整请求
+   * @return true=已处理一个请求, false=请求尚不完整
+   */
+  bool _processRequest(Slot &slot);
+
+  /// 根据路由生成响应
+  int _route(const char *method, const char *path, const char *body,
+             size_t bodyLen, String &response);
+
+  /// 发送响应
+  void _sendResponse(Slot &slot, int status, const String &body,
+                     bool keepAlive);
+};
+
+extern HttpApi_ &HttpApi;
+
+#endif
@@ -0,0 +1,149 @@
+/**
+ * @file LedOutput.cpp
+ * @brief LED 输出实现 — 控制器注册、输出任务、传输统计
+ */
+
+#include "LedOutput.h"
+#include "Logger.h"
+#include "StackMonitor.h"
+
+static portMUX_TYPE outputMux = portMUX_INITIALIZER_UNLOCKED;
+
+// ==================================================================
+// 单例
+// ==================================================================
+
+LedOutput_ &LedOutput_::getInstance()
+{
+  static LedOutput_ instance;
+  return instance;
+}
+
+LedOutput_ &LedOutput = LedOutput_::getInstance();
+
+// ==================================================================
+// 初始化
+// ==================================================================
+
+void LedOutput_::begin(CRGB *renderLeds)
+{
+  _render = renderLeds;
+  FastLED.addLeds<WS2812B, MATRIX_PIN, GRB>(_tx, NUM_LEDS);
+
+#if LED_OUTPUT_ASYNC
+  _idle = xSemaphoreCreateBinary();
+  if (_idle)
+  {
+    xSemaphoreGive(_idle);
+    xTaskCreatePinnedToCore(_outputTask, "LedOut", LED_OUTPUT_STACK, this,
+                            LED_OUTPUT_PRIORITY, &_task, LED_OUTPUT_CORE);
+  }
+  if (_task)
+  {
+    StackMonitor.watch(_task, "LedOut", LED_OUTPUT_STACK);
+    LOG_INFO("[LedOut] 异步输出已启动 (核心 %d)", LED_OUTPUT_CORE);
+  }
+  else
+  {
+    LOG_WARN("[LedOut] 创建输出任务失败，改为同步输出");
+  }
+#endif
+}
+
+// ==================================================================
+// 输出
+// ==================================================================
+
+void LedOutput_::present()
+{
+  if (!_render)
+    return;
+
+  if (_task)
+  {
+    // 上一帧仍在发送时等待 (30 FPS 下传输远短于帧间隔，通常不等)
+    uint32_t start = micros();
+    xSemaphoreTake(_idle, portMAX_DELAY);
+    uint32_t waited = micros() - start;
+
+    for (uint16_t i = 0; i < NUM_LEDS; i++)
+      _tx[i] = _render[i];
+
+    portENTER_CRITICAL(&outputMux);
+    _waitUs += waited;
+    if (waited > _waitMaxUs)
+      _waitMaxUs = waited;
+    portEXIT_CRITICAL(&outputMux);
+
+    xTaskNotifyGive(_task);
+    return;
+  }
+
+  for (uint16_t i = 0; i < NUM_LEDS; i++)
+    _tx[i] = _render[i];
+  _transmit();
+}
+
+void LedOutput_::_outputTask(void *param)
+{
+  LedOutput_ *self = static_cast<LedOutput_ *>(param);
+  for (;;)
+  {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    self->_transmit();
+    xSemaphoreGive(self->_idle);
+  }
+}
+
+void LedOutput_::_transmit()
+{
+  uint32_t start = micros();
+  FastLED.show();
+  uint32_t elapsed = micros() - start;
+
+  portENTER_CRITICAL(&outputMux);
+  _frames++;
+  _lastUs = elapsed;
+  _sumUs += elapsed;
+  if (elapsed > _maxUs)
+    _maxUs = elapsed;
+  portEXIT_CRITICAL(&outputMux);
+}
+
+// ==================================================================
+// 统计
+// ==================================================================
+
+void LedOutput_::toJson(JsonObject out)
+{
+  portENTER_CRITICAL(&outputMux);
+  uint32_t frames = _frames, lastUs = _lastUs, maxUs = _maxUs;
+  uint64_t sumUs = _sumUs, waitUs = _waitUs;
+  uint32_t waitMaxUs = _waitMaxUs;
+  portEXIT_CRITICAL(&outputMux);
+
+  out["async"] = _task != nullptr;
+  out["frames"] = frames;
+  out["transferUs"] = lastUs;
+  out["transferAvgUs"] = frames ? (uint32_t)(sumUs / frames) : 0;
+  out["transferMaxUs"] = maxUs;
+  out["waitAvgUs"] = frames ? (uint32_t)(waitUs / frames) : 0;
+  out["waitMaxUs"] = waitMaxUs;
+  // 传输时间中与渲染重叠 (未阻塞主循环) 的比例；同步模式为 0
+  float overlap = 0.0f;
+  if (_task && sumUs > 0)
+    overlap = sumUs > waitUs ? (float)(sumUs - waitUs) * 100.0f / sumUs : 0.0f;
+  out["overlapPct"] = overlap;
+}
+
+void LedOutput_::resetStats()
+{
+  portENTER_CRITICAL(&outputMux);
+  _frames = 0;
+  _lastUs = 0;
+  _maxUs = 0;
+  _sumUs = 0;
+  _waitUs = 0;
+  _waitMaxUs = 0;
+  portEXIT_CRITICAL(&outputMux);
+}
@@ -0,0 +1,89 @@
+/**
+ * @file LedOutput.h
+ * @brief LED 输出 — 双缓冲，发送在独立任务中进行，与下一帧渲染重叠
+ *
+ * 本文件定义：
+ *   - LedOutput_ 单例类: 发送缓冲区、输出任务、传输耗时统计
+ *
+ * FastLED.show() 要等 256 个 LED 全部移出 (约 7.7 ms，30 FPS 时超过一帧的
+ * 20%) 才返回。这里把 FastLED 控制器绑定到单独的发送缓冲区：
+ * present() 等上一帧发送结束、把渲染缓冲区复制过去 (768 字节)，唤醒输出
+ * 任务后立即返回；输出任务在 LED_OUTPUT_CORE 上调用 FastLED.show()，
+ * 等待 RMT 传输期间让出 CPU。主循环随即渲染下一帧，与传输并行。
+ *
+ * 统计：每帧传输耗时 (最近/平均/最大)、present() 等待上一帧的时间、
+ * 重叠率 (传输时间中未阻塞主循环的比例)。
+ *
+ * LED_OUTPUT_ASYNC 设为 0 时 present() 直接调用 FastLED.show() (同步，
+ * 仍统计传输耗时)，用于对比或排查时序问题。
+ */
+
+#ifndef LED_OUTPUT_H
+#define LED_OUTPUT_H
+
+#include "Globals.h"
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <FastLED.h>
+
+/// 异步输出 (0=在主循环中同步发送)
+#ifndef LED_OUTPUT_ASYNC
+#define LED_OUTPUT_ASYNC 1
+#endif
+
+/// 输出任务所在核心 (主循环在核心 1)
+#define LED_OUTPUT_CORE 0
+
+/// 输出任务优先级
+#define LED_OUTPUT_PRIORITY 2
+
+/// 输出任务栈大小 (字节)
+#define LED_OUTPUT_STACK 2048
+
+/**
+ * @class LedOutput_
+ * @brief 双缓冲 LED 输出
+ */
+class LedOutput_
+{
+public:
+  static LedOutput_ &getInstance();
+
+  /**
+   * @brief 注册 LED 控制器并启动输出任务
+   * @param renderLeds 渲染缓冲区 (绘制目标，present() 从这里复制)
+   */
+  void begin(CRGB *renderLeds);
+
+  /// 提交当前渲染缓冲区 (异步模式下不等待传输结束)
+  void present();
+
+  /// 统计: 帧数、传输耗时、等待时间、重叠率
+  void toJson(JsonObject out);
+
+  /// 清空统计
+  void resetStats();
+
+private:
+  LedOutput_() = default;
+
+  static void _outputTask(void *param);
+  void _transmit();
+
+  CRGB *_render = nullptr;
+  CRGB _tx[NUM_LEDS]; ///< 发送缓冲区 (FastLED 控制器绑定在这里)
+  TaskHandle_t _task = nullptr;
+  SemaphoreHandle_t _idle = nullptr; ///< 输出任务空闲时可取
+
+  // 统计 (传输耗时由输出任务写，读写都在 outputMux 临界区内)
+  uint32_t _frames = 0;
+  uint32_t _lastUs = 0;
+  uint32_t _maxUs = 0;
+  uint64_t _sumUs = 0;
+  uint64_t _waitUs = 0;    ///< present() 等待上一帧的总时间
+  uint32_t _waitMaxUs = 0; ///< 单次最长等待
+};
+
+extern LedOutput_ &LedOutput;
+
+#endif
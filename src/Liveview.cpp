@@ -15,6 +15,7 @@
  */
 
 #include "Liveview.h"
+#include "HeapTelemetry.h"
 
 // ==================================================================
 // 前缀常量
@@ -168,6 +169,7 @@ void Liveview_::tick() {
  * 此时 TCP 缓冲区最宽裕，阻塞概率最低。
  */
 void Liveview_::flush() {
+  HeapTagScope heapTag(HEAP_TAG_LIVEVIEW);
   if (!_dirty || _callback == nullptr)
     return;
 
@@ -69,6 +69,8 @@ private:
   size_t _bufLen = 0;
 
   uint32_t _crc32(const byte *data, size_t length);
+
+  friend class Benchmark_; ///< 微基准测试直接测量 _crc32
 };
 
 extern Liveview_ &Liveview;
@@ -4,6 +4,7 @@
  */
 
 #include "Logger.h"
+#include "HeapTelemetry.h"
 
 // ==================================================================
 // 私有变量
@@ -17,6 +18,7 @@ static LogLevel _currentLevel = LOG_LEVEL_INFO;
 
 void Logger_Init()
 {
+  HeapTagScope heapTag(HEAP_TAG_LOGGER); // 串口驱动缓冲区
 #if LOG_TO_SERIAL
   Serial.begin(115200);
   delay(100);  // 等待 Serial 就绪
@@ -0,0 +1,321 @@
+/**
+ * @file LoopWatchdog.cpp
+ * @brief 主循环延迟看门狗实现 — 阶段栈、预算检查、RTC 记录环、监视任务
+ */
+
+#include "LoopWatchdog.h"
+#include "Logger.h"
+#include "StackMonitor.h"
+#include <esp_system.h>
+
+/// 结构版本 ("LWD" + 版本号)，LatencyLog 布局变化时递增
+#define LATENCY_LOG_MAGIC 0x4C574401
+
+/// 阶段名称与预算 (与 LoopStage 顺序一致)
+static const struct
+{
+  const char *name;
+  uint32_t budgetUs;
+} STAGES[LOOP_STAGE_COUNT] = {
+    {"loop", 100000},       // 整个循环
+    {"boot", 500000},       // 单个启动步骤 (含 LittleFS 挂载等)
+    {"network", 20000},     // 配网门户 / DNS / 重连
+    {"display", 15000},     // 渲染一帧 (不含频谱采样)
+    {"liveview", 5000},     // 采样 + 发送
+    {"periphery", 30000},   // DHT22 读取约 25ms
+    {"apps", 5000},         // 自定义应用过期、计时时间轮
+    {"server", 20000},      // ws->loop() (不含命令执行)
+    {"http", 20000},        // HTTP API
+    {"mqtt", 20000},        // MQTT
+    {"ota", 5000},          // OTA 轮询
+    {"command", 30000},     // 单条命令 (不含 NVS 写入)
+    {"nvs", 50000},         // saveSettings()
+    {"wifiScan", 3000000},  // 阻塞式 WiFi 扫描
+    {"spectrum", 70000}};   // 512 点采样 (51ms) + FFT
+
+/// 记录环，软复位后保留
+RTC_NOINIT_ATTR static LatencyLog rtcLog;
+
+/// 阶段栈与记录环在主循环和监视任务之间共享
+static portMUX_TYPE wdtMux = portMUX_INITIALIZER_UNLOCKED;
+
+// ==================================================================
+// 单例
+// ==================================================================
+
+LoopWatchdog_ &LoopWatchdog_::getInstance()
+{
+  static LoopWatchdog_ instance;
+  return instance;
+}
+
+LoopWatchdog_ &LoopWatchdog = LoopWatchdog_::getInstance();
+
+// ==================================================================
+// 启动
+// ==================================================================
+
+void LoopWatchdog_::begin()
+{
+  esp_reset_reason_t reason = esp_reset_reason();
+  _resetReason = reason;
+
+  if (rtcLog.magic != LATENCY_LOG_MAGIC || reason == ESP_RST_POWERON ||
+      reason == ESP_RST_BROWNOUT || rtcLog.head >= LOOP_WDT_RECORDS ||
+      rtcLog.count > LOOP_WDT_RECORDS)
+  {
+    memset(&rtcLog, 0, sizeof(rtcLog));
+    rtcLog.magic = LATENCY_LOG_MAGIC;
+  }
+  else
+  {
+    // 上一次启动中仍在进行的阶段：复位发生在它结束之前
+    uint16_t resets = 0;
+    for (uint8_t i = 0; i < rtcLog.count; i++)
+    {
+      LatencyRecord &rec = rtcLog.records[i];
+      if (rec.boot == rtcLog.boot && (rec.flags & LATENCY_IN_PROGRESS))
+      {
+        rec.flags |= LATENCY_RESET;
+        resets++;
+      }
+    }
+    if (resets > 0)
+      LOG_WARN("[LoopWdt] 上次复位 (原因 %d) 时有 %u 个阶段未结束",
+               (int)reason, resets);
+  }
+
+  rtcLog.boot++;
+  _reportedSeq = rtcLog.seq;
+
+  TaskHandle_t task = nullptr;
+  xTaskCreatePinnedToCore(_watchTask, "LoopWdt", LOOP_WDT_STACK, this, 1,
+                          &task, 0);
+  StackMonitor.watch(task, "LoopWdt", LOOP_WDT_STACK);
+  LOG_INFO("[LoopWdt] 已启动，保留记录 %u 条", rtcLog.count);
+}
+
+// ==================================================================
+// 阶段计时
+// ==================================================================
+
+void LoopWatchdog_::stageBegin(LoopStage stage, const char *context)
+{
+  portENTER_CRITICAL(&wdtMux);
+  if (_depth < LOOP_WDT_DEPTH)
+  {
+    Frame &f = _stack[_depth];
+    f.stage = stage;
+    f.startUs = micros();
+    f.childUs = 0;
+    f.recordSeq = 0;
+    f.context = context;
+  }
+  _depth++;
+  portEXIT_CRITICAL(&wdtMux);
+}
+
+void LoopWatchdog_::stageEnd(LoopStage stage)
+{
+  uint32_t now = micros();
+  bool violated = false;
+  uint32_t selfUs = 0;
+
+  portENTER_CRITICAL(&wdtMux);
+  if (_depth == 0)
+  {
+    portEXIT_CRITICAL(&wdtMux);
+    return;
+  }
+  _depth--;
+  if (_depth >= LOOP_WDT_DEPTH || _stack[_depth].stage != stage)
+  {
+    // 超出嵌套深度或 begin/end 不配对：不统计
+    portEXIT_CRITICAL(&wdtMux);
+    return;
+  }
+
+  Frame &f = _stack[_depth];
+  uint32_t totalUs = now - f.startUs;
+  if (_depth > 0)
+    _stack[_depth - 1].childUs += totalUs;
+
+  // 整个循环按总耗时，其余阶段按自身耗时 (扣除子阶段)
+  selfUs = stage == LOOP_STAGE_LOOP ? totalUs : totalUs - f.childUs;
+  if (selfUs > _maxUs[stage])
+    _maxUs[stage] = selfUs;
+
+  if (selfUs > STAGES[stage].budgetUs)
+  {
+    violated = true;
+    _violations[stage]++;
+    LatencyRecord *rec = f.recordSeq ? _find(f.recordSeq) : nullptr;
+    if (rec)
+    {
+      // 监视任务已记录：补全最终耗时
+      rec->durationUs = selfUs;
+      rec->flags &= ~LATENCY_IN_PROGRESS;
+      rtcLog.seq++;
+      rec->seq = rtcLog.seq;
+    }
+    else
+    {
+      _record(f, selfUs, 0);
+    }
+  }
+  portEXIT_CRITICAL(&wdtMux);
+
+  if (violated)
+    LOG_WARN("[LoopWdt] %s 超时: %lu us (预算 %lu us)", STAGES[stage].name,
+             (unsigned long)selfUs, (unsigned long)STAGES[stage].budgetUs);
+}
+
+// ==================================================================
+// 记录环
+// ==================================================================
+
+/// 追加一条记录 (调用方持有 wdtMux)，返回序号
+uint32_t LoopWatchdog_::_record(const Frame &frame, uint32_t durationUs,
+                                uint8_t flags)
+{
+  LatencyRecord &rec = rtcLog.records[rtcLog.head];
+  rec.seq = ++rtcLog.seq;
+  rec.uptimeMs = millis() - (micros() - frame.startUs) / 1000;
+  rec.durationUs = durationUs;
+  rec.budgetUs = STAGES[frame.stage].budgetUs;
+  rec.boot = rtcLog.boot;
+  rec.stage = frame.stage;
+  rec.flags = flags;
+  memset(rec.context, 0, sizeof(rec.context));
+  if (frame.context)
+    strncpy(rec.context, frame.context, sizeof(rec.context) - 1);
+
+  rtcLog.head = (rtcLog.head + 1) % LOOP_WDT_RECORDS;
+  if (rtcLog.count < LOOP_WDT_RECORDS)
+    rtcLog.count++;
+  return rec.seq;
+}
+
+LatencyRecord *LoopWatchdog_::_find(uint32_t seq)
+{
+  for (uint8_t i = 0; i < rtcLog.count; i++)
+  {
+    if (rtcLog.records[i].seq == seq)
+      return &rtcLog.records[i];
+  }
+  return nullptr;
+}
+
+// ==================================================================
+// 监视任务
+// ==================================================================
+
+void LoopWatchdog_::_watchTask(void *param)
+{
+  LoopWatchdog_ *self = static_cast<LoopWatchdog_ *>(param);
+  for (;;)
+  {
+    vTaskDelay(LOOP_WDT_POLL_MS / portTICK_PERIOD_MS);
+    self->_poll();
+  }
+}
+
+/**
+ * @brief 检查最内层正在执行的阶段
+ *
+ * 超过预算仍未结束时写入进行中记录 (每个阶段实例只写一次)。
+ * 阶段卡死直到任务看门狗复位时，这条记录就是现场。
+ */
+void LoopWatchdog_::_poll()
+{
+  portENTER_CRITICAL(&wdtMux);
+  if (_depth > 0 && _depth <= LOOP_WDT_DEPTH)
+  {
+    Frame &f = _stack[_depth - 1];
+    uint32_t elapsed = micros() - f.startUs;
+    if (f.stage != LOOP_STAGE_LOOP)
+      elapsed -= f.childUs;
+    if (f.recordSeq == 0 && elapsed > STAGES[f.stage].budgetUs)
+      f.recordSeq = _record(f, elapsed, LATENCY_IN_PROGRESS);
+  }
+  portEXIT_CRITICAL(&wdtMux);
+}
+
+// ==================================================================
+// 报告
+// ==================================================================
+
+bool LoopWatchdog_::hasUnreported() const { return _reportedSeq != rtcLog.seq; }
+
+void LoopWatchdog_::_recordToJson(const LatencyRecord &rec, JsonObject out)
+{
+  out["seq"] = rec.seq;
+  out["stage"] = rec.stage < LOOP_STAGE_COUNT ? STAGES[rec.stage].name : "?";
+  out["us"] = rec.durationUs;
+  out["budgetUs"] = rec.budgetUs;
+  out["at"] = rec.uptimeMs;
+  out["boot"] = rec.boot;
+  if (rec.context[0])
+    out["context"] = (char *)rec.context; // char* 让 ArduinoJson 复制 (rec 为临时副本)
+  if (rec.flags & LATENCY_RESET)
+    out["reset"] = true;
+  else if (rec.flags & LATENCY_IN_PROGRESS)
+    out["inProgress"] = true;
+}
+
+void LoopWatchdog_::takeUnreported(JsonArray out)
+{
+  LatencyRecord copy[LOOP_WDT_RECORDS];
+  uint8_t n = 0;
+
+  portENTER_CRITICAL(&wdtMux);
+  uint32_t from = _reportedSeq;
+  for (uint8_t i = 0; i < rtcLog.count; i++)
+  {
+    if (rtcLog.records[i].seq > from)
+      copy[n++] = rtcLog.records[i];
+  }
+  _reportedSeq = rtcLog.seq;
+  portEXIT_CRITICAL(&wdtMux);
+
+  for (uint8_t i = 0; i < n; i++)
+    _recordToJson(copy[i], out.createNestedObject());
+}
+
+void LoopWatchdog_::toJson(JsonObject out)
+{
+  LatencyLog log;
+  portENTER_CRITICAL(&wdtMux);
+  log = rtcLog;
+  portEXIT_CRITICAL(&wdtMux);
+
+  out["resetReason"] = _resetReason;
+  out["boot"] = log.boot;
+
+  JsonObject stages = out.createNestedObject("stages");
+  for (int i = 0; i < LOOP_STAGE_COUNT; i++)
+  {
+    JsonObject s = stages.createNestedObject(STAGES[i].name);
+    s["budgetUs"] = STAGES[i].budgetUs;
+    s["maxUs"] = _maxUs[i];
+    s["violations"] = _violations[i];
+  }
+
+  // 按时间顺序输出 (最旧在前)
+  JsonArray records = out.createNestedArray("records");
+  uint8_t oldest = (log.head + LOOP_WDT_RECORDS - log.count) % LOOP_WDT_RECORDS;
+  for (uint8_t i = 0; i < log.count; i++)
+    _recordToJson(log.records[(oldest + i) % LOOP_WDT_RECORDS],
+                  records.createNestedObject());
+}
+
+void LoopWatchdog_::reset()
+{
+  portENTER_CRITICAL(&wdtMux);
+  rtcLog.head = 0;
+  rtcLog.count = 0;
+  _reportedSeq = rtcLog.seq;
+  memset(_maxUs, 0, sizeof(_maxUs));
+  memset(_violations, 0, sizeof(_violations));
+  portEXIT_CRITICAL(&wdtMux);
+}
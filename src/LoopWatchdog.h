@@ -0,0 +1,187 @@
+/**
+ * @file LoopWatchdog.h
+ * @brief 主循环延迟看门狗 — 分阶段耗时预算、超时记录 (RTC 内存)、WebSocket 上报
+ *
+ * 本文件定义：
+ *   - LoopStage 枚举: 主循环各阶段及可能阻塞的子阶段 (NVS 写入、WiFi 扫描、频谱采样等)
+ *   - LatencyRecord 结构体: 一次超时记录
+ *   - LoopWatchdog_ 单例类: 阶段计时、超时检测、记录环与统计
+ *
+ * 用法：
+ *   LoopWatchdog.stageBegin(LOOP_STAGE_DISPLAY);
+ *   DisplayManager.tick();
+ *   LoopWatchdog.stageEnd(LOOP_STAGE_DISPLAY);
+ *
+ *   LoopStageScope scope(LOOP_STAGE_NVS);   // 或按作用域计时
+ *
+ * 阶段可嵌套，子阶段的耗时从父阶段中扣除 (父阶段按自身耗时检查预算)；
+ * 整个循环 (LOOP_STAGE_LOOP) 按总耗时检查。
+ *
+ * 记录环放在 RTC_NOINIT 内存中，软件复位、panic、看门狗复位后仍保留，
+ * 上电复位时清空。后台监视任务每 LOOP_WDT_POLL_MS 检查一次正在执行的阶段，
+ * 超过预算时立即写入一条 "进行中" 记录 —— 即使该阶段最终触发任务看门狗复位，
+ * 重启后也能看到是哪个阶段卡住。
+ */
+
+#ifndef LOOP_WATCHDOG_H
+#define LOOP_WATCHDOG_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+
+/// 记录环大小
+#define LOOP_WDT_RECORDS 16
+
+/// 监视任务检查间隔 (毫秒)
+#define LOOP_WDT_POLL_MS 50
+
+/// 监视任务栈大小 (字节)
+#define LOOP_WDT_STACK 2048
+
+/// 最大嵌套深度
+#define LOOP_WDT_DEPTH 4
+
+/// 上下文字符串长度 (含结尾 '\0')
+#define LOOP_WDT_CONTEXT_LEN 16
+
+// ==================================================================
+// 阶段
+// ==================================================================
+
+/// 受监视的阶段 (顺序即 JSON 输出顺序)
+enum LoopStage : uint8_t
+{
+  LOOP_STAGE_LOOP = 0,  ///< 整个 loop() (总耗时)
+  LOOP_STAGE_BOOT,      ///< bootStep()
+  LOOP_STAGE_NETWORK,   ///< WebConfigManager.tick()
+  LOOP_STAGE_DISPLAY,   ///< ClockService + DisplayManager.tick()
+  LOOP_STAGE_LIVEVIEW,  ///< Liveview.tick() + flush()
+  LOOP_STAGE_PERIPHERY, ///< PeripheryManager.tick()
+  LOOP_STAGE_APPS,      ///< CustomApps / TimerManager.tick()
+  LOOP_STAGE_SERVER,    ///< ws->loop()
+  LOOP_STAGE_HTTP,      ///< HttpApi.tick()
+  LOOP_STAGE_MQTT,      ///< MqttManager.tick()
+  LOOP_STAGE_OTA,       ///< ArduinoOTA.handle()
+  LOOP_STAGE_COMMAND,   ///< dispatchCommand() (上下文 = 命令类型)
+  LOOP_STAGE_NVS,       ///< saveSettings()
+  LOOP_STAGE_WIFI_SCAN, ///< WiFi.scanNetworks()
+  LOOP_STAGE_SPECTRUM,  ///< 频谱采样 + FFT
+  LOOP_STAGE_COUNT
+};
+
+// ==================================================================
+// 超时记录
+// ==================================================================
+
+/// 记录标志
+#define LATENCY_IN_PROGRESS 0x01 ///< 监视任务发现时阶段尚未结束
+#define LATENCY_RESET 0x02       ///< 阶段未结束即发生复位
+
+/// 一次超时 (POD，保存在 RTC 内存)
+struct LatencyRecord
+{
+  uint32_t seq;                       ///< 全局序号 (跨复位递增)
+  uint32_t uptimeMs;                  ///< 阶段开始时的 millis()
+  uint32_t durationUs;                ///< 耗时 (进行中记录为发现时已耗时)
+  uint32_t budgetUs;                  ///< 预算
+  uint16_t boot;                      ///< 软复位计数 (区分不同次启动)
+  uint8_t stage;                      ///< LoopStage
+  uint8_t flags;                      ///< LATENCY_*
+  char context[LOOP_WDT_CONTEXT_LEN]; ///< 上下文 (命令类型等)
+};
+
+/// 记录环 (RTC 内存)
+struct LatencyLog
+{
+  uint32_t magic;
+  uint32_t seq; ///< 最后一条记录的序号
+  uint16_t boot;
+  uint8_t head; ///< 下一条写入位置
+  uint8_t count;
+  LatencyRecord records[LOOP_WDT_RECORDS];
+};
+
+// ==================================================================
+// 看门狗类
+// ==================================================================
+
+/**
+ * @class LoopWatchdog_
+ * @brief 主循环延迟看门狗
+ */
+class LoopWatchdog_
+{
+public:
+  static LoopWatchdog_ &getInstance();
+
+  /// setup() 开始时调用：恢复 RTC 记录环、启动监视任务
+  void begin();
+
+  /**
+   * @brief 阶段开始
+   * @param stage 阶段
+   * @param context 上下文 (须在阶段结束前保持有效，nullptr=无)
+   */
+  void stageBegin(LoopStage stage, const char *context = nullptr);
+
+  /// 阶段结束：统计耗时，超出预算时写入记录
+  void stageEnd(LoopStage stage);
+
+  /// 是否有尚未推送的新记录
+  bool hasUnreported() const;
+
+  /**
+   * @brief 输出尚未推送的记录并标记为已推送
+   * @param out 目标数组
+   */
+  void takeUnreported(JsonArray out);
+
+  /// 完整报告: 复位原因、各阶段预算/最大值/超时次数、记录环
+  void toJson(JsonObject out);
+
+  /// 清空记录环与统计
+  void reset();
+
+private:
+  LoopWatchdog_() = default;
+
+  /// 嵌套栈帧
+  struct Frame
+  {
+    uint8_t stage;
+    uint32_t startUs;
+    uint32_t childUs;      ///< 子阶段总耗时
+    uint32_t recordSeq;    ///< 监视任务已写入的进行中记录 (0=无)
+    const char *context;
+  };
+
+  static void _watchTask(void *param);
+  void _poll();
+  uint32_t _record(const Frame &frame, uint32_t durationUs, uint8_t flags);
+  LatencyRecord *_find(uint32_t seq);
+  static void _recordToJson(const LatencyRecord &rec, JsonObject out);
+
+  Frame _stack[LOOP_WDT_DEPTH];
+  uint8_t _depth = 0;
+  uint8_t _resetReason = 0;
+  uint32_t _reportedSeq = 0;
+
+  // 本次启动的统计
+  uint32_t _maxUs[LOOP_STAGE_COUNT] = {};
+  uint32_t _violations[LOOP_STAGE_COUNT] = {};
+};
+
+extern LoopWatchdog_ &LoopWatchdog;
+
+/// 作用域内计时 (函数有多个返回点时使用)
+struct LoopStageScope
+{
+  LoopStage stage;
+  LoopStageScope(LoopStage s, const char *context = nullptr) : stage(s)
+  {
+    LoopWatchdog.stageBegin(s, context);
+  }
+  ~LoopStageScope() { LoopWatchdog.stageEnd(stage); }
+};
+
+#endif
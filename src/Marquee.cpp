@@ -0,0 +1,286 @@
+/**
+ * @file Marquee.cpp
+ * @brief 滚动文字引擎实现 — 字形展开为列位图、窗口拷贝绘制
+ */
+
+#include "Marquee.h"
+#include "AwtrixFont.h"
+#include "ColorDraw.h"
+#include "GlyphCache.h"
+#include "Globals.h"
+#include "Tools.h"
+
+/// 字体基线 (与 MatrixDisplayUi 中 setCursor(x, 6) 一致)
+static const int8_t FONT_BASELINE = 6;
+
+static const uint16_t FONT_GLYPH_COUNT =
+    sizeof(AwtrixFontGlyphs) / sizeof(AwtrixFontGlyphs[0]);
+
+// ==================================================================
+// 排版
+// ==================================================================
+
+void Marquee::clear()
+{
+  memset(columns, 0, sizeof(columns));
+  runCount = 0;
+  width = 0;
+  scroll = false;
+  textX = 0;
+  if (speed == 0)
+    speed = MARQUEE_DEFAULT_SPEED << 8;
+}
+
+/// 把一个字形的像素写入从 x 开始的列
+static void renderGlyph(uint8_t *columns, uint16_t x, uint8_t ch,
+                        uint8_t advance)
+{
+  if (ch < AwtrixFont.first || ch - AwtrixFont.first >= FONT_GLYPH_COUNT)
+    return;
+
+  const GFXglyph *glyph = &AwtrixFontGlyphs[ch - AwtrixFont.first];
+  uint16_t offset = pgm_read_word(&glyph->bitmapOffset);
+  uint8_t w = pgm_read_byte(&glyph->width);
+  uint8_t h = pgm_read_byte(&glyph->height);
+  int8_t xo = pgm_read_byte(&glyph->xOffset);
+  int8_t yo = pgm_read_byte(&glyph->yOffset);
+
+  // 与 Adafruit_GFX::drawChar 相同：位图按行连续存放，高位在左
+  uint8_t bits = 0;
+  uint8_t bit = 0;
+  for (uint8_t yy = 0; yy < h; yy++)
+  {
+    int8_t row = FONT_BASELINE + yo + yy;
+    for (uint8_t xx = 0; xx < w; xx++)
+    {
+      if (!(bit++ & 7))
+        bits = pgm_read_byte(&AwtrixBitmaps[offset++]);
+      bool on = bits & 0x80;
+      bits <<= 1;
+
+      int16_t col = xo + xx;
+      if (on && col >= 0 && col < advance && row >= 0 && row < 8)
+        columns[x + col] |= 1 << row;
+    }
+  }
+}
+
+#if GLYPH_CJK_FONT
+/// 字库中没有的字符显示为方框
+static const uint8_t MISSING_GLYPH[] = {0x3E, 0x22, 0x3E, 0x00};
+
+/// 写入一个中文 (字库) 字形，返回字宽 (0=列数已满)
+static uint8_t renderWideGlyph(uint8_t *columns, uint16_t x, uint32_t codepoint)
+{
+  const CachedGlyph *glyph = GlyphCache.lookup(codepoint);
+  const uint8_t *bits = glyph ? glyph->columns : MISSING_GLYPH;
+  uint8_t advance = glyph ? glyph->advance : sizeof(MISSING_GLYPH);
+  if (x + advance > MARQUEE_MAX_COLUMNS)
+    return 0;
+  memcpy(columns + x, bits, advance);
+  return advance;
+}
+#endif
+
+void Marquee::append(const char *text, uint16_t color)
+{
+  if (runCount >= MARQUEE_MAX_RUNS)
+    return;
+  // 与上一段同色时合并
+  if (runCount == 0 || runs[runCount - 1].color != color)
+    runs[runCount++] = {width, color};
+
+  for (const char *p = text; *p; p++)
+  {
+    uint8_t lead = (uint8_t)*p;
+#if GLYPH_CJK_FONT
+    // 三/四字节 UTF-8 (中文等)：解码码点，从字库缓存取字形
+    // 欧元符号 (E2 82 AC) 在 AwtrixFont 中，仍走 utf8ascii
+    if (lead >= 0xE0 && !(lead == 0xE2 && (uint8_t)p[1] == 0x82))
+    {
+      uint8_t extra = lead >= 0xF0 ? 3 : 2;
+      uint32_t codepoint = lead & (lead >= 0xF0 ? 0x07 : 0x0F);
+      uint8_t n = 0;
+      while (n < extra && ((uint8_t)p[n + 1] & 0xC0) == 0x80)
+      {
+        codepoint = codepoint << 6 | ((uint8_t)p[n + 1] & 0x3F);
+        n++;
+      }
+      p += n;
+      if (n < extra)
+        continue; // 不完整的序列
+      uint8_t advance = renderWideGlyph(columns, width, codepoint);
+      if (advance == 0)
+        break;
+      width += advance;
+      continue;
+    }
+#endif
+
+    byte c = utf8ascii(lead);
+    if (c == 0)
+      continue;
+    c = toupper(c);
+
+    uint8_t advance = getCharWidth(c);
+    if (advance == 0)
+      advance = 4;
+    if (width + advance > MARQUEE_MAX_COLUMNS)
+      break;
+    renderGlyph(columns, width, c, advance);
+    width += advance;
+  }
+}
+
+void Marquee::appendJson(JsonVariantConst text, uint16_t color)
+{
+  if (text.is<JsonArrayConst>())
+  {
+    for (JsonVariantConst run : text.as<JsonArrayConst>())
+    {
+      if (run.is<const char *>())
+        append(run.as<const char *>(), color);
+      else
+        append(run["t"] | "",
+               run.containsKey("c") ? HEXtoColor(run["c"] | "") : color);
+    }
+  }
+  else
+  {
+    append(text | "", color);
+  }
+}
+
+void Marquee::reflow(int16_t areaX, uint8_t areaWidth)
+{
+  this->areaX = areaX;
+  this->areaWidth = areaWidth;
+  scroll = width > areaWidth;
+  textX = scroll ? 0 : (areaWidth - width) / 2;
+}
+
+void Marquee::layout(const char *text, uint16_t color, int16_t areaX,
+                     uint8_t areaWidth)
+{
+  clear();
+  append(text, color);
+  reflow(areaX, areaWidth);
+}
+
+void Marquee::setColor(uint16_t color)
+{
+  runs[0] = {0, color};
+  runCount = 1;
+}
+
+void Marquee::setSpeed(float pixelsPerSecond)
+{
+  uint32_t q8 = (uint32_t)(pixelsPerSecond * 256.0f);
+  speed = constrain(q8, 64, 0xFFFF); // 0.25 ~ 255 像素/秒
+}
+
+uint32_t Marquee::cycleMs() const
+{
+  return (uint32_t)(((uint64_t)(width + areaWidth) << 8) * 1000 / speed);
+}
+
+// ==================================================================
+// 绘制
+// ==================================================================
+
+/// RGB565 按权重缩放 (weight: 0~256)
+static inline uint16_t scale565(uint16_t color, uint16_t weight)
+{
+  uint16_t r = ((color >> 11) * weight) >> 8;
+  uint16_t g = (((color >> 5) & 0x3F) * weight) >> 8;
+  uint16_t b = ((color & 0x1F) * weight) >> 8;
+  return (r << 11) | (g << 5) | b;
+}
+
+/// 两个 RGB565 颜色相加 (各通道饱和)
+static inline uint16_t add565(uint16_t a, uint16_t b)
+{
+  uint16_t r = min((a >> 11) + (b >> 11), 31);
+  uint16_t g = min(((a >> 5) & 0x3F) + ((b >> 5) & 0x3F), 63);
+  uint16_t bl = min((a & 0x1F) + (b & 0x1F), 31);
+  return (r << 11) | (g << 5) | bl;
+}
+
+/**
+ * @brief 绘制文字窗口
+ *
+ * 对区域内每个屏幕列，按定点数位置找到对应的文字列，
+ * 把列位图逐位写到屏幕。小数位置时与下一列按权重混合。
+ * 颜色段指针随列单调前进，不做查找。
+ */
+void Marquee::draw(FastLED_NeoMatrix *matrix, int16_t x, int16_t y,
+                   uint32_t elapsedMs) const
+{
+  if (width == 0)
+    return;
+
+  // 文字第 0 列在屏幕上的位置 (Q8)
+  int32_t origin;
+  if (scroll)
+  {
+    uint32_t cycle = (uint32_t)(width + areaWidth) << 8;
+    uint32_t pos = (uint32_t)(((uint64_t)elapsedMs * speed / 1000) % cycle);
+    origin = ((int32_t)(areaX + areaWidth) << 8) - (int32_t)pos;
+  }
+  else
+  {
+    origin = (int32_t)(areaX + textX) << 8;
+  }
+
+  int16_t left = areaX > 0 ? areaX : 0;
+  int16_t right = areaX + areaWidth < MATRIX_WIDTH ? areaX + areaWidth
+                                                   : MATRIX_WIDTH;
+  uint8_t run = 0;
+  PixelTarget target(matrix);
+
+  for (int16_t sx = left; sx < right; sx++)
+  {
+    int32_t t = ((int32_t)sx << 8) - origin;
+    int16_t i = t >> 8;
+#if MARQUEE_SUBPIXEL
+    uint8_t frac = t & 0xFF;
+#else
+    uint8_t frac = 0;
+#endif
+    if (i + 1 < 0)
+      continue;
+    if (i >= (int16_t)width)
+      break;
+
+    uint8_t a = i >= 0 ? columns[i] : 0;
+    uint8_t b = frac && i + 1 < (int16_t)width ? columns[i + 1] : 0;
+    if (!(a | b))
+      continue;
+
+    // 颜色段随列前进
+    while (run + 1 < runCount && (int16_t)runs[run + 1].start <= i)
+      run++;
+    uint16_t colorA = runs[run].color;
+    uint16_t colorB = colorA;
+    if (run + 1 < runCount && runs[run + 1].start == i + 1)
+      colorB = runs[run + 1].color;
+
+    uint16_t onlyA = colorA, onlyB = 0, both = colorA;
+    if (frac)
+    {
+      onlyA = scale565(colorA, 256 - frac);
+      onlyB = scale565(colorB, frac);
+      both = add565(onlyA, onlyB);
+    }
+
+    for (uint8_t row = 0; row < 8; row++)
+    {
+      uint8_t mask = 1 << row;
+      bool onA = a & mask;
+      bool onB = b & mask;
+      if (onA || onB)
+        target.drawPixel565(sx + x, row + y,
+                            onA ? (onB ? both : onlyA) : onlyB);
+    }
+  }
+}
@@ -0,0 +1,107 @@
+/**
+ * @file Marquee.h
+ * @brief 滚动文字引擎 — 预渲染列位图 + 定点数亚像素滚动
+ *
+ * 本文件定义：
+ *   - MarqueeRun 结构体: 一段同色文字的起始列与颜色
+ *   - Marquee 结构体: 定长的列位图文字 (可多段颜色)，居中或滚动绘制
+ *
+ * 排版 (append) 在文字变化时执行一次：UTF-8 → 字体编码、转大写，
+ * 把每个字符的 AwtrixFont 字形展开成列位图 (每列 1 字节，bit n = 第 n 行)。
+ * GLYPH_CJK_FONT 开启时，中文等三/四字节 UTF-8 字符从 GlyphCache
+ * (LittleFS 字库) 取列位图，只在排版时查找一次，绘制时不访问字库。
+ * 绘制 (draw) 只从列位图中拷贝文字区域宽度的窗口，不再逐字 drawChar。
+ *
+ * 滚动位置 = 经过时间 × 速度 (Q8.8 像素/秒)，与帧率无关；
+ * 位置的小数部分按相邻两列的亮度混合绘制 (MARQUEE_SUBPIXEL)，低速滚动不抖动。
+ * 自定义应用、通知、状态画面共用。
+ */
+
+#ifndef MARQUEE_H
+#define MARQUEE_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <FastLED_NeoMatrix.h>
+
+/// 列位图最大列数 (超出部分截断)
+#define MARQUEE_MAX_COLUMNS 320
+
+/// 最大颜色段数
+#define MARQUEE_MAX_RUNS 8
+
+/// 默认滚动速度 (像素/秒，与原 50ms/像素一致)
+#define MARQUEE_DEFAULT_SPEED 20
+
+/// 亚像素混合 (1=按小数位置混合相邻列，0=整像素步进)
+#define MARQUEE_SUBPIXEL 1
+
+/// 一段同色文字
+struct MarqueeRun
+{
+  uint16_t start; ///< 起始列
+  uint16_t color; ///< 颜色 (RGB565)
+};
+
+/// 预渲染的滚动文字 (定长，无堆分配)
+struct Marquee
+{
+  uint8_t columns[MARQUEE_MAX_COLUMNS]; ///< 列位图 (bit n = 第 n 行)
+  MarqueeRun runs[MARQUEE_MAX_RUNS];    ///< 颜色段 (按起始列升序)
+  uint8_t runCount;                     ///< 颜色段数
+  uint16_t width;                       ///< 文字总像素宽度
+  int16_t areaX;                        ///< 文字区域起点
+  uint8_t areaWidth;                    ///< 文字区域宽度
+  int16_t textX;                        ///< 不滚动时的文字起点 (已居中)
+  bool scroll;                          ///< 文字超出区域，需要滚动
+  uint16_t speed;                       ///< 滚动速度 (Q8.8 像素/秒)
+
+  /// 清空文字 (速度保持不变，未设置时取默认值)
+  void clear();
+
+  /**
+   * @brief 追加一段文字
+   * @param text UTF-8 文字
+   * @param color 颜色 (RGB565)
+   */
+  void append(const char *text, uint16_t color);
+
+  /**
+   * @brief 追加 JSON 文字：字符串，或 [{t, c}, ...] 多段颜色数组
+   * @param text JSON 值
+   * @param color 未指定颜色的段使用的颜色
+   */
+  void appendJson(JsonVariantConst text, uint16_t color);
+
+  /**
+   * @brief 按文字区域计算居中/滚动 (文字或图标变化后调用)
+   * @param areaX 文字区域起点 (有图标时为 9)
+   * @param areaWidth 文字区域宽度
+   */
+  void reflow(int16_t areaX, uint8_t areaWidth);
+
+  /// 单色排版：clear + append + reflow
+  void layout(const char *text, uint16_t color, int16_t areaX,
+              uint8_t areaWidth);
+
+  /// 所有段改为同一颜色
+  void setColor(uint16_t color);
+
+  /// 设置滚动速度 (像素/秒，可为小数)
+  void setSpeed(float pixelsPerSecond);
+
+  /// 滚动一周 (从区域右边缘进入到完全移出左边缘) 的时长 (毫秒)
+  uint32_t cycleMs() const;
+
+  /**
+   * @brief 绘制文字窗口
+   * @param matrix 矩阵驱动指针
+   * @param x X 偏移量 (过渡动画)
+   * @param y Y 偏移量 (过渡动画)
+   * @param elapsedMs 距滚动起点的时间 (不滚动时忽略)
+   */
+  void draw(FastLED_NeoMatrix *matrix, int16_t x, int16_t y,
+            uint32_t elapsedMs) const;
+};
+
+#endif
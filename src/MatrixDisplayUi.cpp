@@ -5,14 +5,21 @@
  * 核心概念:
  *   - App:     独立的显示页面（时间、日期、天气等），通过 AppCallback 绘制
  *   - State:   FIXED (固定显示) / IN_TRANSITION (过渡动画中)
- *   - Overlay: 叠加在 App 之上的覆盖层（通知、闹钟等），始终绘制
+ *   - Overlay: 叠加在 App 之上的覆盖层（通知、闹钟等），始终绘制；
+ *              覆盖层设置 state.overlayActive 时暂停轮播并跳过 App 绘制
  *
  * 更新循环:
  *   update() → [帧率控制] → tick() → [状态机推进 + 绘制App + 绘制覆盖层]
  *
  * 时间单位:
- *   内部使用 "tick" 作为时间单位。1 tick = 1 帧 (由 updateInterval 决定)
+ *   内部使用 "tick" 作为时间单位。1 tick = updateInterval (MATRIX_FPS 的帧间隔)
  *   例如: 30FPS 时, ticksPerApp=150 ≈ 5秒
+ *   实际出帧间隔由帧率调节决定，tick 按流逝时间推进，与出帧次数无关。
+ *
+ * 帧率调节 (UI_FPS_GOVERNOR):
+ *   每帧绘制后按内容决定下一帧间隔 —— 过渡中、滚动文字、频谱按 UI_FPS_MAX，
+ *   动画图标按下一次切帧的时刻，计时器/闪烁按其声明的变化时刻，
+ *   其余静态画面按 UI_FPS_IDLE。时钟秒/半秒边界、导航操作立即出帧。
  *
  * 修复记录:
  *   [Fix1] getNextAppNumber() 有消费副作用，过渡期间只调用一次并缓存到
@@ -27,6 +34,7 @@
 
 #include "MatrixDisplayUi.h"
 #include "AwtrixFont.h"
+#include "ClockService.h"
 #include "Globals.h"
 
 /// player1: 固定显示 / 过渡中的「当前页」播放器
@@ -65,6 +73,7 @@ void MatrixDisplayUi::setTargetFPS(uint8_t fps)
 {
   float oldInterval = this->updateInterval;
   this->updateInterval = ((float)1.0 / (float)fps) * 1000;
+  this->_frameInterval = (uint32_t)this->updateInterval;
 
   float changeRatio = oldInterval / (float)this->updateInterval;
   this->ticksPerApp *= changeRatio;
@@ -97,12 +106,91 @@ void MatrixDisplayUi::setAppAnimation(AnimationDirection dir)
 
 /**
  * @brief 设置应用列表，同时预计算 enabledCount 缓存 [Fix3]
+ *
+ * 列表增删或重新排序后索引会移动：按名称重新定位当前应用和过渡目标，
+ * 屏幕上的应用继续显示 (时长按新配置)。当前应用已被移除或禁用时
+ * 换到原位置起的下一个已启用应用，立即开始显示。
  */
 void MatrixDisplayUi::setApps(const std::vector<AppData> &appList)
 {
+  int oldIndex = this->state.currentApp;
+  String current = oldIndex >= 0 && oldIndex < (int)this->apps.size()
+                       ? this->apps[oldIndex].name
+                       : String();
+  int next = this->state.cachedNextApp;
+  String target = next >= 0 && next < (int)this->apps.size()
+                      ? this->apps[next].name
+                      : String();
+
   this->apps = appList;
   this->AppCount = appList.size();
   _rebuildEnabledCount();
+  this->nextAppNumber = -1; // 旧索引，已失效
+
+  int index = _findEnabledApp(current);
+  if (index >= 0)
+  {
+    this->state.currentApp = index;
+    if (this->state.appState == IN_TRANSITION)
+    {
+      this->state.cachedNextApp = _findEnabledApp(target);
+      if (this->state.cachedNextApp < 0)
+      {
+        // 过渡目标已不存在：停在当前应用，下次轮播再选
+        this->state.appState = FIXED;
+        this->state.ticksSinceLastStateSwitch = 0;
+      }
+    }
+    _applyAppDuration();
+  }
+  else
+  {
+    // 当前应用已不存在：从原位置起取第一个已启用的应用
+    index = 0;
+    int count = (int)this->apps.size();
+    for (int i = 0; i < count; i++)
+    {
+      int candidate = (oldIndex + i) % count;
+      if (candidate >= 0 && this->apps[candidate].enabled)
+      {
+        index = candidate;
+        break;
+      }
+    }
+    this->state.currentApp = index;
+    this->state.appState = FIXED;
+    this->state.cachedNextApp = -1;
+    this->state.ticksSinceLastStateSwitch = 0;
+    _applyAppDuration();
+  }
+  invalidate();
+}
+
+int MatrixDisplayUi::_findEnabledApp(const String &name) const
+{
+  if (name.length() == 0)
+    return -1;
+  for (int i = 0; i < (int)this->apps.size(); i++)
+  {
+    if (this->apps[i].enabled && this->apps[i].name == name)
+      return i;
+  }
+  return -1;
+}
+
+void MatrixDisplayUi::_applyAppDuration()
+{
+  if (this->state.currentApp < (int)this->apps.size() &&
+      this->apps[this->state.currentApp].duration > 0)
+  {
+    ticksPerApp = (int)((float)this->apps[this->state.currentApp].duration /
+                        (float)this->updateInterval);
+  }
+  else
+  {
+    extern uint16_t TIME_PER_APP;
+    ticksPerApp = (int)((float)TIME_PER_APP / (float)this->updateInterval);
+  }
 }
 
 void MatrixDisplayUi::setOverlays(OverlayCallback *overlayFunctions,
@@ -141,6 +229,7 @@ void MatrixDisplayUi::nextApp()
     this->state.appTransitionDirection = 1;
     // [Fix1] 过渡开始时立即锁定目标 App
     this->state.cachedNextApp = getNextAppNumber();
+    invalidate();
   }
 }
 
@@ -155,6 +244,7 @@ void MatrixDisplayUi::previousApp()
     this->state.appTransitionDirection = -1;
     // [Fix1] 过渡开始时立即锁定目标 App
     this->state.cachedNextApp = getNextAppNumber();
+    invalidate();
   }
 }
 
@@ -174,6 +264,7 @@ void MatrixDisplayUi::transitionToApp(uint8_t app)
   this->state.appTransitionDirection = app < this->state.currentApp ? -1 : 1;
   // [Fix1] 过渡开始时立即锁定目标 App
   this->state.cachedNextApp = getNextAppNumber();
+  invalidate();
 }
 
 void MatrixDisplayUi::switchToApp(uint8_t app)
@@ -193,8 +284,12 @@ void MatrixDisplayUi::switchToApp(uint8_t app)
     this->ticksPerApp =
         (int)((float)apps[app].duration / (float)updateInterval);
   }
+  invalidate();
 }
 
+/// 下一次 update() 立即出帧
+void MatrixDisplayUi::invalidate() { this->_frameInterval = 0; }
+
 // ==================================================================
 // 核心：下一应用选择算法
 // ==================================================================
@@ -278,8 +373,12 @@ void MatrixDisplayUi::drawApp()
     if (nextApp < 0 || nextApp >= (int)apps.size())
       nextApp = this->state.currentApp; // 安全回退
 
-    float progress =
-        (float)this->state.ticksSinceLastStateSwitch / (float)this->ticksPerTransition;
+    // 含不足一个 tick 的部分：高帧率时每帧都有位移
+    float progress = ((float)this->state.ticksSinceLastStateSwitch +
+                      this->_tickPhaseMs / this->updateInterval) /
+                     (float)this->ticksPerTransition;
+    if (progress > 1.0f)
+      progress = 1.0f;
 
     int16_t x = 0, y = 0;
     int16_t x1 = 0, y1 = 0;
@@ -330,11 +429,18 @@ void MatrixDisplayUi::drawApp()
 // 状态机 + 主渲染循环
 // ==================================================================
 
-void MatrixDisplayUi::tick()
+void MatrixDisplayUi::tick(int ticks)
 {
-  this->state.ticksSinceLastStateSwitch++;
+  // 上一帧覆盖层占用全屏：暂停轮播 (计时冻结)，本帧不绘制 App
+  bool overlayHold = this->state.overlayActive;
+  this->state.overlayActive = false;
+  this->state.frameDemandMs = UINT32_MAX;
+  this->state.frameReason = FRAME_STATIC;
+
+  if (!overlayHold)
+    this->state.ticksSinceLastStateSwitch += ticks;
 
-  if (this->AppCount > 0)
+  if (this->AppCount > 0 && !overlayHold)
   {
     switch (this->state.appState)
     {
@@ -351,18 +457,7 @@ void MatrixDisplayUi::tick()
         this->state.currentApp = nextApp;
         this->state.cachedNextApp = -1;
         this->state.ticksSinceLastStateSwitch = 0;
-
-        if (this->state.currentApp < (int)this->apps.size() &&
-            this->apps[this->state.currentApp].duration > 0)
-        {
-          ticksPerApp = (int)((float)this->apps[this->state.currentApp].duration /
-                              (float)this->updateInterval);
-        }
-        else
-        {
-          extern uint16_t TIME_PER_APP;
-          ticksPerApp = (int)((float)TIME_PER_APP / (float)this->updateInterval);
-        }
+        _applyAppDuration();
       }
       break;
 
@@ -389,11 +484,14 @@ void MatrixDisplayUi::tick()
   }
 
   this->matrix->clear();
-  if (this->AppCount > 0)
+  if (this->AppCount > 0 && !overlayHold)
     this->drawApp();
   this->drawOverlays();
+  // 覆盖层刚刚结束：补绘 App，避免出现一帧黑屏
+  if (overlayHold && !this->state.overlayActive && this->AppCount > 0)
+    this->drawApp();
   DisplayManager.gammaCorrection();
-  this->matrix->show();
+  DisplayManager.show();
 }
 
 // ==================================================================
@@ -405,29 +503,156 @@ void MatrixDisplayUi::tick()
  *
  * [Fix4] timeBudget 改为 long 消除 int8_t 溢出；
  *        丢帧补偿不再受 setAutoTransition 限制，手动模式下过渡也正常追帧。
+ *
+ * 出帧间隔取 _frameInterval (上一帧由 governFrame() 决定)；
+ * tick 按两帧之间实际流逝的时间推进 (迟到的帧同样补足，即原丢帧补偿)。
  */
 int8_t MatrixDisplayUi::update()
 {
   unsigned long appStart = millis();
   // [Fix4] 用 long 计算，避免 int8_t 溢出（超过 128ms 时会错误补偿）
-  long timeBudget = (long)this->updateInterval - (long)(appStart - this->state.lastUpdate);
+  long timeBudget = (long)this->_frameInterval - (long)(appStart - this->state.lastUpdate);
+
+  // 秒边界/半秒到达：立即出帧，新的秒与分隔符切换不等待下一个帧间隔。
+  // lastUpdate 从此刻重新计时，后续帧与秒边界保持固定相位
+  uint32_t clockEdge = ClockService.edge();
+  bool edgeFrame = clockEdge != this->_clockEdge;
+  if (edgeFrame)
+  {
+    this->_clockEdge = clockEdge;
+    if (timeBudget > 0)
+      timeBudget = 0;
+  }
 
   if (timeBudget <= 0)
   {
     // [Fix4] 补偿不再受 setAutoTransition 限制
+    int ticks = 1;
     if (this->state.lastUpdate != 0)
     {
-      this->state.ticksSinceLastStateSwitch +=
-          (int)(-timeBudget / (long)this->updateInterval);
+      this->_tickPhaseMs += (float)(appStart - this->state.lastUpdate);
+      ticks = (int)(this->_tickPhaseMs / this->updateInterval);
+      this->_tickPhaseMs -= ticks * this->updateInterval;
     }
     this->state.lastUpdate = appStart;
-    this->tick();
+
+    uint32_t renderStart = micros();
+    this->tick(ticks);
+    this->_frameInterval = this->governFrame();
+    recordFrame(micros() - renderStart);
+    if (edgeFrame)
+      ClockService.markEdgeFrame();
   }
 
   // 返回值保持 int8_t 兼容（调用方用于可选 delay）
-  long remaining = (long)this->updateInterval - (long)(millis() - appStart);
+  long remaining = (long)this->_frameInterval - (long)(millis() - appStart);
   return (int8_t)(remaining > 127 ? 127
                                   : (remaining < -128 ? -128 : remaining));
 }
 
+// ==================================================================
+// 帧率调节
+// ==================================================================
+
+/**
+ * @brief 按本帧绘制的内容决定下一帧间隔
+ *
+ * 绘制回调已经通过 state.requestFrame() 声明了滚动、频谱、计时器等；
+ * 这里补上 UI 自己知道的过渡动画和本帧播放过的动画图标，
+ * 结果限制在 [1000/UI_FPS_MAX, 1000/UI_FPS_IDLE] 毫秒。
+ */
+uint32_t MatrixDisplayUi::governFrame()
+{
+  MatrixDisplayUiState &s = this->state;
+  if (s.appState == IN_TRANSITION)
+    s.requestFrame(0, FRAME_TRANSITION);
+  // 只看本帧绘制过的播放器 (player2 在固定显示且无覆盖层时不播放)
+  if (player1.takePlayed())
+    s.requestFrame(player1.msUntilNextFrame(), FRAME_ICON);
+  if (player2.takePlayed())
+    s.requestFrame(player2.msUntilNextFrame(), FRAME_ICON);
+
+#if UI_FPS_GOVERNOR
+  uint32_t interval = s.frameDemandMs;
+  this->_frameReason = s.frameReason;
+  if (interval < 1000 / UI_FPS_MAX)
+    interval = 1000 / UI_FPS_MAX;
+  if (interval > 1000 / UI_FPS_IDLE)
+  {
+    interval = 1000 / UI_FPS_IDLE;
+    this->_frameReason = FRAME_STATIC;
+  }
+  return interval;
+#else
+  this->_frameReason = s.frameReason;
+  return (uint32_t)this->updateInterval;
+#endif
+}
+
+void MatrixDisplayUi::recordFrame(uint32_t renderUs)
+{
+  uint32_t now = millis();
+  if (this->_window.startMs == 0)
+    this->_window.startMs = now;
+
+  this->_window.frames++;
+  this->_window.renderUs += renderUs;
+  this->_window.reasons[this->_frameReason]++;
+  this->_totalFrames++;
+
+  uint32_t span = now - this->_window.startMs;
+  if (span < UI_FPS_WINDOW_MS)
+    return;
+
+  // 窗口结束: 与固定 MATRIX_FPS 在同样时长内的渲染量比较
+  float baselineFrames = (float)span / this->updateInterval;
+  float avgUs = (float)this->_window.renderUs / this->_window.frames;
+  this->_savedUs += (int64_t)((baselineFrames - this->_window.frames) * avgUs);
+
+  this->_lastWindow = this->_window;
+  this->_lastWindowMs = span;
+  this->_window = FrameWindow();
+  this->_window.startMs = now;
+}
+
+void MatrixDisplayUi::frameStatsToJson(JsonObject out)
+{
+  static const char *const REASONS[FRAME_REASON_COUNT] = {
+      "static", "content", "icon", "scroll", "spectrum", "transition"};
+
+  out["governor"] = (bool)UI_FPS_GOVERNOR;
+  out["baseFps"] = 1000.0f / this->updateInterval;
+  out["intervalMs"] = this->_frameInterval;
+  out["reason"] = REASONS[this->_frameReason];
+  out["frames"] = this->_totalFrames;
+
+  const FrameWindow &w = this->_lastWindow;
+  if (this->_lastWindowMs > 0 && w.frames > 0)
+  {
+    float windowMs = (float)this->_lastWindowMs;
+    float avgUs = (float)w.renderUs / w.frames;
+    float baselineFrames = windowMs / this->updateInterval;
+    out["windowMs"] = this->_lastWindowMs;
+    out["effectiveFps"] = w.frames * 1000.0f / windowMs;
+    out["renderAvgUs"] = avgUs;
+    // 主循环用于渲染的 CPU 比例: 实际 / 固定 MATRIX_FPS 时
+    out["cpuPct"] = w.renderUs / (windowMs * 10.0f);
+    out["baselineCpuPct"] = baselineFrames * avgUs / (windowMs * 10.0f);
+    JsonObject reasons = out.createNestedObject("reasons");
+    for (uint8_t i = 0; i < FRAME_REASON_COUNT; i++)
+      if (w.reasons[i])
+        reasons[REASONS[i]] = w.reasons[i];
+  }
+  out["savedMs"] = (long)(this->_savedUs / 1000);
+}
+
+void MatrixDisplayUi::resetFrameStats()
+{
+  this->_window = FrameWindow();
+  this->_lastWindow = FrameWindow();
+  this->_lastWindowMs = 0;
+  this->_totalFrames = 0;
+  this->_savedUs = 0;
+}
+
 MatrixDisplayUiState *MatrixDisplayUi::getUiState() { return &state; }
\ No newline at end of file
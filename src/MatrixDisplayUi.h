@@ -4,6 +4,7 @@
  *
  * 本文件定义了整个 UI 系统的核心数据结构:
  *   - AppState / AnimationDirection   枚举类型
+ *   - FrameReason                     帧率调节的原因分类
  *   - MatrixDisplayUiState            UI 状态机数据
  *   - AppData                         应用描述结构体
  *   - AppCallback / OverlayCallback   回调函数类型
@@ -16,8 +17,27 @@
 #include "FastFramePlayer.h"
 #include "DisplayManager.h"
 #include <FastLED_NeoMatrix.h>
+#include <ArduinoJson.h>
 #include <vector>
 
+// ==================================================================
+// 帧率调节配置
+// ==================================================================
+
+/// 启用按内容调节帧率 (0=固定 MATRIX_FPS)
+#ifndef UI_FPS_GOVERNOR
+#define UI_FPS_GOVERNOR 1
+#endif
+
+/// 最高帧率 (过渡、滚动文字、频谱)
+#define UI_FPS_MAX 60
+
+/// 静态画面的帧率 (时钟秒/半秒边界另行立即出帧)
+#define UI_FPS_IDLE 4
+
+/// 帧率统计窗口 (毫秒)
+#define UI_FPS_WINDOW_MS 2000
+
 // ==================================================================
 // 枚举定义
 // ==================================================================
@@ -38,6 +58,18 @@ enum AnimationDirection
   SLIDE_RIGHT ///< (预留) 右滑
 };
 
+/// 本帧帧间隔的决定因素 (按优先级从低到高，同间隔时取高者)
+enum FrameReason : uint8_t
+{
+  FRAME_STATIC = 0, ///< 静态内容 (UI_FPS_IDLE)
+  FRAME_CONTENT,    ///< 内容声明的变化时刻 (计时器、闪烁)
+  FRAME_ICON,       ///< 动画图标的下一帧
+  FRAME_SCROLL,     ///< 滚动文字
+  FRAME_SPECTRUM,   ///< 频谱
+  FRAME_TRANSITION, ///< 应用切换动画
+  FRAME_REASON_COUNT
+};
+
 // ==================================================================
 // 状态数据
 // ==================================================================
@@ -53,6 +85,23 @@ struct MatrixDisplayUiState
   unsigned long lastUpdate =
       0;                  ///< 上次 update() 调用的时间戳（unsigned 防溢出）
   int cachedNextApp = -1; ///< 过渡开始时锁定的目标 App 索引，-1=未锁定
+  bool overlayActive = false; ///< 覆盖层本帧占用全屏 (如通知)，下一帧暂停轮播、跳过 App 绘制
+  uint32_t frameDemandMs = UINT32_MAX; ///< 本帧内容要求的最长重绘间隔 (每帧开始时重置)
+  FrameReason frameReason = FRAME_STATIC; ///< frameDemandMs 的来源
+
+  /**
+   * @brief 绘制回调声明内容将在 ms 毫秒后变化 (0=持续运动，按最高帧率)
+   *
+   * 多个声明取最短间隔；没有任何声明的帧按静态画面处理。
+   */
+  void requestFrame(uint32_t ms, FrameReason reason)
+  {
+    if (ms < frameDemandMs || (ms == frameDemandMs && reason > frameReason))
+    {
+      frameDemandMs = ms;
+      frameReason = reason;
+    }
+  }
 };
 
 // ==================================================================
@@ -106,6 +155,8 @@ struct AppData
  *   - 支持手动和自动切换
  *   - 在 App 之上绘制覆盖层 (通知/闹钟等)
  *   - 帧率控制和丢帧补偿
+ *   - 按内容调节帧率: 静态画面 UI_FPS_IDLE，图标按动画帧间隔，
+ *     过渡/滚动/频谱 UI_FPS_MAX；tick 仍以 MATRIX_FPS 的帧间隔计时
  */
 class MatrixDisplayUi
 {
@@ -122,6 +173,24 @@ private:
   int8_t lastTransitionDirection = 1;                    ///< 手动控制前的方向（用于恢复）
   bool setAutoTransition = true;                         ///< 是否启用自动轮播
   int _enabledAppCount = 0;                              ///< 缓存的已启用 App 数量，避免每帧遍历
+  uint32_t _clockEdge = 0;                               ///< 已渲染的时钟边沿计数
+  float _tickPhaseMs = 0;                                ///< 不足一个 tick 的已流逝时间
+  uint32_t _frameInterval = 33;                          ///< 调节后的下一帧间隔 (ms)
+  FrameReason _frameReason = FRAME_STATIC;               ///< 当前帧间隔的决定因素
+
+  // 帧率统计: 当前窗口累计，窗口结束时转存
+  struct FrameWindow
+  {
+    uint32_t startMs = 0;
+    uint32_t frames = 0;
+    uint32_t renderUs = 0;
+    uint32_t reasons[FRAME_REASON_COUNT] = {};
+  };
+  FrameWindow _window;       ///< 正在累计的窗口
+  FrameWindow _lastWindow;   ///< 最近一个完整窗口
+  uint32_t _lastWindowMs = 0; ///< 最近窗口的实际长度
+  uint32_t _totalFrames = 0;
+  int64_t _savedUs = 0;      ///< 相对固定 MATRIX_FPS 累计节省的渲染时间 (负数=多花)
 
   // 覆盖层
   OverlayCallback *overlayFunctions; ///< 覆盖层回调数组
@@ -131,8 +200,12 @@ private:
   int getNextAppNumber();      ///< 计算下一应用索引（有副作用，仅在过渡开始时调用一次）
   void drawApp();              ///< 渲染当前/过渡中的应用
   void drawOverlays();         ///< 渲染覆盖层
-  void tick();                 ///< 状态机推进 + 绘制一帧
+  void tick(int ticks);        ///< 状态机推进 ticks 个 tick + 绘制一帧
+  uint32_t governFrame();      ///< 按本帧内容决定下一帧间隔
+  void recordFrame(uint32_t renderUs); ///< 帧率统计
   void _rebuildEnabledCount(); ///< 预计算并缓存 enabledCount [Fix3]
+  int _findEnabledApp(const String &name) const; ///< 按名称查找已启用的应用 (-1=无)
+  void _applyAppDuration();    ///< 按当前应用的时长设置 ticksPerApp
 
 public:
   MatrixDisplayUi(FastLED_NeoMatrix *matrix);
@@ -162,6 +235,13 @@ public:
   int8_t update();
   MatrixDisplayUiState *getUiState();
 
+  /// 下一次 update() 立即出帧 (导航、设置变更后不等静态帧间隔)
+  void invalidate();
+
+  /// 帧率统计: 有效帧率、渲染耗时、帧间隔来源分布、相对固定帧率节省的 CPU 时间
+  void frameStatsToJson(JsonObject out);
+  void resetFrameStats();
+
   int AppCount = 0; ///< 当前已注册的应用数量
 };
 
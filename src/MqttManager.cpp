@@ -0,0 +1,455 @@
+/**
+ * @file MqttManager.cpp
+ * @brief MQTT 客户端实现 — 连接退避、变化检测、命令转发
+ */
+
+#include "MqttManager.h"
+#include "Globals.h"
+#include "HeapTelemetry.h"
+#include "Logger.h"
+#include "PeripheryManager.h"
+#include "ServerManager.h"
+#include <Preferences.h>
+
+// ==================================================================
+// 单例
+// ==================================================================
+
+MqttManager_ &MqttManager_::getInstance()
+{
+  static MqttManager_ instance;
+  return instance;
+}
+
+MqttManager_ &MqttManager = MqttManager_::getInstance();
+
+// ==================================================================
+// 配置
+// ==================================================================
+
+void MqttManager_::setup()
+{
+  HeapTagScope heapTag(HEAP_TAG_SERVER);
+  Preferences prefs;
+  prefs.begin("mqtt", true);
+  _enabled = prefs.getBool("en", false);
+  _host = prefs.getString("host", "");
+  _port = prefs.getUShort("port", MQTT_DEFAULT_PORT);
+  _user = prefs.getString("user", "");
+  _password = prefs.getString("pass", "");
+  _prefix = prefs.getString("prefix", MQTT_DEFAULT_PREFIX);
+  prefs.end();
+
+  // 客户端 ID 取 MAC 低 3 字节，同一 Broker 上多台设备不冲突
+  char id[24];
+  snprintf(id, sizeof(id), "neoclock-%06lx",
+           (unsigned long)(ESP.getEfuseMac() >> 24) & 0xFFFFFF);
+  _clientId = id;
+
+  _client.setClient(_net);
+  _client.setBufferSize(MQTT_BUFFER_SIZE);
+  _client.setKeepAlive(MQTT_KEEPALIVE);
+  _client.setSocketTimeout(MQTT_SOCKET_TIMEOUT);
+  _client.setCallback([this](char *topic, uint8_t *payload, unsigned int length)
+                      { _onMessage(topic, payload, length); });
+
+  if (_enabled)
+    LOG_INFO("[MQTT] Broker: %s:%u, 前缀: %s", _host.c_str(), _port,
+             _prefix.c_str());
+}
+
+bool MqttManager_::configure(JsonObject cmd, String &error)
+{
+  BrokerConfig cfg;
+  cfg.enabled = cmd.containsKey("enabled") ? cmd["enabled"].as<bool>() : _enabled;
+  cfg.host = cmd.containsKey("host") ? cmd["host"].as<String>() : _host;
+  cfg.host.trim();
+  if (cfg.enabled && cfg.host.length() == 0)
+  {
+    error = "missing host";
+    return false;
+  }
+
+  cfg.port = _port;
+  if (cmd.containsKey("port"))
+    cfg.port = cmd["port"].as<uint16_t>() ? cmd["port"].as<uint16_t>() : MQTT_DEFAULT_PORT;
+  cfg.user = cmd.containsKey("user") ? cmd["user"].as<String>() : _user;
+  cfg.password = cmd.containsKey("password") ? cmd["password"].as<String>() : _password;
+  cfg.prefix = _prefix;
+  if (cmd.containsKey("prefix"))
+  {
+    cfg.prefix = cmd["prefix"].as<String>();
+    cfg.prefix.trim();
+    if (cfg.prefix.length() == 0)
+      cfg.prefix = MQTT_DEFAULT_PREFIX;
+  }
+
+  // 命令可能来自 MQTT 回调：此时断开会让响应发不出去，留给 tick() 应用
+  _pendingConfig = cfg;
+  _configPending = true;
+  return true;
+}
+
+/**
+ * @brief 应用 configure() 暂存的配置 (主循环，不在 PubSubClient 回调中)
+ *
+ * 旧连接以旧前缀发布 offline 后断开，保存配置并安排立即重连。
+ */
+void MqttManager_::_applyConfig()
+{
+  _configPending = false;
+  BrokerConfig &cfg = _pendingConfig;
+
+  // 连接任务运行中不碰 _client；任务结果按代数作废
+  if (!_job && _client.connected())
+  {
+    _publish("status", "offline", true);
+    _client.disconnect();
+  }
+
+  _enabled = cfg.enabled;
+  if (cfg.host != _host)
+    _resolved = false;
+  _host = cfg.host;
+  _port = cfg.port;
+  _user = cfg.user;
+  _password = cfg.password;
+  _prefix = cfg.prefix;
+  _saveConfig();
+
+  // 按新配置立即重连
+  _generation++;
+  _hasPublished = false;
+  _backoff = MQTT_RECONNECT_MIN;
+  _nextAttempt = millis();
+  LOG_INFO("[MQTT] 配置已更新: %s (%s:%u)", _enabled ? "启用" : "禁用",
+           _host.c_str(), _port);
+}
+
+void MqttManager_::_saveConfig()
+{
+  Preferences prefs;
+  prefs.begin("mqtt", false);
+  prefs.putBool("en", _enabled);
+  prefs.putString("host", _host);
+  prefs.putUShort("port", _port);
+  prefs.putString("user", _user);
+  prefs.putString("pass", _password);
+  prefs.putString("prefix", _prefix);
+  prefs.end();
+}
+
+void MqttManager_::toJson(JsonObject out)
+{
+  out["enabled"] = _enabled;
+  out["host"] = _host;
+  out["port"] = _port;
+  out["user"] = _user;
+  out["prefix"] = _prefix;
+  out["connected"] = isConnected();
+  out["connecting"] = _job != nullptr;
+  out["connects"] = _connects;
+  out["publishes"] = _publishes;
+  out["commands"] = _commands;
+}
+
+// ==================================================================
+// 连接
+// ==================================================================
+
+/**
+ * @brief 启动一次连接尝试 (连接任务)
+ *
+ * 任务需要的配置复制进 ConnectJob，任务运行期间 configure() 修改配置
+ * 不影响本次尝试 (结果按代数作废)。
+ */
+void MqttManager_::_startConnect()
+{
+  ConnectJob *job = new ConnectJob();
+  job->host = _host;
+  job->port = _port;
+  job->clientId = _clientId;
+  job->user = _user;
+  job->password = _password;
+  job->willTopic = _prefix + "/status";
+  job->ip = _brokerIp;
+  job->resolved = _resolved;
+  job->tcpConnected = false;
+  job->connected = false;
+  job->state = 0;
+  job->generation = _generation;
+
+  _job = job;
+  if (xTaskCreatePinnedToCore(_connectTask, "MqttConn", MQTT_CONNECT_STACK,
+                              this, 1, nullptr, 0) != pdPASS)
+  {
+    LOG_WARN("[MQTT] 创建连接任务失败");
+    _job = nullptr;
+    delete job;
+  }
+}
+
+/**
+ * @brief 连接任务: DNS 解析 (未缓存时)、TCP 连接、MQTT 握手
+ *
+ * 只访问 _job、_net 和 _client (主循环此时不访问它们)，
+ * 写完结果后置 done，之后不再访问任何成员。
+ */
+void MqttManager_::_connectTask(void *param)
+{
+  MqttManager_ *self = static_cast<MqttManager_ *>(param);
+  ConnectJob *job = self->_job;
+
+  if (!job->resolved)
+  {
+    job->resolved = job->ip.fromString(job->host) ||
+                    WiFi.hostByName(job->host.c_str(), job->ip) == 1;
+  }
+
+  if (job->resolved &&
+      self->_net.connect(job->ip, job->port, MQTT_CONNECT_TIMEOUT))
+  {
+    job->tcpConnected = true;
+    PubSubClient &client = self->_client;
+    client.setServer(job->ip, job->port);
+    bool hasUser = job->user.length() > 0;
+    job->connected = client.connect(
+        job->clientId.c_str(), hasUser ? job->user.c_str() : nullptr,
+        hasUser ? job->password.c_str() : nullptr, job->willTopic.c_str(), 1,
+        true, "offline");
+    job->state = client.state();
+    if (!job->connected)
+      self->_net.stop();
+  }
+
+  job->done.store(true);
+  vTaskDelete(nullptr);
+}
+
+/**
+ * @brief 处理已结束的连接尝试 (主循环)
+ *
+ * 地址缓存只在 DNS 解析失败时清除；TCP 失败不重新解析。
+ * 连接成功后订阅命令主题并完整发布一次保留状态。
+ */
+void MqttManager_::_finishConnect()
+{
+  ConnectJob *job = _job;
+  _job = nullptr;
+
+  bool current = job->generation == _generation;
+  if (current)
+  {
+    _brokerIp = job->ip;
+    _resolved = job->resolved;
+  }
+
+  bool ok = job->connected && current && _enabled;
+  if (job->connected && !ok)
+  {
+    // 配置已变化: 丢弃按旧配置建立的连接
+    _client.disconnect();
+  }
+  else if (!job->resolved)
+  {
+    LOG_WARN("[MQTT] 无法解析 Broker 地址: %s", job->host.c_str());
+  }
+  else if (job->tcpConnected && !job->connected)
+  {
+    LOG_WARN("[MQTT] 连接被拒绝 (state=%d)", job->state);
+  }
+  delete job;
+
+  if (!ok)
+  {
+    // 配置变化时 configure() 已安排立即重连，不退避
+    if (current)
+    {
+      LOG_DEBUG("[MQTT] %lu ms 后重试", _backoff);
+      _nextAttempt = millis() + _backoff;
+      _backoff = min(_backoff * 2, (unsigned long)MQTT_RECONNECT_MAX);
+    }
+    return;
+  }
+
+  _backoff = MQTT_RECONNECT_MIN;
+  _publish("status", "online", true);
+  String cmdTopic = _prefix + "/cmd";
+  _client.subscribe(cmdTopic.c_str());
+  cmdTopic += "/+";
+  _client.subscribe(cmdTopic.c_str());
+
+  _connects++;
+  LOG_INFO("[MQTT] 已连接 Broker (%s:%u)", _host.c_str(), _port);
+
+  // 连接后完整发布一次保留状态
+  _publishChanges(true);
+}
+
+// ==================================================================
+// 主循环
+// ==================================================================
+
+void MqttManager_::tick()
+{
+  HeapTagScope heapTag(HEAP_TAG_SERVER);
+
+  if (_configPending)
+    _applyConfig();
+
+  // 连接任务运行中: 只轮询结果
+  if (_job)
+  {
+    if (_job->done.load())
+      _finishConnect();
+    return;
+  }
+
+  if (!_enabled || _host.length() == 0)
+    return;
+
+  if (!_client.connected())
+  {
+    if ((long)(millis() - _nextAttempt) >= 0)
+      _startConnect();
+    return;
+  }
+
+  _client.loop();
+
+  if (millis() - _lastBatch >= MQTT_BATCH_INTERVAL)
+  {
+    _lastBatch = millis();
+    _publishChanges(false);
+  }
+}
+
+// ==================================================================
+// 状态发布
+// ==================================================================
+
+/// 快照中表示 "无读数" (传感器返回 NaN) 的 ×10 值
+static const int16_t NO_READING = INT16_MIN;
+
+/**
+ * @brief ×10 定点值 → 一位小数文本
+ * @return 无读数时为空串 (保留消息被清除，订阅方不会把哨兵值当作读数)
+ */
+static const char *tenthsText(int16_t value, char *out, size_t size)
+{
+  if (value == NO_READING)
+    out[0] = '\0';
+  else
+    snprintf(out, size, "%.1f", value / 10.0f);
+  return out;
+}
+
+void MqttManager_::_takeSnapshot(Snapshot &s)
+{
+  s.temp10 = isnan(INDOOR_TEMP) ? NO_READING : (int16_t)lroundf(INDOOR_TEMP * 10);
+  s.hum10 = isnan(INDOOR_HUM) ? NO_READING : (int16_t)lroundf(INDOOR_HUM * 10);
+  s.brightness = (uint8_t)((BRIGHTNESS * 100) / 255);
+  s.ldr = (uint8_t)((PeripheryManager.getLdrBrightness() * 100) / 255);
+  s.power = !MATRIX_OFF;
+  s.autoBrightness = AUTO_BRIGHTNESS;
+  s.autoPlay = AUTO_TRANSITION;
+  s.app = CURRENT_APP;
+}
+
+/**
+ * @brief 发布与上次快照不同的状态项
+ * @param force true=全部发布 (刚连接时)
+ *
+ * 单项主题只发布变化的字段；任一字段变化时再发布一次完整的 stats JSON。
+ */
+void MqttManager_::_publishChanges(bool force)
+{
+  Snapshot now;
+  _takeSnapshot(now);
+  if (!_hasPublished)
+    force = true;
+
+  bool changed = false;
+  char buf[16];
+  char tenths[8];
+
+#define MQTT_PUBLISH_FIELD(field, topic, fmt, value)    \
+  if (force || now.field != _published.field)           \
+  {                                                     \
+    snprintf(buf, sizeof(buf), fmt, value);             \
+    _publish("state/" topic, buf, true);                \
+    changed = true;                                     \
+  }
+
+  MQTT_PUBLISH_FIELD(temp10, "temp", "%s",
+                     tenthsText(now.temp10, tenths, sizeof(tenths)))
+  MQTT_PUBLISH_FIELD(hum10, "hum", "%s",
+                     tenthsText(now.hum10, tenths, sizeof(tenths)))
+  MQTT_PUBLISH_FIELD(brightness, "brightness", "%u", now.brightness)
+  MQTT_PUBLISH_FIELD(ldr, "ldr", "%u", now.ldr)
+  MQTT_PUBLISH_FIELD(power, "power", "%s", now.power ? "true" : "false")
+  MQTT_PUBLISH_FIELD(autoBrightness, "autoBrightness", "%s",
+                     now.autoBrightness ? "true" : "false")
+  MQTT_PUBLISH_FIELD(autoPlay, "autoPlay", "%s",
+                     now.autoPlay ? "true" : "false")
+
+#undef MQTT_PUBLISH_FIELD
+
+  if (force || now.app != _published.app)
+  {
+    _publish("state/app", now.app.c_str(), true);
+    changed = true;
+  }
+
+  if (changed)
+    _publish("stats", ServerManager.buildStatsJson().c_str(), true);
+
+  _published = now;
+  _hasPublished = true;
+}
+
+bool MqttManager_::_publish(const char *suffix, const char *payload,
+                            bool retained)
+{
+  String topic = _prefix + "/" + suffix;
+  bool ok = _client.publish(topic.c_str(), payload, retained);
+  if (ok)
+    _publishes++;
+  return ok;
+}
+
+// ==================================================================
+// 命令
+// ==================================================================
+
+/**
+ * @brief 处理订阅的命令消息
+ *
+ * <prefix>/cmd/<type> 或 <prefix>/cmd，负载交给 ServerManager 按
+ * WebSocket 命令同样的逻辑执行，响应发布到 <prefix>/response。
+ */
+void MqttManager_::_onMessage(char *topic, uint8_t *payload,
+                              unsigned int length)
+{
+  // topic/payload 指向 PubSubClient 的缓冲区，发布响应前先复制出命令类型
+  const char *sub = topic + _prefix.length();
+  if (strncmp(topic, _prefix.c_str(), _prefix.length()) != 0 ||
+      strncmp(sub, "/cmd", 4) != 0)
+    return;
+  sub += 4;
+
+  char type[32] = {0};
+  if (*sub == '/')
+    strncpy(type, sub + 1, sizeof(type) - 1);
+
+  _commands++;
+  String response;
+  ServerManager.handleExternalCommand(type[0] ? type : nullptr,
+                                      (const char *)payload, length,
+                                      response);
+  // setMqttConfig 只暂存配置，连接与前缀在 tick() 中才切换，响应仍发回原主题
+  _publish("response", response.c_str(), false);
+
+  // 命令可能改变状态，立即检查而不必等下一个批量窗口
+  _lastBatch = 0;
+}
@@ -0,0 +1,203 @@
+/**
+ * @file MqttManager.h
+ * @brief MQTT 客户端 — 状态变化推送与远程命令
+ *
+ * 本文件定义：
+ *   - MqttManager_ 单例类: 连接 MQTT Broker，推送状态，订阅命令
+ *   - Broker 配置持久化 (NVS 命名空间 "mqtt")
+ *
+ * 主题 (<prefix> 默认为 "neoclock")：
+ *   <prefix>/status          → "online" / "offline" (遗嘱，保留)
+ *   <prefix>/stats           → 完整状态 JSON (同 getStats，保留)
+ *   <prefix>/state/<field>   → 单项状态 (temp/hum/brightness/power/app 等，保留)
+ *   <prefix>/cmd/<type>      ← 命令，负载同 WebSocket 命令 (如 cmd/setBrightness {"value":50})
+ *   <prefix>/cmd             ← 命令，类型取自负载的 "type" 字段
+ *   <prefix>/response        → 命令的 ACK/错误响应
+ *
+ * 状态只在变化时发布：每 MQTT_BATCH_INTERVAL 对比一次快照，
+ * 同一窗口内的多项变化合并为一批发布。
+ *
+ * 本地测试：
+ *   mosquitto -v
+ *   mosquitto_sub -t 'neoclock/#' -v
+ *   mosquitto_pub -t neoclock/cmd/setBrightness -m '{"value":30}'
+ */
+
+#ifndef MQTT_MANAGER_H
+#define MQTT_MANAGER_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <PubSubClient.h>
+#include <WiFi.h>
+#include <atomic>
+
+// ==================================================================
+// MQTT 配置
+// ==================================================================
+
+/// 默认 Broker 端口
+#define MQTT_DEFAULT_PORT 1883
+
+/// 默认主题前缀
+#define MQTT_DEFAULT_PREFIX "neoclock"
+
+/// 状态变化检查/批量发布间隔 (毫秒)
+#define MQTT_BATCH_INTERVAL 500
+
+/// 重连退避：初始间隔 (毫秒)，每次失败翻倍
+#define MQTT_RECONNECT_MIN 1000
+
+/// 重连退避：最大间隔 (毫秒)
+#define MQTT_RECONNECT_MAX 60000
+
+/// TCP 连接超时 (毫秒)，在连接任务中等待，不阻塞渲染
+#define MQTT_CONNECT_TIMEOUT 3000
+
+/// 等待 CONNACK 的超时 (秒)
+#define MQTT_SOCKET_TIMEOUT 1
+
+/// 连接任务栈大小 (字节)，任务只在一次连接尝试期间存在
+#define MQTT_CONNECT_STACK 4096
+
+/// 心跳间隔 (秒)
+#define MQTT_KEEPALIVE 30
+
+/// 收发缓冲区大小 (命令负载 + 主题的上限)
+#define MQTT_BUFFER_SIZE 1024
+
+// ==================================================================
+// MQTT 管理器类
+// ==================================================================
+
+/**
+ * @class MqttManager_
+ * @brief MQTT 客户端管理器
+ *
+ * 在主循环中调用 tick()，仅在 WiFi 已连接时有效。
+ * DNS 解析、TCP 连接和 MQTT 握手都可能阻塞数秒，放在一个临时连接任务中
+ * 完成；tick() 只启动任务、轮询结果，连接建立后由主循环完成订阅与首次发布。
+ * 连接任务运行期间主循环不访问 _client。
+ * Broker 地址解析一次后缓存，直到 DNS 解析失败或 host 配置变化。
+ * 连接失败后按指数退避重试。
+ */
+class MqttManager_
+{
+public:
+  static MqttManager_ &getInstance();
+
+  /// 读取已保存的 Broker 配置
+  void setup();
+
+  /// 主循环 - 重连、收包、批量发布状态变化
+  void tick();
+
+  /**
+   * @brief 校验并暂存 Broker 配置，下一次 tick() 中保存、断开并按新配置重连
+   *
+   * 可能在 MQTT 命令回调中调用，因此不在这里断开连接。
+   * @param cmd setMqttConfig 命令 (enabled/host/port/user/password/prefix，
+   *            未提供的字段保持当前值)
+   * @param error 输出: 校验失败原因
+   * @return true=已接受
+   */
+  bool configure(JsonObject cmd, String &error);
+
+  /// 是否已连接 Broker
+  bool isConnected() { return !_job && _client.connected(); }
+
+  /**
+   * @brief 输出配置与运行状态 (不含密码)
+   * @param out 目标 JSON 对象
+   */
+  void toJson(JsonObject out);
+
+private:
+  MqttManager_() {}
+
+  // Broker 配置
+  bool _enabled = false;
+  String _host;
+  uint16_t _port = MQTT_DEFAULT_PORT;
+  String _user;
+  String _password;
+  String _prefix = MQTT_DEFAULT_PREFIX;
+
+  /// 已发布状态快照 (用于变化检测)
+  struct Snapshot
+  {
+    int16_t temp10;      ///< 室内温度 ×10
+    int16_t hum10;       ///< 室内湿度 ×10
+    uint8_t brightness;  ///< 亮度 (0-100)
+    uint8_t ldr;         ///< LDR 亮度 (0-100)
+    bool power;          ///< 电源状态
+    bool autoBrightness; ///< 自动亮度
+    bool autoPlay;       ///< 自动轮播
+    String app;          ///< 当前应用
+  };
+
+  WiFiClient _net;
+  PubSubClient _client;
+  String _clientId;
+
+  IPAddress _brokerIp;
+  bool _resolved = false;
+
+  /// configure() 暂存、tick() 应用的配置
+  struct BrokerConfig
+  {
+    bool enabled;
+    String host;
+    uint16_t port;
+    String user;
+    String password;
+    String prefix;
+  };
+  BrokerConfig _pendingConfig;
+  bool _configPending = false;
+
+  /// 一次连接尝试 (主循环创建，连接任务填写结果，主循环在 done 后释放)
+  struct ConnectJob
+  {
+    String host;
+    uint16_t port;
+    String clientId;
+    String user;
+    String password;
+    String willTopic;
+    IPAddress ip;      ///< 输入: 缓存的地址；输出: 解析结果
+    bool resolved;     ///< 输入/输出: ip 是否有效
+    bool tcpConnected; ///< 输出: TCP 连接成功
+    bool connected;    ///< 输出: MQTT 握手成功
+    int state;         ///< 输出: PubSubClient 状态码
+    uint32_t generation; ///< 创建时的配置代数
+    std::atomic<bool> done{false};
+  };
+  ConnectJob *_job = nullptr;  ///< 进行中的连接尝试 (nullptr=无)
+  uint32_t _generation = 0;    ///< 配置代数，configure() 递增
+
+  unsigned long _nextAttempt = 0;
+  unsigned long _backoff = MQTT_RECONNECT_MIN;
+  unsigned long _lastBatch = 0;
+
+  Snapshot _published = {};
+  bool _hasPublished = false;
+
+  uint32_t _connects = 0;
+  uint32_t _publishes = 0;
+  uint32_t _commands = 0;
+
+  void _saveConfig();
+  void _applyConfig();
+  void _startConnect();
+  void _finishConnect();
+  static void _connectTask(void *param);
+  void _takeSnapshot(Snapshot &s);
+  void _publishChanges(bool force);
+  bool _publish(const char *suffix, const char *payload, bool retained);
+  void _onMessage(char *topic, uint8_t *payload, unsigned int length);
+};
+
+extern MqttManager_ &MqttManager;
+
+#endif
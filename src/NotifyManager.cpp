@@ -0,0 +1,239 @@
+/**
+ * @file NotifyManager.cpp
+ * @brief 通知队列实现 — 无锁入队、优先级抢占、渲染
+ */
+
+#include "NotifyManager.h"
+#include "Globals.h"
+#include "Logger.h"
+#include "Tools.h"
+
+// ==================================================================
+// 单例
+// ==================================================================
+
+NotifyManager_ &NotifyManager_::getInstance()
+{
+  static NotifyManager_ instance;
+  return instance;
+}
+
+NotifyManager_ &NotifyManager = NotifyManager_::getInstance();
+
+NotifyManager_::NotifyManager_()
+{
+  for (uint8_t i = 0; i < NOTIFY_POOL_SIZE; i++)
+    _free.push(i);
+}
+
+// ==================================================================
+// 网络侧
+// ==================================================================
+
+/**
+ * @brief 入队一条通知
+ *
+ * 从空闲队列取一个池槽，填好内容 (含文字排版) 后放入提交队列。
+ * 池满时直接丢弃新通知，保证突发下内存有界。
+ */
+bool NotifyManager_::enqueue(JsonObject cmd, String &error)
+{
+  JsonVariantConst text = cmd["text"];
+  if (text.isNull() || (text.is<const char *>() && !*text.as<const char *>()))
+  {
+    error = "missing text";
+    return false;
+  }
+
+  uint8_t index;
+  if (!_free.pop(index))
+  {
+    _dropped++;
+    error = "queue full";
+    LOG_WARN("[Notify] 通知队列已满，丢弃 (累计 %lu)", (unsigned long)_dropped);
+    return false;
+  }
+
+  Notification &n = _pool[index];
+  n.priority = cmd["priority"] | 0;
+  n.seq = _seq++;
+  n.icon[0] = '\0';
+  n.systemIcon = -1;
+  const char *icon = cmd["icon"] | "";
+  if (*icon >= '0' && *icon <= '9')
+  {
+    int sys = atoi(icon);
+    if (sys < (int)(sizeof(ICON_LIB) / sizeof(ICON_LIB[0])))
+      n.systemIcon = sys;
+  }
+  else
+  {
+    strncpy(n.icon, icon, NOTIFY_ICON_LEN - 1);
+    n.icon[NOTIFY_ICON_LEN - 1] = '\0';
+  }
+  n.color = cmd.containsKey("color") ? HEXtoColor(cmd["color"] | "") : TEXTCOLOR_565;
+  n.duration = cmd["duration"] | NOTIFY_DEFAULT_DURATION;
+  if (n.duration == 0)
+    n.duration = NOTIFY_DEFAULT_DURATION;
+  n.repeat = cmd["repeat"] | 1;
+  if (n.repeat == 0)
+    n.repeat = 1;
+  n.sticky = cmd["sticky"] | false;
+  n.blink = cmd["blink"] | 0;
+
+  bool hasIcon = n.systemIcon >= 0 || n.icon[0] != '\0';
+  int16_t areaX = hasIcon ? 9 : 0;
+  n.text.setSpeed(cmd["scrollSpeed"] | (float)MARQUEE_DEFAULT_SPEED);
+  n.text.clear();
+  n.text.appendJson(text, n.color);
+  n.text.reflow(areaX, MATRIX_WIDTH - areaX);
+
+  // 提交队列容量大于池大小，不会失败
+  _submit.push(index);
+  return true;
+}
+
+void NotifyManager_::dismiss()
+{
+  _dismissRequests.fetch_add(1, std::memory_order_release);
+}
+
+void NotifyManager_::toJson(JsonObject out)
+{
+  out["pool"] = NOTIFY_POOL_SIZE;
+  out["active"] = _current >= 0;
+  out["pending"] = _pendingCount;
+  out["shown"] = _shown;
+  out["dropped"] = _dropped;
+}
+
+// ==================================================================
+// 渲染侧
+// ==================================================================
+
+/// 按 (优先级降序, 序号升序) 插入待显示数组
+void NotifyManager_::_insertPending(uint8_t index)
+{
+  const Notification &n = _pool[index];
+  uint8_t pos = _pendingCount;
+  while (pos > 0)
+  {
+    const Notification &prev = _pool[_pending[pos - 1]];
+    if (prev.priority > n.priority ||
+        (prev.priority == n.priority && prev.seq < n.seq))
+      break;
+    _pending[pos] = _pending[pos - 1];
+    pos--;
+  }
+  _pending[pos] = index;
+  _pendingCount++;
+}
+
+/// 取走新提交的通知，并处理抢占
+void NotifyManager_::_collect()
+{
+  uint8_t index;
+  while (_submit.pop(index))
+    _insertPending(index);
+
+  if (_pendingCount == 0)
+    return;
+
+  if (_current < 0)
+  {
+    uint8_t next = _pending[0];
+    memmove(_pending, _pending + 1, --_pendingCount);
+    _show(next);
+  }
+  else if (_pool[_pending[0]].priority > _pool[_current].priority)
+  {
+    // 更高优先级抢占：当前通知放回待显示，稍后重新开始
+    uint8_t next = _pending[0];
+    memmove(_pending, _pending + 1, --_pendingCount);
+    _insertPending(_current);
+    _show(next);
+  }
+}
+
+void NotifyManager_::_show(uint8_t index)
+{
+  _current = index;
+  _shownAt = millis();
+  _shown++;
+}
+
+void NotifyManager_::_finish()
+{
+  _free.push(_current);
+  _current = -1;
+}
+
+/**
+ * @brief 渲染当前通知
+ *
+ * 有通知时设置 state->overlayActive，MatrixDisplayUi 据此暂停轮播、
+ * 跳过应用绘制；通知全部结束后自动恢复。
+ */
+void NotifyManager_::render(FastLED_NeoMatrix *matrix,
+                            MatrixDisplayUiState *state,
+                            FastFramePlayer *player)
+{
+  // dismiss 请求 (网络侧只增计数，这里消费)
+  uint32_t requests = _dismissRequests.load(std::memory_order_acquire);
+  if (requests != _dismissHandled)
+  {
+    _dismissHandled = requests;
+    if (_current >= 0)
+      _finish();
+  }
+
+  _collect();
+  if (_current < 0)
+    return;
+
+  const Notification &n = _pool[_current];
+  uint32_t elapsed = millis() - _shownAt;
+
+  // 结束判定: 滚动文字按圈数，静态文字按时长；常驻通知不自动结束
+  uint32_t total = n.text.scroll ? n.text.cycleMs() * n.repeat
+                                 : (uint32_t)n.duration * n.repeat;
+  if (!n.sticky && elapsed >= total)
+  {
+    _finish();
+    _collect();
+    if (_current < 0)
+      return;
+    render(matrix, state, player);
+    return;
+  }
+
+  state->overlayActive = true;
+  matrix->fillScreen(0);
+
+  // 闪烁: 一个周期 blink ms，前半亮、后半灭
+  uint16_t blinkHalf = (n.blink + 1) / 2;
+  uint32_t blinkPhase = n.blink ? elapsed % n.blink : 0;
+  bool visible = n.blink == 0 || blinkPhase < blinkHalf;
+
+  // 帧率: 滚动按最高帧率，闪烁按翻转时刻，静态文字在结束时刻重绘
+  if (n.text.scroll)
+    state->requestFrame(0, FRAME_SCROLL);
+  if (n.blink)
+    state->requestFrame(visible ? blinkHalf - blinkPhase : n.blink - blinkPhase,
+                        FRAME_CONTENT);
+  if (!n.sticky)
+    state->requestFrame(total - elapsed, FRAME_CONTENT);
+
+  if (visible)
+    n.text.draw(matrix, 0, 0, elapsed);
+
+  if (n.text.areaX > 0)
+  {
+    matrix->fillRect(0, 0, n.text.areaX, 8, 0);
+    if (n.systemIcon >= 0)
+      player->loadSystem(n.systemIcon);
+    else
+      player->loadUser(n.icon);
+    player->play(0, 0);
+  }
+}
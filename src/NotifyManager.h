@@ -0,0 +1,160 @@
+/**
+ * @file NotifyManager.h
+ * @brief 通知队列 — 优先级队列 + 预分配池，由 NotifyOverlay 渲染
+ *
+ * 本文件定义：
+ *   - Notification 结构体: 单条通知 (文字、图标、颜色、重复、常驻、闪烁)
+ *   - NotifyManager_ 单例类: 入队 (网络侧) 与渲染 (渲染侧)
+ *
+ * 内存与并发：
+ *   - 通知存放在固定大小的池中 (NOTIFY_POOL_SIZE)，突发时池满即丢弃并计数，
+ *     内存占用始终有界
+ *   - 网络侧与渲染侧之间只通过两个单生产者/单消费者环形队列交换池索引：
+ *       空闲队列 (渲染侧归还 → 网络侧取用)
+ *       提交队列 (网络侧提交 → 渲染侧取走)
+ *     两侧都不加锁，渲染侧不会因网络处理而等待
+ *   - 优先级排序只在渲染侧进行 (私有待显示数组)
+ *
+ * 显示：
+ *   - 有通知时覆盖整屏并暂停应用轮播，全部显示完毕后恢复
+ *   - 更高优先级的通知会抢占当前通知，被抢占的通知稍后重新显示
+ *   - 常驻 (sticky) 通知保持显示，直到 dismiss
+ */
+
+#ifndef NOTIFY_MANAGER_H
+#define NOTIFY_MANAGER_H
+
+#include "FastFramePlayer.h"
+#include "MatrixDisplayUi.h"
+#include "Marquee.h"
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <atomic>
+
+// ==================================================================
+// 通知配置
+// ==================================================================
+
+/// 通知池大小 (同时排队的最大通知数)
+#define NOTIFY_POOL_SIZE 8
+
+/// 环形队列容量 (2 的幂，大于池大小)
+#define NOTIFY_RING_SIZE 16
+
+/// 图标文件名最大长度 (含结尾 '\0')
+#define NOTIFY_ICON_LEN 32
+
+/// 不滚动的通知默认显示时长 (毫秒，每次重复)
+#define NOTIFY_DEFAULT_DURATION 5000
+
+// ==================================================================
+// 通知
+// ==================================================================
+
+/// 单条通知 (定长，存放在池中)
+struct Notification
+{
+  uint8_t priority;           ///< 优先级 (越大越优先)
+  uint32_t seq;               ///< 入队序号 (同优先级先进先出)
+  char icon[NOTIFY_ICON_LEN]; ///< 用户图标文件名 (空=无图标)
+  int16_t systemIcon;         ///< 内置图标索引 (-1=无)
+  uint16_t color;             ///< 文字颜色 (RGB565)
+  uint16_t duration;          ///< 不滚动时每次显示时长 (ms)
+  uint8_t repeat;             ///< 重复次数 (滚动文字=滚动圈数)
+  bool sticky;                ///< 常驻，直到 dismiss
+  uint16_t blink;             ///< 闪烁周期 (ms，前半亮、后半灭，0=不闪烁)
+  Marquee text;               ///< 预渲染的文字
+};
+
+/// 单生产者/单消费者环形队列 (存放池索引)
+class NotifyRing
+{
+public:
+  bool push(uint8_t index)
+  {
+    uint8_t tail = _tail.load(std::memory_order_relaxed);
+    uint8_t next = (tail + 1) & (NOTIFY_RING_SIZE - 1);
+    if (next == _head.load(std::memory_order_acquire))
+      return false; // 满
+    _items[tail] = index;
+    _tail.store(next, std::memory_order_release);
+    return true;
+  }
+
+  bool pop(uint8_t &index)
+  {
+    uint8_t head = _head.load(std::memory_order_relaxed);
+    if (head == _tail.load(std::memory_order_acquire))
+      return false; // 空
+    index = _items[head];
+    _head.store((head + 1) & (NOTIFY_RING_SIZE - 1), std::memory_order_release);
+    return true;
+  }
+
+private:
+  uint8_t _items[NOTIFY_RING_SIZE];
+  std::atomic<uint8_t> _head{0};
+  std::atomic<uint8_t> _tail{0};
+};
+
+// ==================================================================
+// 通知管理器类
+// ==================================================================
+
+/**
+ * @class NotifyManager_
+ * @brief 通知队列管理器
+ */
+class NotifyManager_
+{
+public:
+  static NotifyManager_ &getInstance();
+
+  /**
+   * @brief 入队一条通知 (网络侧调用)
+   * @param cmd notify 命令 (text, icon, color, duration, repeat, sticky, blink, priority)
+   *            text 为字符串或多段颜色数组 [{t, c}, ...]，可选 scrollSpeed
+   * @param error 输出: 失败原因
+   * @return true=已入队
+   */
+  bool enqueue(JsonObject cmd, String &error);
+
+  /// 关闭当前通知 (网络侧/按键调用，渲染侧下一帧生效)
+  void dismiss();
+
+  /// 渲染当前通知 (由 NotifyOverlay 调用)
+  void render(FastLED_NeoMatrix *matrix, MatrixDisplayUiState *state,
+              FastFramePlayer *player);
+
+  /// 输出队列状态
+  void toJson(JsonObject out);
+
+private:
+  NotifyManager_();
+
+  Notification _pool[NOTIFY_POOL_SIZE];
+  NotifyRing _free;   ///< 空闲池索引 (渲染侧 → 网络侧)
+  NotifyRing _submit; ///< 已提交的池索引 (网络侧 → 渲染侧)
+
+  // --- 网络侧 ---
+  uint32_t _seq = 0;
+  uint32_t _dropped = 0;
+  std::atomic<uint32_t> _dismissRequests{0};
+
+  // --- 渲染侧 ---
+  uint8_t _pending[NOTIFY_POOL_SIZE]; ///< 待显示 (按优先级降序)
+  uint8_t _pendingCount = 0;
+  int8_t _current = -1;               ///< 正在显示的池索引
+  unsigned long _shownAt = 0;
+  uint32_t _dismissHandled = 0;
+  uint32_t _shown = 0;
+
+  void _collect();
+  void _insertPending(uint8_t index);
+  void _show(uint8_t index);
+  void _finish();
+};
+
+extern NotifyManager_ &NotifyManager;
+
+#endif
@@ -0,0 +1,27 @@
+/**
+ * @file OffscreenCanvas.cpp
+ * @brief 离屏画布实现 — GFX 对象初始化、绘制目标登记
+ */
+
+#include "OffscreenCanvas.h"
+#include "AwtrixFont.h"
+#include "ColorDraw.h"
+
+OffscreenCanvas::OffscreenCanvas()
+    : _gfx(_pixels, WIDTH, HEIGHT, OffscreenLayout::MATRIX_TYPE)
+{
+  // 不调用 begin()/show()：画布不接 LED，也不改全局亮度
+  _gfx.setRemapFunction(canvasRemap<OffscreenLayout>);
+  _gfx.setTextWrap(false);
+  _gfx.setFont(&AwtrixFont);
+  colorDrawBind(&_gfx, _pixels);
+  clear();
+}
+
+OffscreenCanvas::~OffscreenCanvas() { colorDrawUnbind(&_gfx); }
+
+void OffscreenCanvas::clear()
+{
+  for (CRGB &c : _pixels)
+    c = CRGB(0, 0, 0);
+}
@@ -0,0 +1,76 @@
+/**
+ * @file OffscreenCanvas.h
+ * @brief 离屏画布 — 与显示屏同尺寸的 CRGB 缓冲区，可作为应用的绘制目标
+ *
+ * 本文件定义：
+ *   - OffscreenLayout: 离屏缓冲区布局 (单块、逐行，序号 = y × 宽 + x)
+ *   - OffscreenCanvas 类: 像素缓冲区 + GFX 兼容的绘制对象
+ *
+ * gfx() 是一个指向本画布缓冲区的 FastLED_NeoMatrix (字体、换行设置与
+ * 显示屏一致)，AppCallback 可以直接把它当作 matrix 参数绘制。
+ * 应用里经 DisplayManager 绘制的文字也要进入画布时，用
+ * DisplayManager.renderToCanvas()，它在渲染期间把绘制目标切到画布。
+ *
+ * 画布在 ColorDraw 中登记了缓冲区，PixelTarget(gfx()) 直接写画布像素。
+ *
+ * 画布内容用 DisplayManager.blit() / composite() 带偏移、裁剪地
+ * 复制或叠加到显示缓冲区，可用于预渲染、缓存和预览。
+ *
+ * 内存: 像素 MATRIX_WIDTH × MATRIX_HEIGHT × 3 字节 (32×8 为 768 字节)，
+ * 加一个 GFX 对象。不可复制。
+ */
+
+#ifndef OFFSCREEN_CANVAS_H
+#define OFFSCREEN_CANVAS_H
+
+#include "Canvas.h"
+#include "Globals.h"
+#include <FastLED.h>
+#include <FastLED_NeoMatrix.h>
+
+/// 离屏缓冲区布局: 单块、从左上角逐行
+typedef MatrixLayout<MATRIX_WIDTH, MATRIX_HEIGHT, 1, 1,
+                     NEO_MATRIX_TOP + NEO_MATRIX_LEFT + NEO_MATRIX_ROWS +
+                         NEO_MATRIX_PROGRESSIVE>
+    OffscreenLayout;
+
+/**
+ * @class OffscreenCanvas
+ * @brief 离屏画布
+ */
+class OffscreenCanvas
+{
+public:
+  static constexpr int16_t WIDTH = OffscreenLayout::WIDTH;
+  static constexpr int16_t HEIGHT = OffscreenLayout::HEIGHT;
+
+  OffscreenCanvas();
+  ~OffscreenCanvas();
+  OffscreenCanvas(const OffscreenCanvas &) = delete;
+  OffscreenCanvas &operator=(const OffscreenCanvas &) = delete;
+
+  /// GFX 兼容的绘制对象 (AppCallback 的 matrix 参数)
+  FastLED_NeoMatrix *gfx() { return &_gfx; }
+
+  /// 直接访问缓冲区的画布 (非虚函数，内联寻址)
+  Canvas<OffscreenLayout> view() { return Canvas<OffscreenLayout>(_pixels); }
+
+  /// 像素缓冲区 (逐行，WIDTH × HEIGHT 个)
+  const CRGB *pixels() const { return _pixels; }
+
+  CRGB getPixel(int16_t x, int16_t y) const
+  {
+    return Canvas<OffscreenLayout>::contains(x, y)
+               ? _pixels[OffscreenLayout::XY(x, y)]
+               : CRGB(0, 0, 0);
+  }
+
+  /// 清空为黑色
+  void clear();
+
+private:
+  CRGB _pixels[WIDTH * HEIGHT];
+  FastLED_NeoMatrix _gfx;
+};
+
+#endif
@@ -11,6 +11,7 @@
 
 #include "PeripheryManager.h"
 #include "Apps.h"
+#include "BootTimeline.h"
 #include "DisplayManager.h"
 #include "Globals.h"
 #include "Logger.h"
@@ -129,7 +130,9 @@ void PeripheryManager_::setup()
 
   // 首次读取 DHT22
   LOG_INFO("[Periphery] 测试读取DHT22传感器...");
+  BootTimeline.phaseBegin(BOOT_PHASE_DHT);
   readDHT22();
+  BootTimeline.phaseEnd(BOOT_PHASE_DHT);
 
   if (sensorAvailable)
   {
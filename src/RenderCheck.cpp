@@ -0,0 +1,292 @@
+/**
+ * @file RenderCheck.cpp
+ * @brief 渲染检查实现 — 输入注入、抓帧、基准帧读写与比对
+ */
+
+#include "RenderCheck.h"
+#include "Apps.h"
+#include "ClockService.h"
+#include "DisplayManager.h"
+#include "FastFramePlayer.h"
+#include "Globals.h"
+#include "Logger.h"
+#include "OffscreenCanvas.h"
+#include <LittleFS.h>
+
+/// 一帧的字节数 (RGB888)
+#define RENDER_FRAME_BYTES (NUM_LEDS * 3)
+
+/// 内置应用
+static const struct
+{
+  const char *name;
+  AppCallback callback;
+} APPS[] = {{"app_time", TimeApp},       {"app_date", DateApp},
+            {"app_temp", TempApp},       {"app_hum", HumApp},
+            {"app_weather", WeatherApp}, {"app_wind", WindApp}};
+
+/// 状态画面
+static const struct
+{
+  const char *name;
+  DisplayStatus status;
+} STATUSES[] = {{"status_ap", DISPLAY_AP_MODE},
+                {"status_connecting", DISPLAY_CONNECTING},
+                {"status_connected", DISPLAY_CONNECTED},
+                {"status_failed", DISPLAY_CONNECT_FAILED},
+                {"status_boot", DISPLAY_BOOT}};
+
+/// 抓帧缓冲区
+static uint8_t captured[RENDER_FRAME_BYTES];
+
+/**
+ * @brief 合成音频: 直流 2048 + 四个正好落在 FFT 频点上的正弦
+ *
+ * 频点 8/20/45/80 分别落在第 0/5/17/29 条频谱，幅度递减，
+ * 各条高度覆盖满格到一两格。
+ */
+static double syntheticAudio(int index)
+{
+  static const struct
+  {
+    uint8_t bin;
+    uint8_t amplitude;
+  } TONES[] = {{8, 16}, {20, 10}, {45, 6}, {80, 3}};
+  double v = 2048.0;
+  for (const auto &t : TONES)
+    v += t.amplitude * sin(2.0 * PI * t.bin * index / 512.0);
+  return v;
+}
+
+/// 画布像素 → 抓帧缓冲区 (画布本身按逻辑坐标逐行排列)
+static void captureCanvas(const OffscreenCanvas &canvas)
+{
+  const CRGB *px = canvas.pixels();
+  uint8_t *out = captured;
+  for (uint16_t i = 0; i < NUM_LEDS; i++)
+  {
+    *out++ = px[i].r;
+    *out++ = px[i].g;
+    *out++ = px[i].b;
+  }
+}
+
+/// FNV-1a (报告用，便于主机端核对)
+static uint32_t frameHash(const uint8_t *data, size_t len)
+{
+  uint32_t h = 2166136261UL;
+  for (size_t i = 0; i < len; i++)
+    h = (h ^ data[i]) * 16777619UL;
+  return h;
+}
+
+static bool selected(const char *name, const char *only)
+{
+  return !only || !*only || strstr(name, only);
+}
+
+// ==================================================================
+// 单例
+// ==================================================================
+
+RenderCheck_ &RenderCheck_::getInstance()
+{
+  static RenderCheck_ instance;
+  return instance;
+}
+
+RenderCheck_ &RenderCheck = RenderCheck_::getInstance();
+
+// ==================================================================
+// 运行
+// ==================================================================
+
+int RenderCheck_::run(JsonObject out, const char *only, bool update)
+{
+  OffscreenCanvas *canvas = new OffscreenCanvas();
+  MatrixDisplayUiState state;
+
+  // 保存被注入的全局状态
+  float indoorTemp = INDOOR_TEMP, indoorHum = INDOOR_HUM;
+  float outdoorTemp = OUTDOOR_TEMP, windSpeed = WEATHER_WIND_SPEED;
+  String weather = CURRENT_WEATHER, currentApp = CURRENT_APP;
+  bool spectrumActive = SPECTRUM_ACTIVE;
+  int spectrumMode = spectrumGetMode();
+
+  ClockService.freeze(RENDER_EPOCH);
+  INDOOR_TEMP = 23.6f;
+  INDOOR_HUM = 47.0f;
+  OUTDOOR_TEMP = -3.4f;
+  WEATHER_WIND_SPEED = 5.5f;
+  CURRENT_WEATHER = "Clouds";
+
+  if (update)
+    LittleFS.mkdir(RENDER_GOLDEN_DIR);
+
+  out["epoch"] = RENDER_EPOCH;
+  JsonArray results = out.createNestedArray("results");
+  int mismatched = 0;
+
+  // 1. 内置应用 (渲染到离屏画布；每个应用一个新的播放器，图标从第 0 帧开始)
+  for (const auto &app : APPS)
+  {
+    if (!selected(app.name, only))
+      continue;
+    FastFramePlayer *player = new FastFramePlayer();
+    DisplayManager.renderToCanvas(app.callback, *canvas, player, &state);
+    delete player;
+    captureCanvas(*canvas);
+    Result r = _compare(app.name, captured, update);
+    mismatched += r.diffPixels > 0;
+    _report(results, app.name, captured, r);
+  }
+
+  // 2. 状态画面 (渲染到离屏画布；冻结状态画面时钟)
+  DisplayManager_ &dm = DisplayManager;
+  DisplayStatus status = dm._state.status;
+  String line1 = dm._state.line1, line2 = dm._state.line2;
+  unsigned long startTime = dm._state.startTime;
+  unsigned long lastAnimTime = dm._state.lastAnimTime;
+  uint8_t animFrame = dm._state.animFrame;
+
+  bool statusRendered = false;
+  dm._clockFrozen = true;
+  for (const auto &s : STATUSES)
+  {
+    if (!selected(s.name, only))
+      continue;
+    statusRendered = true;
+    dm._frozenMs = 0;
+    dm.setDisplayStatus(s.status, "NeoClock", "192.168.4.1");
+    dm._frozenMs = RENDER_STATUS_ELAPSED_MS;
+    dm._renderStatusToCanvas(*canvas);
+    captureCanvas(*canvas);
+    Result r = _compare(s.name, captured, update);
+    mismatched += r.diffPixels > 0;
+    _report(results, s.name, captured, r);
+  }
+  dm._clockFrozen = false;
+  if (statusRendered)
+  {
+    dm.setDisplayStatus(status, line1, line2);
+    dm._state.startTime = startTime;
+    dm._state.lastAnimTime = lastAnimTime;
+    dm._state.animFrame = animFrame;
+  }
+
+  // 3. 频谱各模式 (渲染到离屏画布；合成音频，清空峰值历史)
+  SPECTRUM_ACTIVE = true;
+  spectrumInjectInput(syntheticAudio);
+  char name[24];
+  for (int mode = 0; spectrumSetMode(mode); mode++)
+  {
+    snprintf(name, sizeof(name), "spectrum_%d", mode);
+    if (!selected(name, only))
+      continue;
+    spectrumReset();
+    canvas->clear();
+    SpectrumOverlay(canvas->gfx(), &state, nullptr);
+    captureCanvas(*canvas);
+    Result r = _compare(name, captured, update);
+    mismatched += r.diffPixels > 0;
+    _report(results, name, captured, r);
+  }
+  spectrumInjectInput(nullptr);
+  spectrumSetMode(spectrumMode);
+  spectrumReset();
+  SPECTRUM_ACTIVE = spectrumActive;
+  delete canvas;
+
+  // 恢复
+  INDOOR_TEMP = indoorTemp;
+  INDOOR_HUM = indoorHum;
+  OUTDOOR_TEMP = outdoorTemp;
+  WEATHER_WIND_SPEED = windSpeed;
+  CURRENT_WEATHER = weather;
+  CURRENT_APP = currentApp;
+  ClockService.thaw();
+  ClockService.tick();
+
+  out["checked"] = results.size();
+  out["mismatched"] = mismatched;
+  if (mismatched > 0)
+    LOG_WARN("[Render] %d 个画面与基准帧不一致", mismatched);
+  else
+    LOG_INFO("[Render] 检查 %d 个画面%s", (int)results.size(),
+             update ? "，已更新基准帧" : "");
+  return mismatched;
+}
+
+// ==================================================================
+// 基准帧
+// ==================================================================
+
+RenderCheck_::Result RenderCheck_::_compare(const char *name,
+                                            const uint8_t *frame, bool update)
+{
+  char path[48];
+  snprintf(path, sizeof(path), RENDER_GOLDEN_DIR "/%s.rgb", name);
+
+  if (update)
+  {
+    File f = LittleFS.open(path, "w");
+    bool ok = f && f.write(frame, RENDER_FRAME_BYTES) == RENDER_FRAME_BYTES;
+    if (f)
+      f.close();
+    if (!ok)
+      LOG_ERROR("[Render] 写入基准帧失败: %s", path);
+    return {ok ? "updated" : "writeFailed", 0, -1};
+  }
+
+  if (!LittleFS.exists(path))
+    return {"missing", 0, -1};
+
+  File f = LittleFS.open(path, "r");
+  if (!f || f.size() != RENDER_FRAME_BYTES)
+  {
+    if (f)
+      f.close();
+    return {"mismatch", NUM_LEDS, 0};
+  }
+
+  // 按 16 像素分块读取比对
+  Result r = {"match", 0, -1};
+  uint8_t chunk[48];
+  for (uint16_t offset = 0; offset < RENDER_FRAME_BYTES; offset += sizeof(chunk))
+  {
+    f.read(chunk, sizeof(chunk));
+    for (uint8_t i = 0; i < sizeof(chunk); i += 3)
+    {
+      if (memcmp(chunk + i, frame + offset + i, 3) == 0)
+        continue;
+      if (r.firstDiff < 0)
+        r.firstDiff = (offset + i) / 3;
+      r.diffPixels++;
+    }
+  }
+  f.close();
+  if (r.diffPixels > 0)
+    r.status = "mismatch";
+  return r;
+}
+
+void RenderCheck_::_report(JsonArray results, const char *name,
+                           const uint8_t *frame, const Result &r)
+{
+  char hash[9];
+  snprintf(hash, sizeof(hash), "%08lx",
+           (unsigned long)frameHash(frame, RENDER_FRAME_BYTES));
+
+  JsonObject o = results.createNestedObject();
+  o["name"] = (char *)name; // 频谱名称在栈上，需要复制
+  o["result"] = r.status;
+  o["hash"] = (char *)hash;
+  if (r.diffPixels > 0)
+  {
+    o["diffPixels"] = r.diffPixels;
+    o["firstDiffX"] = r.firstDiff % MATRIX_WIDTH;
+    o["firstDiffY"] = r.firstDiff / MATRIX_WIDTH;
+    LOG_WARN("[Render] %s: %d 个像素不一致，首个 (%d,%d)", name, r.diffPixels,
+             r.firstDiff % MATRIX_WIDTH, r.firstDiff / MATRIX_WIDTH);
+  }
+}
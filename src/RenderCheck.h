@@ -0,0 +1,78 @@
+/**
+ * @file RenderCheck.h
+ * @brief 渲染检查 — 以固定输入渲染各画面，与 LittleFS 中的基准帧逐像素比对
+ *
+ * 本文件定义：
+ *   - RenderCheck_ 单例类: 注入输入、渲染、抓帧、与基准帧比对/更新
+ *
+ * 覆盖范围：
+ *   - Apps.cpp 中的内置应用 (时间、日期、温度、湿度、天气、风速)
+ *   - DisplayManager_ 的状态画面 (AP 配网、连接中、连接成功、连接失败、启动)
+ *   - 频谱覆盖层的全部模式 (合成音频输入，跳过麦克风采样)
+ *
+ * 注入的输入：ClockService 冻结在 RENDER_EPOCH，状态画面时钟冻结在
+ * 状态切换后 RENDER_STATUS_ELAPSED_MS，温湿度/天气/风速取固定值。
+ * 应用、状态画面与频谱都渲染到离屏画布 (渲染期间把绘制目标切到画布)，
+ * 显示缓冲区不被改动；结束后恢复所有被修改的状态。
+ *
+ * 基准帧保存在 RENDER_GOLDEN_DIR/<名称>.rgb (32×8×3 字节，按逻辑坐标
+ * 行优先排列)。颜色类设置 (TIME_COLOR 等) 会影响画面，修改后需重新更新基准。
+ *
+ * 用法 (WebSocket / HTTP API)：
+ *   {type:"renderCheck"}                  与基准帧比对
+ *   {type:"renderCheck", update:true}     把本次渲染保存为新的基准帧
+ *   {type:"renderCheck", only:"spectrum"} 只检查名称包含该字符串的画面
+ */
+
+#ifndef RENDER_CHECK_H
+#define RENDER_CHECK_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+
+/// 基准帧目录
+#define RENDER_GOLDEN_DIR "/golden"
+
+/// 冻结的时间 (2026-03-14 09:26:53 UTC+8，周六)
+#define RENDER_EPOCH 1773451613
+
+/// 状态画面冻结在切换后的毫秒数
+#define RENDER_STATUS_ELAPSED_MS 1200
+
+/**
+ * @class RenderCheck_
+ * @brief 基准帧渲染检查
+ */
+class RenderCheck_
+{
+public:
+  static RenderCheck_ &getInstance();
+
+  /**
+   * @brief 渲染并比对 (阻塞，频谱每个模式约一次 FFT)
+   * @param out 结果 JSON
+   * @param only 只检查名称包含该字符串的画面 (nullptr/空=全部)
+   * @param update 把本次渲染保存为基准帧
+   * @return 与基准帧不一致的画面数 (缺少基准帧不计入)
+   */
+  int run(JsonObject out, const char *only, bool update);
+
+private:
+  RenderCheck_() = default;
+
+  /// 单个画面的比对结果
+  struct Result
+  {
+    const char *status;  ///< match / mismatch / missing / updated / writeFailed
+    uint16_t diffPixels; ///< 不一致的像素数
+    int16_t firstDiff;   ///< 第一个不一致像素的序号 (y*宽+x，-1=无)
+  };
+
+  Result _compare(const char *name, const uint8_t *frame, bool update);
+  void _report(JsonArray results, const char *name, const uint8_t *frame,
+               const Result &r);
+};
+
+extern RenderCheck_ &RenderCheck;
+
+#endif
@@ -13,9 +13,22 @@
 #include "Logger.h"
 #include "ServerManager.h"
 #include "Apps.h"
+#include "Benchmark.h"
+#include "BootTimeline.h"
+#include "CustomApps.h"
 #include "DisplayManager.h"
+#include "GlyphCache.h"
+#include "HeapTelemetry.h"
 #include "Globals.h"
+#include "LedOutput.h"
+#include "LoopWatchdog.h"
+#include "MqttManager.h"
+#include "NotifyManager.h"
 #include "PeripheryManager.h"
+#include "RenderCheck.h"
+#include "StackMonitor.h"
+#include "TimeSync.h"
+#include "TimerManager.h"
 #include <ArduinoJson.h>
 
 ServerManager_ &ServerManager_::getInstance()
@@ -26,7 +39,7 @@ ServerManager_ &ServerManager_::getInstance()
 
 ServerManager_ &ServerManager = ServerManager.getInstance();
 
-// 注意：HTTP 服务器已移除，配网功能由 WebConfig 提供
+// 注意：配网功能由 WebConfig 提供，STA 模式 HTTP API 见 HttpApi (共用 dispatchCommand)
 // WebSocket 服务器保留在 81 端口用于控制面板
 
 void ServerManager_::handleWebSocketEvent(uint8_t num, WStype_t type,
@@ -189,328 +202,593 @@ void ServerManager_::handleWebSocketEvent(uint8_t num, WStype_t type,
       sendAck(num, requestId, "uploadIcon", false, "invalid phase");
       return;
     }
-    if (type == "getConfig")
-    {
+    if (!dispatchCommand(num, doc, type, requestId))
+      sendAck(num, requestId, type, false, "unknown command");
+    break;
+  }
+
+  default:
+    break;
+  }
+}
+
+/**
+ * @brief 执行一条 JSON 命令 (WebSocket 与 HTTP API 共用)
+ * @param num 客户端 ID (HTTP_CLIENT 表示来自 HTTP API)
+ * @param doc 已解析的命令
+ * @param type 命令类型
+ * @param requestId 请求 ID
+ * @return false=未知命令 (类型或 cmd 动作不存在)，未发送任何响应
+ */
+bool ServerManager_::dispatchCommand(uint8_t num, JsonDocument &doc,
+                                     const String &type,
+                                     const String &requestId)
+{
+  LoopStageScope scope(LOOP_STAGE_COMMAND, type.c_str());
+
+  if (type == "getConfig")
+  {
+    // HTTP 请求直接返回配置，WebSocket 请求广播给所有客户端
+    if (num == HTTP_CLIENT)
+      sendText(num, buildConfigJson());
+    else
       broadcastConfig();
-    }
-    else if (type == "getStats")
-    {
+  }
+  else if (type == "getStats")
+  {
+    if (num == HTTP_CLIENT)
+      sendText(num, buildStatsJson());
+    else
       broadcastStats();
-    }
-    else if (type == "getIconList")
-    {
-      sendIconList(num);
-    }
-    else if (type == "getLiveview")
-    {
-      // 启用实时预览
-      LOG_INFO("[Server] Enabling liveview");
-      EnableLiveview = true;
-    }
-    else if (type == "stopLiveview")
-    {
-      // 停止实时预览
-      EnableLiveview = false;
-    }
-    else if (type == "appsUpdate")
+  }
+  else if (type == "uploadIcon")
+  {
+    // 图标上传依赖 WebSocket 二进制帧，HTTP API 不支持
+    sendAck(num, requestId, "uploadIcon", false, "websocket only");
+  }
+  else if (type == "getIconList")
+  {
+    sendIconList(num);
+  }
+  else if (type == "getBootTimeline")
+  {
+    sendBootTimeline(num);
+  }
+  else if (type == "getLiveview")
+  {
+    // 启用实时预览
+    LOG_INFO("[Server] Enabling liveview");
+    EnableLiveview = true;
+    sendAck(num, requestId, "getLiveview", true);
+  }
+  else if (type == "stopLiveview")
+  {
+    // 停止实时预览
+    EnableLiveview = false;
+    sendAck(num, requestId, "stopLiveview", true);
+  }
+  else if (type == "appsUpdate")
+  {
+    // 处理应用更新
+    if (doc.containsKey("apps"))
     {
-      // 处理应用更新
-      if (doc.containsKey("apps"))
+      for (auto app : doc["apps"].as<JsonArray>())
       {
-        for (auto app : doc["apps"].as<JsonArray>())
-        {
-          String name = app["name"].as<String>();
-          bool show = app["show"].as<bool>();
-          int position = app.containsKey("pos") ? app["pos"].as<int>() : -1;
-          uint16_t duration =
-              app.containsKey("duration") ? app["duration"].as<int>() : 0;
+        String name = app["name"].as<String>();
+        bool show = app["show"].as<bool>();
+        int position = app.containsKey("pos") ? app["pos"].as<int>() : -1;
+        uint16_t duration =
+            app.containsKey("duration") ? app["duration"].as<int>() : 0;
 
-          if (name == "time")
-          {
-            SHOW_TIME = show;
-            TIME_DURATION = duration;
-            TIME_POSITION = position;
-            if (app.containsKey("color"))
-              TIME_COLOR = app["color"].as<String>();
-            if (app.containsKey("weekdayActive"))
-              TIME_WEEKDAY_ACTIVE_COLOR = app["weekdayActive"].as<String>();
-            if (app.containsKey("weekdayInactive"))
-              TIME_WEEKDAY_INACTIVE_COLOR = app["weekdayInactive"].as<String>();
-            if (app.containsKey("iconName"))
-              TIME_ICON = app["iconName"].as<String>();
-          }
-          else if (name == "date")
-          {
-            SHOW_DATE = show;
-            DATE_DURATION = duration;
-            DATE_POSITION = position;
-            if (app.containsKey("color"))
-              DATE_COLOR = app["color"].as<String>();
-            if (app.containsKey("weekdayActive"))
-              DATE_WEEKDAY_ACTIVE_COLOR = app["weekdayActive"].as<String>();
-            if (app.containsKey("weekdayInactive"))
-              DATE_WEEKDAY_INACTIVE_COLOR = app["weekdayInactive"].as<String>();
-            if (app.containsKey("iconName"))
-              DATE_ICON = app["iconName"].as<String>();
-          }
-          else if (name == "temp")
-          {
-            SHOW_TEMP = show;
-            TEMP_DURATION = duration;
-            TEMP_POSITION = position;
-            if (app.containsKey("color"))
-              TEMP_COLOR = app["color"].as<String>();
-          }
-          else if (name == "hum")
-          {
-            SHOW_HUM = show;
-            HUM_DURATION = duration;
-            HUM_POSITION = position;
-            if (app.containsKey("color"))
-              HUM_COLOR = app["color"].as<String>();
-          }
-          else if (name == "wind")
-          {
-            SHOW_WIND = show;
-            WIND_DURATION = duration;
-            WIND_POSITION = position;
-            if (app.containsKey("color"))
-              WIND_COLOR = app["color"].as<String>();
-            if (app.containsKey("iconName"))
-              WIND_ICON = app["iconName"].as<String>();
-          }
-          else if (name == "weather")
-          {
-            SHOW_WEATHER = show;
-            WEATHER_DURATION = duration;
-            WEATHER_POSITION = position;
-            if (app.containsKey("iconName"))
-              APP_WEATHER_ICON = app["iconName"].as<String>();
-          }
-          // 更新Apps中的position和duration
-          if (position >= 0)
+        if (name == "time")
+        {
+          SHOW_TIME = show;
+          TIME_DURATION = duration;
+          TIME_POSITION = position;
+          if (app.containsKey("color"))
+            TIME_COLOR = app["color"].as<String>();
+          if (app.containsKey("weekdayActive"))
+            TIME_WEEKDAY_ACTIVE_COLOR = app["weekdayActive"].as<String>();
+          if (app.containsKey("weekdayInactive"))
+            TIME_WEEKDAY_INACTIVE_COLOR = app["weekdayInactive"].as<String>();
+          if (app.containsKey("iconName"))
+            TIME_ICON = app["iconName"].as<String>();
+        }
+        else if (name == "date")
+        {
+          SHOW_DATE = show;
+          DATE_DURATION = duration;
+          DATE_POSITION = position;
+          if (app.containsKey("color"))
+            DATE_COLOR = app["color"].as<String>();
+          if (app.containsKey("weekdayActive"))
+            DATE_WEEKDAY_ACTIVE_COLOR = app["weekdayActive"].as<String>();
+          if (app.containsKey("weekdayInactive"))
+            DATE_WEEKDAY_INACTIVE_COLOR = app["weekdayInactive"].as<String>();
+          if (app.containsKey("iconName"))
+            DATE_ICON = app["iconName"].as<String>();
+        }
+        else if (name == "temp")
+        {
+          SHOW_TEMP = show;
+          TEMP_DURATION = duration;
+          TEMP_POSITION = position;
+          if (app.containsKey("color"))
+            TEMP_COLOR = app["color"].as<String>();
+        }
+        else if (name == "hum")
+        {
+          SHOW_HUM = show;
+          HUM_DURATION = duration;
+          HUM_POSITION = position;
+          if (app.containsKey("color"))
+            HUM_COLOR = app["color"].as<String>();
+        }
+        else if (name == "wind")
+        {
+          SHOW_WIND = show;
+          WIND_DURATION = duration;
+          WIND_POSITION = position;
+          if (app.containsKey("color"))
+            WIND_COLOR = app["color"].as<String>();
+          if (app.containsKey("iconName"))
+            WIND_ICON = app["iconName"].as<String>();
+        }
+        else if (name == "weather")
+        {
+          SHOW_WEATHER = show;
+          WEATHER_DURATION = duration;
+          WEATHER_POSITION = position;
+          if (app.containsKey("iconName"))
+            APP_WEATHER_ICON = app["iconName"].as<String>();
+        }
+        // 更新Apps中的position和duration
+        if (position >= 0)
+        {
+          for (auto &a : Apps)
           {
-            for (auto &a : Apps)
+            if (a.name == name)
             {
-              if (a.name == name)
-              {
-                a.position = position;
-                a.duration = duration;
-                break;
-              }
+              a.position = position;
+              a.duration = duration;
+              break;
             }
           }
         }
-        DisplayManager.loadNativeApps();
       }
+      DisplayManager.loadNativeApps();
+    }
 
-      // appsUpdate 只处理 apps，settings 由 settingsUpdate 单独处理
-      // （避免更新应用时覆盖亮度/自动轮播等设置）
+    // appsUpdate 只处理 apps，settings 由 settingsUpdate 单独处理
+    // （避免更新应用时覆盖亮度/自动轮播等设置）
 
-      saveSettings();
-      LOG_INFO("[Server] 设置已保存");
+    saveSettings();
+    LOG_INFO("[Server] 设置已保存");
 
-      // ACK + 广播权威配置
-      sendAck(num, requestId, "appsUpdate", true);
-      broadcastConfig();
-      broadcastStats();
-    }
-    else if (type == "setBrightness")
+    // ACK + 广播权威配置
+    sendAck(num, requestId, "appsUpdate", true);
+    broadcastConfig();
+    broadcastStats();
+  }
+  else if (type == "setBrightness")
+  {
+    int value = doc["value"].as<int>();
+    // 支持 0-100 范围（小程序使用）和 0-255 范围（ESP32 内部）
+    if (value <= 100)
     {
-      int value = doc["value"].as<int>();
-      // 支持 0-100 范围（小程序使用）和 0-255 范围（ESP32 内部）
-      if (value <= 100)
-      {
-        // 小程序发送的是 0-100，转换为 0-255
-        BRIGHTNESS = (uint8_t)((value * 255) / 100);
-      }
-      else
-      {
-        // 直接使用 0-255 值
-        BRIGHTNESS = (uint8_t)value;
-      }
-      // 手动设置亮度时自动关闭 LDR 自动亮度，避免手动值立刻被覆盖
-      if (AUTO_BRIGHTNESS)
-      {
-        AUTO_BRIGHTNESS = false;
-        PeripheryManager.setAutoBrightness(false);
-      }
-      DisplayManager.setBrightness(BRIGHTNESS);
-      saveSettings();
-      sendAck(num, requestId, "setBrightness", true);
-      broadcastStats();
+      // 小程序发送的是 0-100，转换为 0-255
+      BRIGHTNESS = (uint8_t)((value * 255) / 100);
     }
-    else if (type == "setPower")
+    else
     {
-      // 设置电源状态：true=开启，false=关闭
-      bool powered = doc["powered"].as<bool>();
-      MATRIX_OFF = !powered;
-      DisplayManager.setBrightness(BRIGHTNESS);
-      saveSettings();
-      sendAck(num, requestId, "setPower", true);
-      // 立即广播状态更新
-      broadcastStats();
+      // 直接使用 0-255 值
+      BRIGHTNESS = (uint8_t)value;
     }
-    else if (type == "setAutoBrightness")
+    // 手动设置亮度时自动关闭 LDR 自动亮度，避免手动值立刻被覆盖
+    if (AUTO_BRIGHTNESS)
     {
-      // LDR 自动亮度开关
-      // 协议: {type:"setAutoBrightness", enabled: true/false}
-      bool enabled = doc["enabled"].as<bool>();
-      AUTO_BRIGHTNESS = enabled;
-      PeripheryManager.setAutoBrightness(enabled);
-      saveSettings();
-      sendAck(num, requestId, "setAutoBrightness", true);
-      broadcastStats();
+      AUTO_BRIGHTNESS = false;
+      PeripheryManager.setAutoBrightness(false);
     }
-    else if (type == "setAutoPlay")
+    DisplayManager.setBrightness(BRIGHTNESS);
+    saveSettings();
+    sendAck(num, requestId, "setBrightness", true);
+    broadcastStats();
+  }
+  else if (type == "setPower")
+  {
+    // 设置电源状态：true=开启，false=关闭
+    bool powered = doc["powered"].as<bool>();
+    MATRIX_OFF = !powered;
+    DisplayManager.setBrightness(BRIGHTNESS);
+    saveSettings();
+    sendAck(num, requestId, "setPower", true);
+    // 立即广播状态更新
+    broadcastStats();
+  }
+  else if (type == "setAutoBrightness")
+  {
+    // LDR 自动亮度开关
+    // 协议: {type:"setAutoBrightness", enabled: true/false}
+    bool enabled = doc["enabled"].as<bool>();
+    AUTO_BRIGHTNESS = enabled;
+    PeripheryManager.setAutoBrightness(enabled);
+    saveSettings();
+    sendAck(num, requestId, "setAutoBrightness", true);
+    broadcastStats();
+  }
+  else if (type == "setAutoPlay")
+  {
+    // 设置自动轮播：true=开启，false=关闭
+    bool autoPlay = doc["autoPlay"].as<bool>();
+    AUTO_TRANSITION = autoPlay;
+    DisplayManager.applyAllSettings();
+    saveSettings();
+    sendAck(num, requestId, "setAutoPlay", true);
+    // 立即广播状态更新
+    broadcastStats();
+  }
+  else if (type == "setWeatherConfig")
+  {
+    String city =
+        doc.containsKey("city") ? doc["city"].as<String>() : String("");
+    String apiKey =
+        doc.containsKey("apiKey") ? doc["apiKey"].as<String>() : String("");
+
+    city.trim();
+    apiKey.trim();
+
+    if (city.length() == 0)
     {
-      // 设置自动轮播：true=开启，false=关闭
-      bool autoPlay = doc["autoPlay"].as<bool>();
-      AUTO_TRANSITION = autoPlay;
-      DisplayManager.applyAllSettings();
-      saveSettings();
-      sendAck(num, requestId, "setAutoPlay", true);
-      // 立即广播状态更新
-      broadcastStats();
+      sendAck(num, requestId, "setWeatherConfig", false, "missing city");
+      return true;
     }
-    else if (type == "setWeatherConfig")
+    if (apiKey.length() == 0)
     {
-      String city =
-          doc.containsKey("city") ? doc["city"].as<String>() : String("");
-      String apiKey =
-          doc.containsKey("apiKey") ? doc["apiKey"].as<String>() : String("");
+      sendAck(num, requestId, "setWeatherConfig", false, "missing apiKey");
+      return true;
+    }
 
-      city.trim();
-      apiKey.trim();
+    WEATHER_CITY = city;
+    WEATHER_API_KEY = apiKey;
+    saveSettings();
 
-      if (city.length() == 0)
+    sendAck(num, requestId, "setWeatherConfig", true);
+    broadcastConfig();
+  }
+  else if (type == "setMqttConfig")
+  {
+    // 协议: {type:"setMqttConfig", enabled, host, port, user, password, prefix}
+    // 未提供的字段保持当前值
+    String error;
+    if (!MqttManager.configure(doc.as<JsonObject>(), error))
+    {
+      sendAck(num, requestId, "setMqttConfig", false, error);
+      return true;
+    }
+    sendAck(num, requestId, "setMqttConfig", true);
+    broadcastConfig();
+  }
+  else if (type == "notify")
+  {
+    // 协议: {type:"notify", text, icon, color, duration, repeat, sticky, blink, priority}
+    String error;
+    if (!NotifyManager.enqueue(doc.as<JsonObject>(), error))
+    {
+      sendAck(num, requestId, "notify", false, error);
+      return true;
+    }
+    sendAck(num, requestId, "notify", true);
+  }
+  else if (type == "dismissNotify")
+  {
+    NotifyManager.dismiss();
+    sendAck(num, requestId, "dismissNotify", true);
+  }
+  else if (type == "setAlarm")
+  {
+    // 协议: {type:"setAlarm", id?, hour, minute, days, label, enabled}
+    String error;
+    uint16_t id = TimerManager.setAlarm(doc.as<JsonObject>(), error);
+    sendAck(num, requestId, "setAlarm", id != 0, id ? String(id) : error);
+  }
+  else if (type == "startTimer")
+  {
+    // 协议: {type:"startTimer", kind:"countdown"|"stopwatch", duration, label, show}
+    String error;
+    uint16_t id = TimerManager.start(doc.as<JsonObject>(), error);
+    sendAck(num, requestId, "startTimer", id != 0, id ? String(id) : error);
+  }
+  else if (type == "controlTimer")
+  {
+    // 协议: {type:"controlTimer", id, action:"pause"|"resume"|"reset"|"cancel"|"show"|"hide"}
+    String error;
+    bool ok = TimerManager.control(doc["id"] | 0, doc["action"] | "", error);
+    sendAck(num, requestId, "controlTimer", ok, error);
+  }
+  else if (type == "dismissAlarm")
+  {
+    bool ok = TimerManager.dismiss();
+    sendAck(num, requestId, "dismissAlarm", ok, ok ? "" : "not ringing");
+  }
+  else if (type == "getTimers")
+  {
+    sendTimers(num);
+  }
+  else if (type == "getGlyphStats")
+  {
+    // 协议: {type:"getGlyphStats", reset?}  字库缓存命中率与单字耗时
+    StaticJsonDocument<384> out;
+    out["type"] = "glyphStats";
+    GlyphCache.toJson(out.createNestedObject("data"));
+    if (doc["reset"] | false)
+      GlyphCache.resetStats();
+    String output;
+    serializeJson(out, output);
+    sendText(num, output);
+  }
+  else if (type == "getHeap")
+  {
+    // 协议: {type:"getHeap"}  空闲/最大块/历史最低、各子系统存活字节、采样环
+    DynamicJsonDocument out(4096);
+    out["type"] = "heap";
+    HeapTelemetry.toJson(out.createNestedObject("data"));
+    String output;
+    serializeJson(out, output);
+    sendText(num, output);
+  }
+  else if (type == "getStacks")
+  {
+    // 协议: {type:"getStacks"}  各任务栈大小/最大用量/建议值
+    DynamicJsonDocument out(2048);
+    out["type"] = "stacks";
+    StackMonitor.toJson(out.createNestedObject("data"));
+    String output;
+    serializeJson(out, output);
+    sendText(num, output);
+  }
+  else if (type == "getFrameStats")
+  {
+    // 协议: {type:"getFrameStats", reset?}
+    //   ui: 有效帧率/帧间隔来源/节省的 CPU；output: LED 传输耗时/等待/重叠率
+    StaticJsonDocument<1024> out;
+    out["type"] = "frameStats";
+    JsonObject data = out.createNestedObject("data");
+    DisplayManager.frameStatsToJson(data.createNestedObject("ui"));
+    LedOutput.toJson(data.createNestedObject("output"));
+    if (doc["reset"] | false)
+    {
+      DisplayManager.resetFrameStats();
+      LedOutput.resetStats();
+    }
+    String output;
+    serializeJson(out, output);
+    sendText(num, output);
+  }
+  else if (type == "runStackWorkload")
+  {
+    // 协议: {type:"runStackWorkload"}  仅 STACK_PROFILE 构建
+    bool ok = StackMonitor.startWorkload();
+    sendAck(num, requestId, type, ok, ok ? "" : "not a STACK_PROFILE build or busy");
+  }
+  else if (type == "runBenchmark")
+  {
+    // 协议: {type:"runBenchmark", save?, only?}  微基准测试，与 NVS 基线对比
+    DynamicJsonDocument out(2048);
+    out["type"] = "benchmark";
+    Benchmark.run(out.createNestedObject("data"), doc["only"] | "",
+                  doc["save"] | false);
+    String output;
+    serializeJson(out, output);
+    sendText(num, output);
+  }
+  else if (type == "spectrumBands")
+  {
+    // 协议: {type:"spectrumBands", layout?:"classic"|"log", minHz?, maxHz?}
+    // 带参数时修改并保存频段布局；回复当前布局
+    if (doc.containsKey("layout") || doc.containsKey("minHz") ||
+        doc.containsKey("maxHz"))
+    {
+      const char *layout = doc["layout"] | "";
+      uint16_t minHz = doc["minHz"] | SPECTRUM_MIN_HZ;
+      uint16_t maxHz = doc["maxHz"] | SPECTRUM_MAX_HZ;
+      if (minHz < 20 || maxHz <= minHz)
       {
-        sendAck(num, requestId, "setWeatherConfig", false, "missing city");
-        return;
+        sendAck(num, requestId, type, false, "invalid frequency range");
+        return true;
       }
-      if (apiKey.length() == 0)
+      uint8_t bandLayout = SPECTRUM_BAND_LAYOUT;
+      if (strcmp(layout, "classic") == 0)
+        bandLayout = SPECTRUM_LAYOUT_CLASSIC;
+      else if (strcmp(layout, "log") == 0)
+        bandLayout = SPECTRUM_LAYOUT_LOG;
+      else if (*layout)
       {
-        sendAck(num, requestId, "setWeatherConfig", false, "missing apiKey");
-        return;
+        sendAck(num, requestId, type, false, "invalid layout");
+        return true;
       }
-
-      WEATHER_CITY = city;
-      WEATHER_API_KEY = apiKey;
+      SPECTRUM_BAND_LAYOUT = bandLayout;
+      SPECTRUM_MIN_HZ = minHz;
+      SPECTRUM_MAX_HZ = maxHz;
       saveSettings();
-
-      sendAck(num, requestId, "setWeatherConfig", true);
-      broadcastConfig();
     }
-    else if (type == "setDisplayConfig")
+    StaticJsonDocument<1024> out;
+    out["type"] = "spectrumBands";
+    spectrumBandsToJson(out.createNestedObject("data"));
+    String output;
+    serializeJson(out, output);
+    sendText(num, output);
+  }
+  else if (type == "renderCheck")
+  {
+    // 协议: {type:"renderCheck", update?, only?}  固定输入渲染各画面，与基准帧比对
+    DynamicJsonDocument out(4096);
+    out["type"] = "renderCheck";
+    RenderCheck.run(out.createNestedObject("data"), doc["only"] | "",
+                    doc["update"] | false);
+    String output;
+    serializeJson(out, output);
+    sendText(num, output);
+  }
+  else if (type == "getLatency")
+  {
+    // 协议: {type:"getLatency", reset?}  各阶段预算/最大耗时与超时记录 (含软复位前)
+    sendLatency(num);
+    if (doc["reset"] | false)
+      LoopWatchdog.reset();
+  }
+  else if (type == "getTimeSync")
+  {
+    // 协议: {type:"getTimeSync"}  NTP 偏差/抖动/频偏与秒边界出帧延迟
+    StaticJsonDocument<384> out;
+    out["type"] = "timeSync";
+    TimeSync.toJson(out.createNestedObject("data"));
+    String output;
+    serializeJson(out, output);
+    sendText(num, output);
+  }
+  else if (type == "customApp")
+  {
+    // 协议: {type:"customApp", name, text, icon, color, duration, lifetime, position}
+    String error;
+    if (!CustomApps.update(doc.as<JsonObject>(), error))
     {
-      // 仅做持久化与回填；颜色校准暂不处理具体效果
-      String layout =
-          doc.containsKey("layout") ? doc["layout"].as<String>() : String("");
-      String colorCalibration = doc.containsKey("colorCalibration")
-                                    ? doc["colorCalibration"].as<String>()
-                                    : String("");
-
-      // 这些字段当前固件未使用，但为了新协议对接，先保存到 settings（需要
-      // saveSettings/loadSettings 支持） 这里先做 ACK +
-      // broadcastConfig；具体持久化字段将在 settings 存储实现后生效
-      // 为避免破坏现有存储结构，暂不强行写入全局变量。
-
-      (void)layout;
-      (void)colorCalibration;
-
-      saveSettings();
-      sendAck(num, requestId, "setDisplayConfig", true);
-      broadcastConfig();
+      sendAck(num, requestId, "customApp", false, error);
+      return true;
+    }
+    sendAck(num, requestId, "customApp", true);
+  }
+  else if (type == "removeCustomApp")
+  {
+    String name = doc["name"].as<String>();
+    if (!CustomApps.remove(name.c_str()))
+    {
+      sendAck(num, requestId, "removeCustomApp", false, "not found");
+      return true;
     }
-    else if (type == "settingsUpdate")
+    sendAck(num, requestId, "removeCustomApp", true);
+  }
+  else if (type == "getCustomApps")
+  {
+    sendCustomApps(num);
+  }
+  else if (type == "setDisplayConfig")
+  {
+    // 仅做持久化与回填；颜色校准暂不处理具体效果
+    String layout =
+        doc.containsKey("layout") ? doc["layout"].as<String>() : String("");
+    String colorCalibration = doc.containsKey("colorCalibration")
+                                  ? doc["colorCalibration"].as<String>()
+                                  : String("");
+
+    // 这些字段当前固件未使用，但为了新协议对接，先保存到 settings（需要
+    // saveSettings/loadSettings 支持） 这里先做 ACK +
+    // broadcastConfig；具体持久化字段将在 settings 存储实现后生效
+    // 为避免破坏现有存储结构，暂不强行写入全局变量。
+
+    (void)layout;
+    (void)colorCalibration;
+
+    saveSettings();
+    sendAck(num, requestId, "setDisplayConfig", true);
+    broadcastConfig();
+  }
+  else if (type == "settingsUpdate")
+  {
+    // 旧协议保留向后兼容，但不再作为新路径使用
+    if (doc.containsKey("settings"))
     {
-      // 旧协议保留向后兼容，但不再作为新路径使用
-      if (doc.containsKey("settings"))
+      auto s = doc["settings"];
+      if (s.containsKey("appTime"))
+        TIME_PER_APP = s["appTime"].as<int>();
+      if (s.containsKey("brightness"))
       {
-        auto s = doc["settings"];
-        if (s.containsKey("appTime"))
-          TIME_PER_APP = s["appTime"].as<int>();
-        if (s.containsKey("brightness"))
-        {
-          int value = s["brightness"].as<int>();
-          BRIGHTNESS =
-              value <= 100 ? (uint8_t)((value * 255) / 100) : (uint8_t)value;
-        }
-        if (s.containsKey("autoTransition"))
-          AUTO_TRANSITION = s["autoTransition"].as<bool>();
-        if (s.containsKey("showWeekday"))
-          SHOW_WEEKDAY = s["showWeekday"].as<bool>();
-        if (s.containsKey("timeFormat"))
-          TIME_FORMAT = s["timeFormat"].as<String>();
-        if (s.containsKey("dateFormat"))
-          DATE_FORMAT = s["dateFormat"].as<String>();
-        DisplayManager.applyAllSettings();
-        saveSettings();
-        sendAck(num, requestId, "settingsUpdate", true);
-        broadcastConfig();
-        broadcastStats();
-      }
-      else
-      {
-        sendAck(num, requestId, "settingsUpdate", false, "missing settings");
+        int value = s["brightness"].as<int>();
+        BRIGHTNESS =
+            value <= 100 ? (uint8_t)((value * 255) / 100) : (uint8_t)value;
       }
+      if (s.containsKey("autoTransition"))
+        AUTO_TRANSITION = s["autoTransition"].as<bool>();
+      if (s.containsKey("showWeekday"))
+        SHOW_WEEKDAY = s["showWeekday"].as<bool>();
+      if (s.containsKey("timeFormat"))
+        TIME_FORMAT = s["timeFormat"].as<String>();
+      if (s.containsKey("dateFormat"))
+        DATE_FORMAT = s["dateFormat"].as<String>();
+      DisplayManager.applyAllSettings();
+      saveSettings();
+      sendAck(num, requestId, "settingsUpdate", true);
+      broadcastConfig();
+      broadcastStats();
+    }
+    else
+    {
+      sendAck(num, requestId, "settingsUpdate", false, "missing settings");
     }
-    else if (type == "appNext")
+  }
+  else if (type == "appNext")
+  {
+    DisplayManager.nextApp();
+    sendAck(num, requestId, "appNext", true);
+    broadcastStats();
+  }
+  else if (type == "appPrev")
+  {
+    DisplayManager.previousApp();
+    sendAck(num, requestId, "appPrev", true);
+    broadcastStats();
+  }
+  else if (type == "cmd")
+  {
+    String action = doc["action"].as<String>();
+    if (action == "next")
     {
       DisplayManager.nextApp();
-      sendAck(num, requestId, "appNext", true);
+      sendAck(num, requestId, "cmd.next", true);
+      // 切换应用后立即广播状态
       broadcastStats();
     }
-    else if (type == "appPrev")
+    else if (action == "prev")
     {
       DisplayManager.previousApp();
-      sendAck(num, requestId, "appPrev", true);
+      sendAck(num, requestId, "cmd.prev", true);
+      // 切换应用后立即广播状态
       broadcastStats();
     }
-    else if (type == "cmd")
+    else if (action == "toggle")
     {
-      String action = doc["action"].as<String>();
-      if (action == "next")
-      {
-        DisplayManager.nextApp();
-        sendAck(num, requestId, "cmd.next", true);
-        // 切换应用后立即广播状态
-        broadcastStats();
-      }
-      else if (action == "prev")
-      {
-        DisplayManager.previousApp();
-        sendAck(num, requestId, "cmd.prev", true);
-        // 切换应用后立即广播状态
-        broadcastStats();
-      }
-      else if (action == "toggle")
-      {
-        // 保留 toggle 命令以保持向后兼容
-        MATRIX_OFF = !MATRIX_OFF;
-        DisplayManager.setBrightness(BRIGHTNESS);
-        saveSettings();
-        broadcastStats();
-      }
-      else if (action == "restart")
-      {
-        ESP.restart();
-      }
-      else if (action == "leftClick")
-      {
-        DisplayManager.leftButton();
-      }
-      else if (action == "rightClick")
-      {
-        DisplayManager.rightButton();
-      }
+      // 保留 toggle 命令以保持向后兼容
+      MATRIX_OFF = !MATRIX_OFF;
+      DisplayManager.setBrightness(BRIGHTNESS);
+      saveSettings();
+      sendAck(num, requestId, "cmd.toggle", true);
+      broadcastStats();
+    }
+    else if (action == "restart")
+    {
+      sendAck(num, requestId, "cmd.restart", true);
+      ESP.restart();
+    }
+    else if (action == "leftClick")
+    {
+      DisplayManager.leftButton();
+      sendAck(num, requestId, "cmd.leftClick", true);
+    }
+    else if (action == "rightClick")
+    {
+      DisplayManager.rightButton();
+      sendAck(num, requestId, "cmd.rightClick", true);
+    }
+    else
+    {
+      return false;
     }
-    break;
   }
-
-  default:
-    break;
+  else
+  {
+    return false;
   }
+  return true;
 }
 
 /**
@@ -527,6 +805,8 @@ void ServerManager_::sendAck(uint8_t num, const String &requestId,
 {
   StaticJsonDocument<256> doc;
   doc["type"] = ok ? "ack" : "error";
+  if (num == HTTP_CLIENT && !ok)
+    _httpStatus = 400;
   if (requestId.length() > 0)
     doc["requestId"] = requestId;
   doc["action"] = action;
@@ -535,15 +815,33 @@ void ServerManager_::sendAck(uint8_t num, const String &requestId,
     doc["message"] = message;
   String output;
   serializeJson(doc, output);
-  ws->sendTXT(num, output);
+  sendText(num, output);
+}
+
+/**
+ * @brief 发送文本响应
+ * @param num 客户端 ID (HTTP_CLIENT 时暂存为 HTTP 响应体)
+ * @param text JSON 文本
+ */
+void ServerManager_::sendText(uint8_t num, const String &text)
+{
+  if (num == HTTP_CLIENT)
+    _httpResponse = text;
+  else
+    ws->sendTXT(num, text);
 }
 
 /**
  * @brief 广播当前配置到所有客户端
+ */
+void ServerManager_::broadcastConfig() { ws->broadcastTXT(buildConfigJson()); }
+
+/**
+ * @brief 生成当前配置 JSON
  *
- * 发送所有应用的配置（启用状态、位置、颜色、图标等）
+ * 包含所有应用的配置（启用状态、位置、颜色、图标等）
  */
-void ServerManager_::broadcastConfig()
+String ServerManager_::buildConfigJson()
 {
   StaticJsonDocument<2048> doc;
   doc["type"] = "config";
@@ -636,17 +934,25 @@ void ServerManager_::broadcastConfig()
   settings["weatherCity"] = WEATHER_CITY;
   settings["weatherApiKey"] = WEATHER_API_KEY;
 
+  // mqtt config (不含密码)
+  MqttManager.toJson(settings.createNestedObject("mqtt"));
+
   String output;
   serializeJson(doc, output);
-  ws->broadcastTXT(output);
+  return output;
 }
 
 /**
  * @brief 广播当前状态到所有客户端
+ */
+void ServerManager_::broadcastStats() { ws->broadcastTXT(buildStatsJson()); }
+
+/**
+ * @brief 生成当前状态 JSON
  *
- * 发送温湿度、亮度、自动亮度、当前应用、电源状态、自动播放等
+ * 包含温湿度、亮度、自动亮度、当前应用、电源状态、自动播放等
  */
-void ServerManager_::broadcastStats()
+String ServerManager_::buildStatsJson()
 {
   StaticJsonDocument<512> doc;
   doc["type"] = "stats";
@@ -666,10 +972,12 @@ void ServerManager_::broadcastStats()
   data["autoPlay"] = AUTO_TRANSITION;
   // 连接状态（始终为 true，因为已连接）
   data["isOnline"] = true;
+  // 通知队列
+  NotifyManager.toJson(data.createNestedObject("notify"));
 
   String output;
   serializeJson(doc, output);
-  ws->broadcastTXT(output);
+  return output;
 }
 
 /**
@@ -741,7 +1049,7 @@ void ServerManager_::sendIconList(uint8_t num)
     // 发送空列表
     String output;
     serializeJson(doc, output);
-    ws->sendTXT(num, output);
+    sendText(num, output);
     return;
   }
 
@@ -771,7 +1079,123 @@ void ServerManager_::sendIconList(uint8_t num)
 
   String output;
   serializeJson(doc, output);
-  ws->sendTXT(num, output);
+  sendText(num, output);
+}
+
+/**
+ * @brief 发送启动时间线 (本次 + 上一次)
+ * @param num 客户端 ID
+ */
+void ServerManager_::sendBootTimeline(uint8_t num)
+{
+  DynamicJsonDocument doc(2048);
+  doc["type"] = "bootTimeline";
+  BootTimeline.toJson(doc.createNestedObject("data"));
+
+  String output;
+  serializeJson(doc, output);
+  sendText(num, output);
+}
+
+/**
+ * @brief 发送自定义应用列表
+ * @param num 客户端 ID
+ */
+void ServerManager_::sendCustomApps(uint8_t num)
+{
+  DynamicJsonDocument doc(4096);
+  doc["type"] = "customApps";
+  CustomApps.toJson(doc.createNestedArray("data"));
+
+  String output;
+  serializeJson(doc, output);
+  sendText(num, output);
+}
+
+/**
+ * @brief 发送闹钟/计时列表
+ * @param num 客户端 ID
+ */
+void ServerManager_::sendTimers(uint8_t num)
+{
+  DynamicJsonDocument doc(3072);
+  doc["type"] = "timers";
+  TimerManager.toJson(doc.createNestedArray("data"));
+
+  String output;
+  serializeJson(doc, output);
+  sendText(num, output);
+}
+
+/**
+ * @brief 发送主循环延迟报告
+ * @param num 客户端 ID
+ */
+void ServerManager_::sendLatency(uint8_t num)
+{
+  DynamicJsonDocument doc(4096);
+  doc["type"] = "latency";
+  LoopWatchdog.toJson(doc.createNestedObject("data"));
+
+  String output;
+  serializeJson(doc, output);
+  sendText(num, output);
+}
+
+/**
+ * @brief 执行来自 HTTP API / MQTT 的命令
+ * @param type 命令类型 (nullptr = 使用请求体中的 "type" 字段)
+ * @param body JSON 请求体
+ * @param length 请求体长度
+ * @param response 输出: 响应 JSON
+ * @return HTTP 状态码
+ */
+int ServerManager_::handleExternalCommand(const char *type, const char *body,
+                                      size_t length, String &response)
+{
+  DynamicJsonDocument doc(2048);
+  if (length > 0)
+  {
+    DeserializationError error = deserializeJson(doc, body, length);
+    if (error)
+    {
+      response = "{\"type\":\"error\",\"ok\":false,\"message\":\"invalid json\"}";
+      return 400;
+    }
+  }
+  if (type && *type)
+    doc["type"] = type;
+
+  String cmdType = doc["type"].as<String>();
+  if (cmdType.length() == 0 || cmdType == "null")
+  {
+    response = "{\"type\":\"error\",\"ok\":false,\"message\":\"missing type\"}";
+    return 400;
+  }
+  String requestId = doc.containsKey("requestId")
+                         ? doc["requestId"].as<String>()
+                         : String("");
+
+  _httpResponse = "";
+  _httpStatus = 200;
+  if (!dispatchCommand(HTTP_CLIENT, doc, cmdType, requestId))
+  {
+    LOG_WARN("[Server] 未知命令: %s", cmdType.c_str());
+    response =
+        "{\"type\":\"error\",\"ok\":false,\"message\":\"unknown command\"}";
+    return 404;
+  }
+  if (_httpResponse.length() == 0)
+  {
+    // 每个已知命令都应回复；走到这里是处理函数遗漏了响应
+    LOG_ERROR("[Server] 命令 %s 未产生响应", cmdType.c_str());
+    response =
+        "{\"type\":\"error\",\"ok\":false,\"message\":\"no response\"}";
+    return 500;
+  }
+  response = _httpResponse;
+  _httpResponse = "";
+  return _httpStatus;
 }
 
 /**
@@ -780,6 +1204,7 @@ void ServerManager_::sendIconList(uint8_t num)
  */
 void ServerManager_::setup(WebSocketsServer *websocket)
 {
+  HeapTagScope heapTag(HEAP_TAG_SERVER);
   this->ws = websocket;
 
   ws->begin();
@@ -795,4 +1220,19 @@ void ServerManager_::setup(WebSocketsServer *websocket)
 /**
  * @brief 主循环 - 处理 WebSocket 事件
  */
-void ServerManager_::tick() { ws->loop(); }
\ No newline at end of file
+void ServerManager_::tick()
+{
+  HeapTagScope heapTag(HEAP_TAG_SERVER);
+  ws->loop();
+
+  // 推送新的阶段超时记录
+  if (LoopWatchdog.hasUnreported())
+  {
+    DynamicJsonDocument doc(2048);
+    doc["type"] = "latencyViolation";
+    LoopWatchdog.takeUnreported(doc.createNestedArray("data"));
+    String output;
+    serializeJson(doc, output);
+    ws->broadcastTXT(output);
+  }
+}
\ No newline at end of file
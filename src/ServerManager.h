@@ -12,6 +12,7 @@
 #ifndef SERVER_MANAGER_H
 #define SERVER_MANAGER_H
 
+#include <ArduinoJson.h>
 #include <WebSocketsServer.h>
 
 // ==================================================================
@@ -35,6 +36,15 @@ private:
     /// WebSocket 服务器实例
     WebSocketsServer *ws;
 
+    /// 表示 HTTP API / MQTT 请求的伪客户端 ID (WebSocket 客户端 ID 不会用到)
+    static const uint8_t HTTP_CLIENT = 0xFF;
+
+    /// HTTP API / MQTT 请求的响应体 (dispatchCommand 期间由 sendText 写入)
+    String _httpResponse;
+
+    /// HTTP API / MQTT 请求的状态码 (sendAck 失败时置 400)
+    int _httpStatus = 200;
+
     // ==================================================================
     // 私有方法
     // ==================================================================
@@ -42,6 +52,12 @@ private:
     /// 处理 WebSocket 事件 (连接/断开/消息)
     void handleWebSocketEvent(uint8_t num, WStype_t type, uint8_t *payload, size_t length);
 
+    /// 执行一条 JSON 命令 (WebSocket 与 HTTP API 共用)，未知命令返回 false
+    bool dispatchCommand(uint8_t num, JsonDocument &doc, const String &type, const String &requestId);
+
+    /// 发送文本响应 (HTTP_CLIENT 时写入 _httpResponse)
+    void sendText(uint8_t num, const String &text);
+
     /// 广播当前配置到所有客户端
     void broadcastConfig();
 
@@ -71,6 +87,30 @@ private:
      */
     void sendIconList(uint8_t num);
 
+    /**
+     * @brief 发送启动时间线 (本次 + 上一次)
+     * @param num 客户端 ID
+     */
+    void sendBootTimeline(uint8_t num);
+
+    /**
+     * @brief 发送自定义应用列表
+     * @param num 客户端 ID
+     */
+    void sendCustomApps(uint8_t num);
+
+    /**
+     * @brief 发送闹钟/计时列表
+     * @param num 客户端 ID
+     */
+    void sendTimers(uint8_t num);
+
+    /**
+     * @brief 发送主循环延迟报告
+     * @param num 客户端 ID
+     */
+    void sendLatency(uint8_t num);
+
 public:
     /**
      * @brief 获取单例实例
@@ -89,6 +129,22 @@ public:
      */
     void tick();
 
+    /**
+     * @brief 执行来自 HTTP API / MQTT 的命令 (与 WebSocket 命令共用处理逻辑)
+     * @param type 命令类型 (nullptr = 使用请求体中的 "type" 字段)
+     * @param body JSON 请求体 (HTTP 请求体或 MQTT 负载)
+     * @param length 请求体长度
+     * @param response 输出: 响应 JSON
+     * @return HTTP 状态码
+     */
+    int handleExternalCommand(const char *type, const char *body, size_t length, String &response);
+
+    /// 生成当前配置 JSON (getConfig 的数据)
+    String buildConfigJson();
+
+    /// 生成当前状态 JSON (getStats 的数据)
+    String buildStatsJson();
+
     /**
      * @brief 通知所有客户端事件
      * @param event 事件类型
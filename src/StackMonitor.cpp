@@ -0,0 +1,288 @@
+/**
+ * @file StackMonitor.cpp
+ * @brief 任务栈监视实现 — 高水位采样、系统任务查找、栈分析脚本
+ */
+
+#include "StackMonitor.h"
+#include "Logger.h"
+#ifdef STACK_PROFILE
+#include "ServerManager.h"
+#include <Preferences.h>
+#endif
+
+#ifndef CONFIG_ARDUINO_LOOP_STACK_SIZE
+#define CONFIG_ARDUINO_LOOP_STACK_SIZE 8192
+#endif
+#ifndef CONFIG_LWIP_TCPIP_TASK_STACK_SIZE
+#define CONFIG_LWIP_TCPIP_TASK_STACK_SIZE 0
+#endif
+#ifndef CONFIG_ESP_SYSTEM_EVENT_TASK_STACK_SIZE
+#define CONFIG_ESP_SYSTEM_EVENT_TASK_STACK_SIZE 0
+#endif
+#ifndef CONFIG_ESP_TIMER_TASK_STACK_SIZE
+#define CONFIG_ESP_TIMER_TASK_STACK_SIZE 0
+#endif
+
+/// 按名称查找的系统任务 (WiFi 启动后才存在)
+static const struct
+{
+  const char *name;
+  uint32_t stackSize;
+} SYSTEM_TASKS[] = {
+    {"tiT", CONFIG_LWIP_TCPIP_TASK_STACK_SIZE},
+    {"sys_evt", CONFIG_ESP_SYSTEM_EVENT_TASK_STACK_SIZE},
+    {"esp_timer", CONFIG_ESP_TIMER_TASK_STACK_SIZE},
+    {"wifi", 0}};
+
+static const uint8_t SYSTEM_TASK_COUNT =
+    sizeof(SYSTEM_TASKS) / sizeof(SYSTEM_TASKS[0]);
+
+// ==================================================================
+// 单例
+// ==================================================================
+
+StackMonitor_ &StackMonitor_::getInstance()
+{
+  static StackMonitor_ instance;
+  return instance;
+}
+
+StackMonitor_ &StackMonitor = StackMonitor_::getInstance();
+
+// ==================================================================
+// 任务登记
+// ==================================================================
+
+void StackMonitor_::begin()
+{
+  watch(xTaskGetCurrentTaskHandle(), "loopTask", CONFIG_ARDUINO_LOOP_STACK_SIZE);
+#ifdef STACK_PROFILE
+  LOG_WARN("[Stack] 栈分析构建：30 秒后执行脚本，最大用量保存到 NVS");
+#endif
+}
+
+void StackMonitor_::watch(TaskHandle_t task, const char *name,
+                          uint32_t stackSize)
+{
+  if (task == nullptr)
+    return;
+  for (uint8_t i = 0; i < _count; i++)
+  {
+    if (_entries[i].task == task)
+      return;
+  }
+  if (_count >= STACK_MONITOR_TASKS)
+    return;
+
+  Entry &e = _entries[_count++];
+  e.task = task;
+  strncpy(e.name, name, sizeof(e.name) - 1);
+  e.name[sizeof(e.name) - 1] = '\0';
+  e.stackSize = stackSize;
+  e.minFree = UINT32_MAX;
+  e.profileMax = 0;
+#ifdef STACK_PROFILE
+  Preferences prefs;
+  prefs.begin("stack", true);
+  e.profileMax = prefs.getUInt(e.name, 0);
+  prefs.end();
+#endif
+}
+
+void StackMonitor_::unwatch(TaskHandle_t task)
+{
+  for (uint8_t i = 0; i < _count; i++)
+  {
+    if (_entries[i].task == task)
+    {
+      _entries[i] = _entries[--_count];
+      return;
+    }
+  }
+}
+
+/// 查找尚未登记的系统任务
+void StackMonitor_::_findSystemTasks()
+{
+  for (uint8_t i = 0; i < SYSTEM_TASK_COUNT; i++)
+  {
+    bool known = false;
+    for (uint8_t j = 0; j < _count && !known; j++)
+      known = strcmp(_entries[j].name, SYSTEM_TASKS[i].name) == 0;
+    if (known)
+      continue;
+    TaskHandle_t task = xTaskGetHandle(SYSTEM_TASKS[i].name);
+    if (task)
+      watch(task, SYSTEM_TASKS[i].name, SYSTEM_TASKS[i].stackSize);
+  }
+}
+
+// ==================================================================
+// 采样
+// ==================================================================
+
+void StackMonitor_::tick()
+{
+#ifdef STACK_PROFILE
+  const unsigned long interval = STACK_PROFILE_INTERVAL_MS;
+  if (_workloadStep < 0 && !_workloadDone && millis() > 30000)
+    startWorkload();
+  if (_workloadStep >= 0)
+    _stepWorkload();
+#else
+  const unsigned long interval = STACK_SAMPLE_INTERVAL_MS;
+#endif
+
+  if (_lastSample != 0 && millis() - _lastSample < interval)
+    return;
+  _lastSample = millis();
+  _sample();
+}
+
+void StackMonitor_::_sample()
+{
+  if (_count < STACK_MONITOR_TASKS)
+    _findSystemTasks();
+
+  for (uint8_t i = 0; i < _count; i++)
+  {
+    Entry &e = _entries[i];
+    uint32_t free = uxTaskGetStackHighWaterMark(e.task);
+    if (free < e.minFree)
+    {
+      e.minFree = free;
+#ifdef STACK_PROFILE
+      if (e.stackSize > free && e.stackSize - free > e.profileMax)
+      {
+        e.profileMax = e.stackSize - free;
+        _profileDirty = true;
+      }
+#endif
+    }
+  }
+
+#ifdef STACK_PROFILE
+  // NVS 写入限流
+  if (_profileDirty && millis() - _lastSave > 30000)
+    _saveProfile();
+#endif
+}
+
+// ==================================================================
+// 报告
+// ==================================================================
+
+void StackMonitor_::toJson(JsonObject out)
+{
+  _sample();
+
+#ifdef STACK_PROFILE
+  out["profile"] = true;
+  out["workload"] = _workloadStep >= 0 ? "running"
+                                       : (_workloadDone ? "done" : "pending");
+#else
+  out["profile"] = false;
+#endif
+
+  JsonArray tasks = out.createNestedArray("tasks");
+  for (uint8_t i = 0; i < _count; i++)
+  {
+    const Entry &e = _entries[i];
+    JsonObject t = tasks.createNestedObject();
+    t["name"] = e.name;
+    t["minFree"] = e.minFree;
+    if (e.stackSize == 0)
+      continue; // 栈大小未知，只报告剩余量
+
+    uint32_t used = e.stackSize > e.minFree ? e.stackSize - e.minFree : 0;
+    t["size"] = e.stackSize;
+    t["used"] = used;
+    t["usedPct"] = used * 100 / e.stackSize;
+
+    uint32_t basis = e.profileMax > used ? e.profileMax : used;
+    t["suggest"] = (basis + STACK_MARGIN + 255) / 256 * 256;
+#ifdef STACK_PROFILE
+    t["profileMax"] = e.profileMax;
+#endif
+  }
+}
+
+// ==================================================================
+// 栈分析脚本 (STACK_PROFILE)
+// ==================================================================
+
+#ifdef STACK_PROFILE
+
+/// 覆盖最重 JSON 路径的命令序列 (执行后恢复原状态)
+static const char *const WORKLOAD[] = {
+    "{\"type\":\"getConfig\"}",
+    "{\"type\":\"getStats\"}",
+    "{\"type\":\"getIconList\"}",
+    "{\"type\":\"getBootTimeline\"}",
+    "{\"type\":\"getCustomApps\"}",
+    "{\"type\":\"getTimers\"}",
+    "{\"type\":\"getHeap\"}",
+    "{\"type\":\"getLatency\"}",
+    "{\"type\":\"getTimeSync\"}",
+    "{\"type\":\"getGlyphStats\"}",
+    "{\"type\":\"getStacks\"}",
+    "{\"type\":\"customApp\",\"name\":\"_stack\",\"lifetime\":10,\"text\":"
+    "[{\"t\":\"STACK \",\"c\":\"#FF0000\"},{\"t\":\"PROBE \",\"c\":\"#00FF00\"},"
+    "{\"t\":\"多色文字 \",\"c\":\"#0000FF\"},{\"t\":\"0123456789\"}]}",
+    "{\"type\":\"removeCustomApp\",\"name\":\"_stack\"}",
+    "{\"type\":\"notify\",\"text\":\"栈深度测试 STACK PROFILE NOTIFICATION\","
+    "\"duration\":1,\"priority\":1}",
+    "{\"type\":\"dismissNotify\"}"};
+
+static const int8_t WORKLOAD_STEPS = sizeof(WORKLOAD) / sizeof(WORKLOAD[0]);
+
+bool StackMonitor_::startWorkload()
+{
+  if (_workloadStep >= 0)
+    return false;
+  LOG_INFO("[Stack] 开始执行栈分析脚本 (%d 步)", WORKLOAD_STEPS);
+  _workloadStep = 0;
+  return true;
+}
+
+/// 每帧执行一步，步骤之间正常渲染/收包
+void StackMonitor_::_stepWorkload()
+{
+  String response;
+  const char *cmd = WORKLOAD[_workloadStep];
+  ServerManager.handleExternalCommand(nullptr, cmd, strlen(cmd), response);
+  _sample();
+
+  if (++_workloadStep >= WORKLOAD_STEPS)
+  {
+    _workloadStep = -1;
+    _workloadDone = true;
+    _saveProfile();
+    for (uint8_t i = 0; i < _count; i++)
+    {
+      LOG_INFO("[Stack] %-10s 栈 %5lu, 最大用量 %5lu", _entries[i].name,
+               (unsigned long)_entries[i].stackSize,
+               (unsigned long)_entries[i].profileMax);
+    }
+  }
+}
+
+void StackMonitor_::_saveProfile()
+{
+  Preferences prefs;
+  prefs.begin("stack", false);
+  for (uint8_t i = 0; i < _count; i++)
+  {
+    if (_entries[i].profileMax > 0)
+      prefs.putUInt(_entries[i].name, _entries[i].profileMax);
+  }
+  prefs.end();
+  _profileDirty = false;
+  _lastSave = millis();
+}
+
+#else
+
+bool StackMonitor_::startWorkload() { return false; }
+
+#endif
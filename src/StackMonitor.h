@@ -0,0 +1,105 @@
+/**
+ * @file StackMonitor.h
+ * @brief 任务栈监视 — 定期采样各任务栈高水位，给出栈大小建议
+ *
+ * 本文件定义：
+ *   - StackMonitor_ 单例类: 任务登记、高水位采样、调优报告、栈分析构建模式
+ *
+ * 固件自己创建的任务 (主循环、WeatherTask、LoopWdt、LedOut) 在创建时登记栈大小；
+ * 系统任务 (lwIP、事件循环、esp_timer、WiFi) 按名称查找，栈大小取 sdkconfig。
+ * 每 STACK_SAMPLE_INTERVAL_MS 读取一次 uxTaskGetStackHighWaterMark()
+ * (ESP32 上单位为字节)，记录启动以来的最小剩余量。
+ *
+ * 建议值 = 最大用量 + STACK_MARGIN，向上取整到 256 字节。
+ *
+ * 栈分析构建 (build_flags 加 -D STACK_PROFILE)：
+ *   - 采样间隔缩短为 STACK_PROFILE_INTERVAL_MS
+ *   - 启动 30 秒后 (或收到 runStackWorkload 命令) 逐帧执行一组脚本命令，
+ *     覆盖最重的 JSON 路径 (配置、列表、多色文字、通知等)
+ *   - 各任务的最大用量跨启动累计保存在 NVS (命名空间 "stack")，
+ *     多次运行后报告中的 profileMax 即可作为调小栈的依据
+ */
+
+#ifndef STACK_MONITOR_H
+#define STACK_MONITOR_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+
+/// 最多监视的任务数
+#define STACK_MONITOR_TASKS 10
+
+/// 采样间隔 (毫秒)
+#define STACK_SAMPLE_INTERVAL_MS 10000UL
+
+/// 栈分析构建的采样间隔 (毫秒)
+#define STACK_PROFILE_INTERVAL_MS 200UL
+
+/// 建议栈大小的余量 (字节)
+#define STACK_MARGIN 1024
+
+/**
+ * @class StackMonitor_
+ * @brief 任务栈高水位监视
+ */
+class StackMonitor_
+{
+public:
+  static StackMonitor_ &getInstance();
+
+  /// setup() 中调用 (主循环任务)：登记主循环任务
+  void begin();
+
+  /// 主循环调用：按间隔采样 (栈分析构建中还推进脚本)
+  void tick();
+
+  /**
+   * @brief 登记一个任务
+   * @param task 任务句柄
+   * @param name 名称 (报告用)
+   * @param stackSize 创建时的栈大小 (字节，0=未知)
+   */
+  void watch(TaskHandle_t task, const char *name, uint32_t stackSize);
+
+  /// 任务删除前取消登记
+  void unwatch(TaskHandle_t task);
+
+  /// 开始执行栈分析脚本 (仅 STACK_PROFILE 构建有效)
+  bool startWorkload();
+
+  /// 调优报告 (getStacks 命令)
+  void toJson(JsonObject out);
+
+private:
+  StackMonitor_() = default;
+
+  /// 单个任务的记录
+  struct Entry
+  {
+    TaskHandle_t task;
+    char name[16];
+    uint32_t stackSize;
+    uint32_t minFree;    ///< 启动以来最小剩余 (字节，UINT32_MAX=未采样)
+    uint32_t profileMax; ///< 栈分析构建跨启动累计的最大用量 (字节)
+  };
+
+  Entry _entries[STACK_MONITOR_TASKS];
+  uint8_t _count = 0;
+  unsigned long _lastSample = 0;
+
+  void _sample();
+  void _findSystemTasks();
+
+#ifdef STACK_PROFILE
+  int8_t _workloadStep = -1; ///< 当前脚本步骤 (-1=未运行)
+  bool _workloadDone = false;
+  bool _profileDirty = false;
+  unsigned long _lastSave = 0;
+  void _stepWorkload();
+  void _saveProfile();
+#endif
+};
+
+extern StackMonitor_ &StackMonitor;
+
+#endif
@@ -0,0 +1,191 @@
+/**
+ * @file TimeSync.cpp
+ * @brief 时间同步实现 — SNTP 回调、频偏估计、adjtime 补偿
+ */
+
+#include "TimeSync.h"
+#include "ClockService.h"
+#include "Logger.h"
+#include <esp_sntp.h>
+#include <math.h>
+#include <sys/time.h>
+
+/// 每个样本对频偏估计的修正增益 (越小越平滑)
+static const float DRIFT_GAIN = 0.5f;
+
+// ==================================================================
+// 单例
+// ==================================================================
+
+TimeSync_ &TimeSync_::getInstance()
+{
+  static TimeSync_ instance;
+  return instance;
+}
+
+TimeSync_ &TimeSync = TimeSync_::getInstance();
+
+// ==================================================================
+// 启动
+// ==================================================================
+
+void TimeSync_::begin()
+{
+  if (_started)
+  {
+    // 重连后立即再同步一次
+    sntp_restart();
+    return;
+  }
+  _started = true;
+
+  sntp_set_sync_mode(SNTP_SYNC_MODE_SMOOTH);
+  sntp_set_sync_interval(TIMESYNC_INTERVAL_MS);
+  sntp_set_time_sync_notification_cb(_onSync);
+  configTime(8 * 3600, 0, "ntp.aliyun.com", "pool.ntp.org", "time.nist.gov");
+  LOG_INFO("[TimeSync] SNTP 已启动 (平滑校时，间隔 %lu 分钟)",
+           TIMESYNC_INTERVAL_MS / 60000UL);
+}
+
+/**
+ * @brief SNTP 同步回调 (lwIP 任务)
+ *
+ * IDF 在调用回调前已处理完时间：平滑调整 (IN_PROGRESS) 时只提交了
+ * adjtime()，系统时钟尚未改动，tv 与本地时间之差即本次同步前的偏差；
+ * 直接设置 (COMPLETED) 时时钟已等于 tv，差值没有意义。只记录，由主循环处理。
+ */
+void TimeSync_::_onSync(struct timeval *tv)
+{
+  struct timeval now;
+  gettimeofday(&now, nullptr);
+  // 读取状态会清除 COMPLETED，每次回调都读，保证下次得到的是本次同步的结果
+  bool stepped = sntp_get_sync_status() == SNTP_SYNC_STATUS_COMPLETED;
+  TimeSync_ &self = getInstance();
+  if (self._pending.load(std::memory_order_acquire))
+    return; // 上一个样本尚未处理
+  self._pendingOffsetUs = (int64_t)(tv->tv_sec - now.tv_sec) * 1000000LL +
+                          (tv->tv_usec - now.tv_usec);
+  self._pendingAtMs = millis();
+  self._pendingStep = stepped;
+  self._pending.store(true, std::memory_order_release);
+}
+
+// ==================================================================
+// 样本处理
+// ==================================================================
+
+void TimeSync_::tick()
+{
+  if (_pending.load(std::memory_order_acquire))
+  {
+    int64_t offset = _pendingOffsetUs;
+    unsigned long at = _pendingAtMs;
+    bool stepped = _pendingStep;
+    _pending.store(false, std::memory_order_release);
+    _addSample(offset, at, stepped);
+  }
+
+  if (synced() && millis() - _lastTrimMs >= TIMESYNC_TRIM_INTERVAL * 1000UL)
+  {
+    _lastTrimMs = millis();
+    _trim();
+  }
+}
+
+void TimeSync_::_addSample(int64_t offsetUs, unsigned long atMs, bool stepped)
+{
+  if (stepped)
+  {
+    // 时钟已被直接设置：偏差无从测量，之前的样本也不再连续
+    _stepCount++;
+    _sampleCount = 0;
+    _sampleHead = 0;
+    ClockService.invalidate();
+  }
+  else
+  {
+    // 残余频偏 = 本区间累计偏差 / 区间长度 (微秒/秒 = ppm)
+    // 首个样本之前没有同步基准，只记录偏差
+    float intervalS = (atMs - _lastSyncMs) / 1000.0f;
+    if (_syncCount > 0 && intervalS > 1.0f)
+    {
+      float residual = (float)offsetUs / intervalS;
+      float drift = _driftPpm + DRIFT_GAIN * residual;
+      if (drift > -TIMESYNC_MAX_PPM && drift < TIMESYNC_MAX_PPM)
+        _driftPpm = drift;
+    }
+
+    _samples[_sampleHead] = (int32_t)offsetUs;
+    _sampleHead = (_sampleHead + 1) % TIMESYNC_SAMPLES;
+    if (_sampleCount < TIMESYNC_SAMPLES)
+      _sampleCount++;
+    _lastOffsetUs = offsetUs;
+  }
+
+  _syncCount++;
+  _lastSyncMs = atMs;
+  _lastTrimMs = atMs;
+  if (stepped)
+    LOG_INFO("[TimeSync] 同步 #%lu: 时钟已直接设置, 频偏 %.1f ppm",
+             (unsigned long)_syncCount, _driftPpm);
+  else
+    LOG_INFO("[TimeSync] 同步 #%lu: 偏差 %.1f ms (平滑调整), 频偏 %.1f ppm",
+             (unsigned long)_syncCount, offsetUs / 1000.0f, _driftPpm);
+}
+
+/**
+ * @brief 按频偏估计预先调整时钟
+ *
+ * SNTP 的平滑调整仍在进行时跳过，避免覆盖它尚未完成的修正。
+ */
+void TimeSync_::_trim()
+{
+  long correction = lroundf(_driftPpm * TIMESYNC_TRIM_INTERVAL);
+  if (correction == 0)
+    return;
+
+  struct timeval outstanding;
+  if (adjtime(nullptr, &outstanding) != 0 || outstanding.tv_sec != 0 ||
+      outstanding.tv_usec != 0)
+    return;
+
+  struct timeval delta = {0, correction};
+  if (adjtime(&delta, nullptr) == 0)
+    _trimmedUs += correction;
+}
+
+// ==================================================================
+// 统计
+// ==================================================================
+
+void TimeSync_::toJson(JsonObject out)
+{
+  out["synced"] = synced();
+  out["syncCount"] = _syncCount;
+  out["stepCount"] = _stepCount;
+  out["intervalS"] = TIMESYNC_INTERVAL_MS / 1000UL;
+  out["lastSyncAgoS"] = synced() ? (millis() - _lastSyncMs) / 1000UL : 0UL;
+  out["offsetMs"] = _lastOffsetUs / 1000.0f;
+  out["driftPpm"] = _driftPpm;
+  out["trimmedMs"] = _trimmedUs / 1000.0f;
+
+  // 抖动: 相邻偏差差值的均方根
+  float jitter = 0.0f;
+  if (_sampleCount >= 2)
+  {
+    float sum = 0.0f;
+    uint8_t oldest = (_sampleHead + TIMESYNC_SAMPLES - _sampleCount) %
+                     TIMESYNC_SAMPLES;
+    for (uint8_t i = 1; i < _sampleCount; i++)
+    {
+      float d = (float)_samples[(oldest + i) % TIMESYNC_SAMPLES] -
+                _samples[(oldest + i - 1) % TIMESYNC_SAMPLES];
+      sum += d * d;
+    }
+    jitter = sqrtf(sum / (_sampleCount - 1)) / 1000.0f;
+  }
+  out["jitterMs"] = jitter;
+
+  // 显示对齐: 秒边界到该秒第一帧送出的延迟
+  ClockService.edgeStats(out);
+}
@@ -0,0 +1,93 @@
+/**
+ * @file TimeSync.h
+ * @brief 时间同步 — SNTP 平滑校时、频偏估计与偏差/抖动统计
+ *
+ * 本文件定义：
+ *   - TimeSync_ 单例类: 启动 SNTP、记录每次同步的时间偏差、估计晶振频偏并补偿
+ *
+ * SNTP 使用平滑模式 (SNTP_SYNC_MODE_SMOOTH)：IDF 先用 adjtime() 逐步调整
+ * 系统时钟 (可平滑的偏差约 ±35 分钟)，秒数不会跳变或倒退；只有 adjtime()
+ * 拒绝该偏差时 (如首次同步、时钟仍在 1970 年) 才用 settimeofday() 直接设置。
+ *
+ * 同步回调运行在 lwIP 任务中，用 sntp_get_sync_status() 区分两种情况：
+ *   - SNTP_SYNC_STATUS_IN_PROGRESS: 正在平滑调整，时钟尚未改动，
+ *     "服务器时间 - 本地时间" 是有效的偏差样本
+ *   - SNTP_SYNC_STATUS_COMPLETED: 时钟已被直接设置，偏差无从测量，
+ *     记为一次跳变，不参与频偏估计
+ * 回调只记录样本并置位标志；主循环 tick() 中处理样本：
+ *   - 偏差 / 距上次同步的间隔 = 该区间内的残余频偏 (ppm)，累加到频偏估计
+ *   - 每 TIMESYNC_TRIM_INTERVAL 秒按频偏估计调用一次 adjtime() 预先补偿，
+ *     两次同步之间的累计误差不再等到下一次同步才修正
+ *   - 抖动 = 最近几次偏差的相邻差值均方根
+ */
+
+#ifndef TIME_SYNC_H
+#define TIME_SYNC_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <atomic>
+
+/// SNTP 同步间隔 (毫秒)
+#define TIMESYNC_INTERVAL_MS (30UL * 60UL * 1000UL)
+
+/// 频偏补偿间隔 (秒)
+#define TIMESYNC_TRIM_INTERVAL 60
+
+/// 偏差样本环大小 (计算抖动)
+#define TIMESYNC_SAMPLES 8
+
+/// 频偏估计上限 (ppm)，超出视为异常样本
+#define TIMESYNC_MAX_PPM 500.0f
+
+/**
+ * @class TimeSync_
+ * @brief SNTP 时间同步
+ */
+class TimeSync_
+{
+public:
+  static TimeSync_ &getInstance();
+
+  /// WiFi 连接后调用：设置时区与 NTP 服务器，启动平滑同步
+  void begin();
+
+  /// 主循环调用：处理同步样本、定期频偏补偿
+  void tick();
+
+  /// 是否已完成过至少一次同步
+  bool synced() const { return _syncCount > 0; }
+
+  /// 同步统计 (getTimeSync 命令)
+  void toJson(JsonObject out);
+
+private:
+  TimeSync_() = default;
+
+  static void _onSync(struct timeval *tv);
+  void _addSample(int64_t offsetUs, unsigned long atMs, bool stepped);
+  void _trim();
+
+  // 回调 → 主循环 (单生产者单消费者)
+  int64_t _pendingOffsetUs = 0;
+  unsigned long _pendingAtMs = 0;
+  bool _pendingStep = false; ///< 本次同步直接设置了时钟
+  std::atomic<bool> _pending{false};
+
+  bool _started = false;
+  uint32_t _syncCount = 0;
+  uint32_t _stepCount = 0;       ///< 直接设置时间 (非平滑) 的次数
+  unsigned long _lastSyncMs = 0; ///< 上次同步时的 millis()
+  unsigned long _lastTrimMs = 0;
+  int64_t _lastOffsetUs = 0;
+  int64_t _trimmedUs = 0; ///< 频偏补偿累计调整量 (微秒)
+  float _driftPpm = 0.0f; ///< 本地时钟相对服务器的频偏估计 (正=本地偏慢)
+
+  int32_t _samples[TIMESYNC_SAMPLES]; ///< 最近的偏差 (微秒)
+  uint8_t _sampleCount = 0;
+  uint8_t _sampleHead = 0;
+};
+
+extern TimeSync_ &TimeSync;
+
+#endif
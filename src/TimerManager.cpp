@@ -0,0 +1,809 @@
+/**
+ * @file TimerManager.cpp
+ * @brief 闹钟/倒计时/秒表实现 — 时间轮、持久化、覆盖层渲染
+ */
+
+#include "TimerManager.h"
+#include "DisplayManager.h"
+#include "Globals.h"
+#include "Logger.h"
+#include "Tools.h"
+#include <Preferences.h>
+#include <sys/time.h>
+#include <time.h>
+
+// ==================================================================
+// 单例
+// ==================================================================
+
+TimerManager_ &TimerManager_::getInstance()
+{
+  static TimerManager_ instance;
+  return instance;
+}
+
+TimerManager_ &TimerManager = TimerManager_::getInstance();
+
+/// 墙上时间是否有效 (RTC 保持或已同步)
+static bool wallClockValid(time_t now) { return now > 1700000000; }
+
+// ==================================================================
+// 持久化记录
+// ==================================================================
+
+/// NVS 中保存的条目 (定长，不含运行时字段)
+struct TimerRecord
+{
+  uint16_t id;
+  uint8_t type;
+  uint8_t state;
+  char label[TIMER_LABEL_LEN];
+  uint8_t show;
+  uint8_t hour;
+  uint8_t minute;
+  uint8_t days;
+  uint32_t duration;
+  uint32_t heldMs;  ///< 剩余 (倒计时) / 经过 (秒表) 时间
+  uint32_t wallRef; ///< 运行中: 倒计时到期 / 秒表起点 (Unix 秒，0=时间无效)
+};
+
+void TimerManager_::_save()
+{
+  TimerRecord records[TIMER_MAX_ENTRIES];
+  uint8_t count = 0;
+  unsigned long nowMs = millis();
+  time_t wall = time(nullptr);
+  bool valid = wallClockValid(wall);
+
+  for (const auto &e : _entries)
+  {
+    if (!e.used)
+      continue;
+    // 响铃中的倒计时已结束，不再恢复
+    if (e.type == TIMER_COUNTDOWN && e.state == TIMER_RINGING)
+      continue;
+
+    TimerRecord &r = records[count++];
+    memset(&r, 0, sizeof(r));
+    r.id = e.id;
+    r.type = e.type;
+    r.state = e.state == TIMER_RINGING ? TIMER_RUNNING : e.state;
+    memcpy(r.label, e.label, TIMER_LABEL_LEN);
+    r.show = e.show;
+    r.hour = e.hour;
+    r.minute = e.minute;
+    r.days = e.days;
+    r.duration = e.duration;
+    r.heldMs = e.heldMs;
+
+    if (e.state == TIMER_RUNNING && e.type == TIMER_COUNTDOWN)
+    {
+      long remaining = (long)(e.deadline - nowMs);
+      r.heldMs = remaining > 0 ? remaining : 0;
+      r.wallRef = valid ? (uint32_t)(wall + r.heldMs / 1000) : 0;
+    }
+    else if (e.state == TIMER_RUNNING && e.type == TIMER_STOPWATCH)
+    {
+      r.heldMs = nowMs - e.startedAt;
+      r.wallRef = valid ? (uint32_t)(wall - r.heldMs / 1000) : 0;
+    }
+  }
+
+  Preferences prefs;
+  prefs.begin("timers", false);
+  prefs.putBytes("entries", records, count * sizeof(TimerRecord));
+  prefs.end();
+}
+
+void TimerManager_::_load()
+{
+  TimerRecord records[TIMER_MAX_ENTRIES];
+  Preferences prefs;
+  prefs.begin("timers", true);
+  size_t length = prefs.getBytesLength("entries");
+  size_t count = 0;
+  if (length > 0 && length % sizeof(TimerRecord) == 0 &&
+      length <= sizeof(records))
+  {
+    prefs.getBytes("entries", records, length);
+    count = length / sizeof(TimerRecord);
+  }
+  prefs.end();
+
+  unsigned long nowMs = millis();
+  time_t wall = time(nullptr);
+  bool valid = wallClockValid(wall);
+
+  for (size_t n = 0; n < count; n++)
+  {
+    const TimerRecord &r = records[n];
+    int8_t i = _alloc();
+    if (i < 0)
+      break;
+
+    TimerEntry &e = _entries[i];
+    e.id = r.id;
+    e.type = (TimerType)r.type;
+    e.state = (TimerState)r.state;
+    memcpy(e.label, r.label, TIMER_LABEL_LEN);
+    e.label[TIMER_LABEL_LEN - 1] = '\0';
+    e.show = r.show;
+    e.hour = r.hour;
+    e.minute = r.minute;
+    e.days = r.days;
+    e.duration = r.duration;
+    e.heldMs = r.heldMs;
+    if (e.id >= _nextId)
+      _nextId = e.id + 1;
+    if (e.show)
+      _focus = i;
+
+    if (e.state != TIMER_RUNNING)
+      continue;
+
+    if (e.type == TIMER_ALARM)
+    {
+      _scheduleAlarm(i); // 时间无效时等待 tick() 检测到有效时间再排
+    }
+    else if (e.type == TIMER_COUNTDOWN)
+    {
+      long remaining = r.heldMs;
+      if (r.wallRef && valid)
+        remaining = ((long)r.wallRef - (long)wall) * 1000L;
+      if (remaining <= 0)
+      {
+        _ring(i); // 断电期间已到期
+        continue;
+      }
+      e.deadline = nowMs + remaining;
+      _schedule(i, e.deadline);
+    }
+    else if (e.type == TIMER_STOPWATCH)
+    {
+      uint32_t elapsed = r.heldMs;
+      if (r.wallRef && valid && wall >= (time_t)r.wallRef)
+        elapsed = (uint32_t)(wall - r.wallRef) * 1000UL;
+      e.startedAt = nowMs - elapsed;
+    }
+  }
+
+  if (count > 0)
+    LOG_INFO("[Timer] 恢复 %u 个闹钟/计时", (unsigned)count);
+}
+
+// ==================================================================
+// 初始化与时间轮
+// ==================================================================
+
+void TimerManager_::setup()
+{
+  for (auto &head : _wheel)
+    head = -1;
+  _cursor = 0;
+  _wheelTime = millis();
+  _lastWall = time(nullptr);
+  _lastWallAt = _wheelTime;
+  _clockWasValid = wallClockValid(_lastWall);
+
+  _load();
+  _updateCache();
+}
+
+/**
+ * @brief 推进时间轮
+ *
+ * 每个刻度只处理当前槽位的链表：圈数为 0 的条目到期，其余圈数减一。
+ * 主循环被阻塞时逐格补齐，不会漏掉到期条目。
+ */
+void TimerManager_::tick()
+{
+  unsigned long now = millis();
+  while ((long)(now - _wheelTime) >= TIMER_TICK_MS)
+  {
+    _wheelTime += TIMER_TICK_MS;
+    _cursor = (_cursor + 1) & (TIMER_WHEEL_SLOTS - 1);
+
+    int8_t i = _wheel[_cursor];
+    while (i >= 0)
+    {
+      TimerEntry &e = _entries[i];
+      int8_t next = e.next;
+      if (e.rounds == 0)
+      {
+        _unschedule(i);
+        _fire(i);
+      }
+      else
+      {
+        e.rounds--;
+      }
+      i = next;
+    }
+  }
+
+  // 每秒检查墙上时间：首次有效或发生跳变 (NTP 同步) 时重排闹钟
+  if (now - _lastWallAt >= 1000)
+  {
+    time_t wall = time(nullptr);
+    bool valid = wallClockValid(wall);
+    long drift = (long)(wall - _lastWall) - (long)((now - _lastWallAt) / 1000);
+    if (valid && (!_clockWasValid || drift > 2 || drift < -2))
+      _rescheduleAlarms();
+    _clockWasValid = valid;
+    _lastWall = wall;
+    _lastWallAt = now;
+  }
+}
+
+/// 把条目挂到到期刻度所在的槽位 (链表头插入)
+void TimerManager_::_schedule(int8_t index, unsigned long deadline)
+{
+  TimerEntry &e = _entries[index];
+  if (e.scheduled)
+    _unschedule(index);
+
+  long delta = (long)(deadline - _wheelTime);
+  uint32_t ticks = delta <= 0 ? 1 : (delta + TIMER_TICK_MS - 1) / TIMER_TICK_MS;
+
+  e.slot = (_cursor + ticks) & (TIMER_WHEEL_SLOTS - 1);
+  e.rounds = (ticks - 1) / TIMER_WHEEL_SLOTS;
+  e.prev = -1;
+  e.next = _wheel[e.slot];
+  if (e.next >= 0)
+    _entries[e.next].prev = index;
+  _wheel[e.slot] = index;
+  e.scheduled = true;
+}
+
+void TimerManager_::_unschedule(int8_t index)
+{
+  TimerEntry &e = _entries[index];
+  if (!e.scheduled)
+    return;
+
+  if (e.prev >= 0)
+    _entries[e.prev].next = e.next;
+  else
+    _wheel[e.slot] = e.next;
+  if (e.next >= 0)
+    _entries[e.next].prev = e.prev;
+  e.prev = e.next = -1;
+  e.scheduled = false;
+}
+
+/// 条目到期
+void TimerManager_::_fire(int8_t index)
+{
+  TimerEntry &e = _entries[index];
+  if (e.state == TIMER_RINGING)
+  {
+    LOG_INFO("[Timer] #%u 响铃超时，自动停止", e.id);
+    _stopRinging(index);
+  }
+  else if (e.state == TIMER_RUNNING &&
+           (e.type == TIMER_ALARM || e.type == TIMER_COUNTDOWN))
+  {
+    _ring(index);
+    _save();
+  }
+}
+
+/**
+ * @brief 按墙上时间排下一次闹钟
+ *
+ * 从今天起找第一个在星期掩码内、且晚于现在的 时:分，
+ * 换算成 millis 到期时间 (含秒内毫秒偏移) 挂入时间轮。
+ */
+void TimerManager_::_scheduleAlarm(int8_t index)
+{
+  TimerEntry &e = _entries[index];
+  struct timeval tv;
+  gettimeofday(&tv, nullptr);
+  time_t now = tv.tv_sec;
+  if (!wallClockValid(now))
+  {
+    _unschedule(index);
+    return;
+  }
+
+  struct tm today;
+  localtime_r(&now, &today);
+  for (int day = 0; day <= 7; day++)
+  {
+    struct tm candidate = today;
+    candidate.tm_mday += day;
+    candidate.tm_hour = e.hour;
+    candidate.tm_min = e.minute;
+    candidate.tm_sec = 0;
+    candidate.tm_isdst = -1;
+    time_t target = mktime(&candidate); // 同时规范化 tm_wday
+    if (target <= now)
+      continue;
+    if (e.days && !(e.days & (1 << candidate.tm_wday)))
+      continue;
+
+    uint32_t ms = (uint32_t)(target - now) * 1000UL - tv.tv_usec / 1000;
+    _schedule(index, millis() + ms);
+    return;
+  }
+}
+
+void TimerManager_::_rescheduleAlarms()
+{
+  for (int8_t i = 0; i < TIMER_MAX_ENTRIES; i++)
+  {
+    const TimerEntry &e = _entries[i];
+    if (e.used && e.type == TIMER_ALARM && e.state == TIMER_RUNNING)
+      _scheduleAlarm(i);
+  }
+  LOG_INFO("[Timer] 时间已更新，重排闹钟");
+}
+
+// ==================================================================
+// 响铃
+// ==================================================================
+
+void TimerManager_::_ring(int8_t index)
+{
+  TimerEntry &e = _entries[index];
+  e.state = TIMER_RINGING;
+  e.deadline = millis() + TIMER_RING_TIMEOUT;
+  _schedule(index, e.deadline);
+  _ringing = index;
+  _updateCache();
+  LOG_INFO("[Timer] #%u %s 响铃", e.id,
+           e.type == TIMER_ALARM ? "闹钟" : "倒计时");
+}
+
+/// 停止响铃：重复闹钟排下一次，单次闹钟禁用，倒计时删除
+void TimerManager_::_stopRinging(int8_t index)
+{
+  TimerEntry &e = _entries[index];
+  _unschedule(index);
+  if (e.type == TIMER_ALARM)
+  {
+    e.state = e.days ? TIMER_RUNNING : TIMER_IDLE;
+    if (e.state == TIMER_RUNNING)
+      _scheduleAlarm(index);
+  }
+  else
+  {
+    e.used = false;
+    if (_focus == index)
+      _focus = -1;
+  }
+
+  if (_ringing == index)
+  {
+    _ringing = -1;
+    for (int8_t i = 0; i < TIMER_MAX_ENTRIES; i++)
+    {
+      if (_entries[i].used && _entries[i].state == TIMER_RINGING)
+      {
+        _ringing = i;
+        break;
+      }
+    }
+  }
+  _updateCache();
+  _save();
+}
+
+bool TimerManager_::dismiss()
+{
+  if (_ringing < 0)
+    return false;
+  _stopRinging(_ringing);
+  return true;
+}
+
+// ==================================================================
+// 命令
+// ==================================================================
+
+int8_t TimerManager_::_find(uint16_t id) const
+{
+  for (int8_t i = 0; i < TIMER_MAX_ENTRIES; i++)
+  {
+    if (_entries[i].used && _entries[i].id == id)
+      return i;
+  }
+  return -1;
+}
+
+int8_t TimerManager_::_alloc()
+{
+  for (int8_t i = 0; i < TIMER_MAX_ENTRIES; i++)
+  {
+    TimerEntry &e = _entries[i];
+    if (!e.used)
+    {
+      memset(&e, 0, sizeof(e));
+      e.used = true;
+      e.prev = e.next = -1;
+      return i;
+    }
+  }
+  return -1;
+}
+
+static void copyLabel(char *dst, const char *src)
+{
+  strncpy(dst, src, TIMER_LABEL_LEN - 1);
+  dst[TIMER_LABEL_LEN - 1] = '\0';
+}
+
+uint16_t TimerManager_::setAlarm(JsonObject cmd, String &error)
+{
+  int hour = cmd["hour"] | -1;
+  int minute = cmd["minute"] | -1;
+  uint16_t id = cmd["id"] | 0;
+  int8_t i = id ? _find(id) : -1;
+
+  if (id && (i < 0 || _entries[i].type != TIMER_ALARM))
+  {
+    error = "not found";
+    return 0;
+  }
+  // 修改已有闹钟时可省略时间
+  if (i >= 0)
+  {
+    if (hour < 0)
+      hour = _entries[i].hour;
+    if (minute < 0)
+      minute = _entries[i].minute;
+  }
+  if (hour < 0 || hour > 23 || minute < 0 || minute > 59)
+  {
+    error = "invalid time";
+    return 0;
+  }
+
+  if (i < 0)
+  {
+    i = _alloc();
+    if (i < 0)
+    {
+      error = "no free slot";
+      return 0;
+    }
+    _entries[i].id = _nextId++;
+    _entries[i].type = TIMER_ALARM;
+  }
+
+  TimerEntry &e = _entries[i];
+  if (e.state == TIMER_RINGING)
+    _stopRinging(i);
+  e.hour = hour;
+  e.minute = minute;
+  if (cmd.containsKey("days"))
+    e.days = cmd["days"].as<uint8_t>() & 0x7F;
+  if (cmd.containsKey("label"))
+    copyLabel(e.label, cmd["label"] | "");
+  bool enabled = cmd["enabled"] | true;
+  e.state = enabled ? TIMER_RUNNING : TIMER_IDLE;
+  if (enabled)
+    _scheduleAlarm(i);
+  else
+    _unschedule(i);
+
+  LOG_INFO("[Timer] 闹钟 #%u %02d:%02d %s", e.id, hour, minute,
+           enabled ? "启用" : "禁用");
+  _save();
+  return e.id;
+}
+
+uint16_t TimerManager_::start(JsonObject cmd, String &error)
+{
+  const char *kind = cmd["kind"] | "countdown";
+  bool stopwatch = strcmp(kind, "stopwatch") == 0;
+  uint32_t seconds = cmd["duration"] | 0;
+  if (!stopwatch && (strcmp(kind, "countdown") != 0 || seconds == 0 ||
+                     seconds > TIMER_MAX_SECONDS))
+  {
+    error = "invalid timer";
+    return 0;
+  }
+
+  int8_t i = _alloc();
+  if (i < 0)
+  {
+    error = "no free slot";
+    return 0;
+  }
+
+  TimerEntry &e = _entries[i];
+  e.id = _nextId++;
+  e.state = TIMER_RUNNING;
+  copyLabel(e.label, cmd["label"] | "");
+  if (stopwatch)
+  {
+    e.type = TIMER_STOPWATCH;
+    e.startedAt = millis();
+  }
+  else
+  {
+    e.type = TIMER_COUNTDOWN;
+    e.duration = seconds * 1000UL;
+    e.deadline = millis() + e.duration;
+    _schedule(i, e.deadline);
+  }
+  if (cmd["show"] | false)
+  {
+    if (_focus >= 0)
+      _entries[_focus].show = false;
+    e.show = true;
+    _focus = i;
+  }
+
+  LOG_INFO("[Timer] %s #%u 开始", stopwatch ? "秒表" : "倒计时", e.id);
+  _updateCache();
+  _save();
+  return e.id;
+}
+
+bool TimerManager_::control(uint16_t id, const char *action, String &error)
+{
+  int8_t i = _find(id);
+  if (i < 0)
+  {
+    error = "not found";
+    return false;
+  }
+
+  TimerEntry &e = _entries[i];
+  unsigned long now = millis();
+
+  if (strcmp(action, "cancel") == 0)
+  {
+    if (e.state == TIMER_RINGING)
+      _stopRinging(i);
+    _unschedule(i);
+    e.used = false;
+    if (_focus == i)
+      _focus = -1;
+  }
+  else if (strcmp(action, "show") == 0 || strcmp(action, "hide") == 0)
+  {
+    bool show = action[0] == 's';
+    if (_focus >= 0)
+      _entries[_focus].show = false;
+    e.show = show;
+    _focus = show ? i : -1;
+  }
+  else if (e.type == TIMER_ALARM || e.state == TIMER_RINGING)
+  {
+    error = "invalid action";
+    return false;
+  }
+  else if (strcmp(action, "pause") == 0)
+  {
+    if (e.state != TIMER_RUNNING)
+      return true;
+    if (e.type == TIMER_COUNTDOWN)
+    {
+      long remaining = (long)(e.deadline - now);
+      e.heldMs = remaining > 0 ? remaining : 0;
+      _unschedule(i);
+    }
+    else
+    {
+      e.heldMs = now - e.startedAt;
+    }
+    e.state = TIMER_PAUSED;
+  }
+  else if (strcmp(action, "resume") == 0)
+  {
+    if (e.state != TIMER_PAUSED)
+      return true;
+    if (e.type == TIMER_COUNTDOWN)
+    {
+      e.deadline = now + e.heldMs;
+      _schedule(i, e.deadline);
+    }
+    else
+    {
+      e.startedAt = now - e.heldMs;
+    }
+    e.state = TIMER_RUNNING;
+  }
+  else if (strcmp(action, "reset") == 0)
+  {
+    _unschedule(i);
+    e.heldMs = e.type == TIMER_COUNTDOWN ? e.duration : 0;
+    e.state = TIMER_PAUSED;
+  }
+  else
+  {
+    error = "invalid action";
+    return false;
+  }
+
+  _updateCache();
+  _save();
+  return true;
+}
+
+/// 更新最早到期的倒计时 (只在条目变化时执行，渲染时不扫描)
+void TimerManager_::_updateCache()
+{
+  _nearest = -1;
+  for (int8_t i = 0; i < TIMER_MAX_ENTRIES; i++)
+  {
+    const TimerEntry &e = _entries[i];
+    if (!e.used || e.type != TIMER_COUNTDOWN || e.state != TIMER_RUNNING)
+      continue;
+    if (_nearest < 0 ||
+        (long)(e.deadline - _entries[_nearest].deadline) < 0)
+      _nearest = i;
+  }
+}
+
+void TimerManager_::toJson(JsonArray out)
+{
+  static const char *TYPE_NAMES[] = {"alarm", "countdown", "stopwatch"};
+  static const char *STATE_NAMES[] = {"idle", "running", "paused", "ringing"};
+  unsigned long now = millis();
+
+  for (const auto &e : _entries)
+  {
+    if (!e.used)
+      continue;
+    JsonObject item = out.createNestedObject();
+    item["id"] = e.id;
+    item["kind"] = TYPE_NAMES[e.type];
+    item["state"] = STATE_NAMES[e.state];
+    item["label"] = e.label;
+    item["show"] = e.show;
+    if (e.type == TIMER_ALARM)
+    {
+      item["hour"] = e.hour;
+      item["minute"] = e.minute;
+      item["days"] = e.days;
+    }
+    else if (e.type == TIMER_COUNTDOWN)
+    {
+      item["duration"] = e.duration / 1000;
+      long remaining = e.state == TIMER_RUNNING ? (long)(e.deadline - now)
+                                                : (long)e.heldMs;
+      item["remainingMs"] = e.state == TIMER_RINGING ? 0 : max(remaining, 0L);
+    }
+    else
+    {
+      item["elapsedMs"] =
+          e.state == TIMER_RUNNING ? (uint32_t)(now - e.startedAt) : e.heldMs;
+    }
+  }
+}
+
+// ==================================================================
+// 渲染
+// ==================================================================
+
+/**
+ * @brief 全屏绘制时长
+ *
+ * 倒计时: ≥1 小时 "H:MM:SS"，≥1 分钟 "MM:SS"，其余 "SS.t"
+ * 秒表:   ≥1 小时 "H:MM:SS"，其余 "MM:SS.t"
+ */
+void TimerManager_::_drawDuration(FastLED_NeoMatrix *matrix, uint32_t ms,
+                                  bool stopwatch, uint16_t color)
+{
+  // 倒计时向上取整到 0.1 秒，显示到 0.0 时正好到期
+  if (!stopwatch)
+    ms = (ms + 99) / 100 * 100;
+
+  uint32_t tenths = (ms / 100) % 10;
+  uint32_t seconds = (ms / 1000) % 60;
+  uint32_t minutes = (ms / 60000) % 60;
+  uint32_t hours = ms / 3600000;
+
+  char text[12];
+  if (hours > 0)
+    snprintf(text, sizeof(text), "%lu:%02lu:%02lu", (unsigned long)hours,
+             (unsigned long)minutes, (unsigned long)seconds);
+  else if (stopwatch)
+    snprintf(text, sizeof(text), "%02lu:%02lu.%lu", (unsigned long)minutes,
+             (unsigned long)seconds, (unsigned long)tenths);
+  else if (minutes > 0)
+    snprintf(text, sizeof(text), "%02lu:%02lu", (unsigned long)minutes,
+             (unsigned long)seconds);
+  else
+    snprintf(text, sizeof(text), "%lu.%lu", (unsigned long)seconds,
+             (unsigned long)tenths);
+
+  matrix->setTextColor(color);
+  DisplayManager.printText(0, 6, text, true, true);
+}
+
+/**
+ * @brief 渲染计时
+ *
+ * 选中的倒计时/秒表全屏显示；否则最早到期的倒计时在最后 10 秒全屏，
+ * 之前在顶行画剩余进度条。剩余时间每帧按 millis() 计算。
+ */
+void TimerManager_::renderTimer(FastLED_NeoMatrix *matrix,
+                                MatrixDisplayUiState *state,
+                                FastFramePlayer *player)
+{
+  unsigned long now = millis();
+  int8_t index = -1;
+  bool fullscreen = false;
+
+  if (_focus >= 0 && _entries[_focus].state != TIMER_RINGING &&
+      _entries[_focus].type != TIMER_ALARM)
+  {
+    index = _focus;
+    fullscreen = true;
+  }
+  else if (_nearest >= 0)
+  {
+    index = _nearest;
+    fullscreen = (long)(_entries[index].deadline - now) <= TIMER_FULLSCREEN_MS;
+  }
+  if (index < 0)
+    return;
+
+  const TimerEntry &e = _entries[index];
+  bool stopwatch = e.type == TIMER_STOPWATCH;
+  uint32_t ms;
+  if (e.state == TIMER_RUNNING)
+  {
+    long value = stopwatch ? (long)(now - e.startedAt) : (long)(e.deadline - now);
+    ms = value > 0 ? value : 0;
+  }
+  else
+  {
+    ms = e.heldMs;
+  }
+
+  if (!fullscreen)
+  {
+    // 顶行剩余进度条 (每格对应 duration/宽度)
+    if (e.state == TIMER_RUNNING && e.duration)
+      state->requestFrame(e.duration / MATRIX_WIDTH, FRAME_CONTENT);
+    uint16_t width = e.duration ? (uint64_t)ms * MATRIX_WIDTH / e.duration : 0;
+    if (width > 0)
+      matrix->drawFastHLine(0, 0, width, TEXTCOLOR_565);
+    return;
+  }
+
+  state->overlayActive = true;
+  // 运行中显示到 0.1 秒；暂停时按闪烁翻转时刻
+  if (e.state == TIMER_RUNNING)
+    state->requestFrame(100 - ms % 100, FRAME_CONTENT);
+  else if (e.state == TIMER_PAUSED)
+    state->requestFrame(500 - now % 500, FRAME_CONTENT);
+  matrix->fillScreen(0);
+  // 暂停时以 1Hz 闪烁
+  if (e.state == TIMER_PAUSED && (now / 500) % 2)
+    return;
+  _drawDuration(matrix, ms, stopwatch, TEXTCOLOR_565);
+}
+
+/// 渲染响铃：全屏闪烁显示标签 (闹钟无标签时显示 时:分)
+void TimerManager_::renderAlarm(FastLED_NeoMatrix *matrix,
+                                MatrixDisplayUiState *state,
+                                FastFramePlayer *player)
+{
+  if (_ringing < 0)
+    return;
+
+  const TimerEntry &e = _entries[_ringing];
+  state->overlayActive = true;
+  state->requestFrame(500 - millis() % 500, FRAME_CONTENT);
+  matrix->fillScreen(0);
+  if ((millis() / 500) % 2)
+    return;
+
+  char text[TIMER_LABEL_LEN];
+  if (e.label[0])
+    strcpy(text, e.label);
+  else if (e.type == TIMER_ALARM)
+    snprintf(text, sizeof(text), "%02u:%02u", e.hour, e.minute);
+  else
+    strcpy(text, "TIME UP");
+
+  matrix->setTextColor(e.type == TIMER_ALARM ? TEXTCOLOR_565 : 0xF800);
+  DisplayManager.printText(0, 6, utf8ascii(text).c_str(), true, false);
+}
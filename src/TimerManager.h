@@ -0,0 +1,206 @@
+/**
+ * @file TimerManager.h
+ * @brief 闹钟/倒计时/秒表 — 时间轮调度，由 AlarmOverlay / TimerOverlay 渲染
+ *
+ * 本文件定义：
+ *   - TimerEntry 结构体: 单个闹钟、倒计时或秒表
+ *   - TimerManager_ 单例类: 调度、持久化、命令接口、覆盖层渲染
+ *
+ * 调度 (哈希时间轮)：
+ *   - TIMER_WHEEL_SLOTS 个槽位，每 TIMER_TICK_MS 前进一格
+ *   - 条目按到期刻度挂到槽位链表上，超过一圈的记录剩余圈数
+ *   - 每格只处理当前槽位的链表，与条目总数无关，不扫描列表
+ *   - 秒表没有到期时间，不进入时间轮
+ *
+ * 显示：
+ *   - 倒计时/秒表的剩余/经过时间在渲染时按 millis() 计算，逐帧精确
+ *   - 响铃中的条目由 AlarmOverlay 全屏显示，选择按钮关闭
+ *   - TimerOverlay 全屏显示被选中 (show) 的计时，最后 10 秒的倒计时
+ *     自动全屏，其余时间在顶行显示进度条
+ *
+ * 持久化：
+ *   - 条目变化时写入 NVS 命名空间 "timers"
+ *   - 运行中的倒计时/秒表记录墙上时间基准，重启后按 RTC 时间恢复；
+ *     时间无效时按保存时的剩余/经过时间恢复
+ */
+
+#ifndef TIMER_MANAGER_H
+#define TIMER_MANAGER_H
+
+#include "FastFramePlayer.h"
+#include "MatrixDisplayUi.h"
+#include <Arduino.h>
+#include <ArduinoJson.h>
+
+// ==================================================================
+// 调度配置
+// ==================================================================
+
+/// 最大条目数
+#define TIMER_MAX_ENTRIES 16
+
+/// 时间轮槽位数 (2 的幂)
+#define TIMER_WHEEL_SLOTS 256
+
+/// 时间轮刻度 (毫秒，约一帧)
+#define TIMER_TICK_MS 20
+
+/// 响铃自动停止时间 (毫秒)
+#define TIMER_RING_TIMEOUT 60000
+
+/// 倒计时最后多少毫秒自动全屏显示
+#define TIMER_FULLSCREEN_MS 10000
+
+/// 倒计时最长时长 (秒)，99:59:59；保证毫秒时长与调度差值不溢出
+#define TIMER_MAX_SECONDS (99UL * 3600 + 59 * 60 + 59)
+
+/// 标签最大长度 (含结尾 '\0')
+#define TIMER_LABEL_LEN 12
+
+// ==================================================================
+// 条目
+// ==================================================================
+
+/// 条目类型
+enum TimerType : uint8_t
+{
+  TIMER_ALARM = 0,     ///< 闹钟 (每天/按星期的 时:分)
+  TIMER_COUNTDOWN = 1, ///< 倒计时
+  TIMER_STOPWATCH = 2  ///< 秒表
+};
+
+/// 条目状态
+enum TimerState : uint8_t
+{
+  TIMER_IDLE = 0,    ///< 未运行 (闹钟=已禁用)
+  TIMER_RUNNING = 1, ///< 运行中 (闹钟=已启用)
+  TIMER_PAUSED = 2,  ///< 已暂停 (倒计时/秒表)
+  TIMER_RINGING = 3  ///< 响铃中
+};
+
+/// 单个条目 (定长)
+struct TimerEntry
+{
+  bool used;
+  uint16_t id;                 ///< 条目 ID (命令中引用)
+  TimerType type;
+  TimerState state;
+  char label[TIMER_LABEL_LEN]; ///< 标签
+  bool show;                   ///< 由 TimerOverlay 全屏显示
+
+  // 闹钟
+  uint8_t hour;
+  uint8_t minute;
+  uint8_t days; ///< 星期掩码 (bit0=周日 … bit6=周六，0=只响一次)
+
+  // 倒计时/秒表
+  uint32_t duration;       ///< 倒计时总时长 (ms)
+  unsigned long deadline;  ///< 倒计时到期 / 响铃超时 (millis)
+  unsigned long startedAt; ///< 秒表起点 (millis)
+  uint32_t heldMs;         ///< 暂停时的剩余 (倒计时) / 经过 (秒表) 时间
+
+  // 时间轮链表
+  int8_t prev;
+  int8_t next;
+  uint8_t slot;
+  uint32_t rounds;
+  bool scheduled;
+};
+
+// ==================================================================
+// 管理器类
+// ==================================================================
+
+/**
+ * @class TimerManager_
+ * @brief 闹钟/倒计时/秒表管理器
+ */
+class TimerManager_
+{
+public:
+  static TimerManager_ &getInstance();
+
+  /// 从 NVS 恢复条目
+  void setup();
+
+  /// 推进时间轮 (主循环调用)
+  void tick();
+
+  /**
+   * @brief 创建或修改闹钟
+   * @param cmd {id?, hour, minute, days, label, enabled}
+   * @param error 输出: 失败原因
+   * @return 条目 ID，0=失败
+   */
+  uint16_t setAlarm(JsonObject cmd, String &error);
+
+  /**
+   * @brief 启动倒计时或秒表
+   * @param cmd {kind: "countdown"|"stopwatch", duration (秒，1 ~ TIMER_MAX_SECONDS), label, show}
+   * @param error 输出: 失败原因
+   * @return 条目 ID，0=失败
+   */
+  uint16_t start(JsonObject cmd, String &error);
+
+  /**
+   * @brief 控制条目
+   * @param id 条目 ID
+   * @param action pause / resume / reset / cancel / show / hide
+   * @param error 输出: 失败原因
+   */
+  bool control(uint16_t id, const char *action, String &error);
+
+  /// 关闭当前响铃 @return true=有响铃被关闭
+  bool dismiss();
+
+  /// 是否有条目在响铃
+  bool isRinging() const { return _ringing >= 0; }
+
+  /// 输出全部条目
+  void toJson(JsonArray out);
+
+  /// 渲染响铃 (AlarmOverlay)
+  void renderAlarm(FastLED_NeoMatrix *matrix, MatrixDisplayUiState *state,
+                   FastFramePlayer *player);
+
+  /// 渲染计时 (TimerOverlay)
+  void renderTimer(FastLED_NeoMatrix *matrix, MatrixDisplayUiState *state,
+                   FastFramePlayer *player);
+
+private:
+  TimerManager_() = default;
+
+  TimerEntry _entries[TIMER_MAX_ENTRIES];
+  int8_t _wheel[TIMER_WHEEL_SLOTS]; ///< 每个槽位的链表头 (-1=空)
+  uint8_t _cursor = 0;
+  unsigned long _wheelTime = 0; ///< 当前刻度对应的 millis
+  uint16_t _nextId = 1;
+
+  int8_t _ringing = -1;  ///< 正在显示的响铃条目
+  int8_t _focus = -1;    ///< 被选中全屏显示的条目
+  int8_t _nearest = -1;  ///< 最早到期的运行中倒计时 (条目变化时更新)
+
+  // 墙上时间跳变检测 (NTP 同步后重排闹钟)
+  time_t _lastWall = 0;
+  unsigned long _lastWallAt = 0;
+  bool _clockWasValid = false;
+
+  void _schedule(int8_t index, unsigned long deadline);
+  void _unschedule(int8_t index);
+  void _fire(int8_t index);
+  void _scheduleAlarm(int8_t index);
+  void _rescheduleAlarms();
+  void _ring(int8_t index);
+  void _stopRinging(int8_t index);
+  void _updateCache();
+  int8_t _find(uint16_t id) const;
+  int8_t _alloc();
+  void _save();
+  void _load();
+  void _drawDuration(FastLED_NeoMatrix *matrix, uint32_t ms, bool stopwatch,
+                     uint16_t color);
+};
+
+extern TimerManager_ &TimerManager;
+
+#endif
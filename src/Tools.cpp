@@ -7,6 +7,7 @@
  *   - HEXtoColor: 去除 String 操作，使用纯 C 字符串解析
  *   - getTextWidth: 直接数组索引，消除 map::count + map::operator[]
  *   - utf8ascii: 增加 C 字符串重载，避免不必要的 String 构造
+ *   - hsvToRgb: 色轮查表 + 移位缩放，去掉每次调用的除法 (误差 ≤1 个 RGB565 单位)
  */
 
 #include "Tools.h"
@@ -92,50 +93,129 @@ uint32_t hexTo888(const char *hex) {
   return ((uint32_t)r << 16) | ((uint32_t)g << 8) | b;
 }
 
-uint16_t hsvToRgb(uint16_t hue, uint8_t sat, uint8_t val) {
-  uint8_t r, g, b;
-  uint8_t region, remainder, p, q, t;
+CRGB hexToCRGB(const char *hex) { return CRGB(hexTo888(hex)); }
+
+// 满饱和度、满亮度的色轮 (每度一项 RGB888，与原公式逐项一致)
+static const uint8_t HUE_WHEEL[360][3] PROGMEM = {
+    // 0~59
+    {255, 0, 0}, {255, 4, 0}, {255, 8, 0}, {255, 12, 0}, {255, 17, 0},
+    {255, 21, 0}, {255, 25, 0}, {255, 29, 0}, {255, 34, 0}, {255, 38, 0},
+    {255, 42, 0}, {255, 46, 0}, {255, 51, 0}, {255, 55, 0}, {255, 59, 0},
+    {255, 64, 0}, {255, 68, 0}, {255, 72, 0}, {255, 76, 0}, {255, 81, 0},
+    {255, 85, 0}, {255, 89, 0}, {255, 93, 0}, {255, 98, 0}, {255, 102, 0},
+    {255, 106, 0}, {255, 110, 0}, {255, 115, 0}, {255, 119, 0}, {255, 123, 0},
+    {255, 128, 0}, {255, 132, 0}, {255, 136, 0}, {255, 140, 0}, {255, 145, 0},
+    {255, 149, 0}, {255, 153, 0}, {255, 157, 0}, {255, 162, 0}, {255, 166, 0},
+    {255, 170, 0}, {255, 174, 0}, {255, 179, 0}, {255, 183, 0}, {255, 187, 0},
+    {255, 192, 0}, {255, 196, 0}, {255, 200, 0}, {255, 204, 0}, {255, 209, 0},
+    {255, 213, 0}, {255, 217, 0}, {255, 221, 0}, {255, 226, 0}, {255, 230, 0},
+    {255, 234, 0}, {255, 238, 0}, {255, 243, 0}, {255, 247, 0}, {255, 251, 0},
+    // 60~119
+    {254, 255, 0}, {251, 255, 0}, {247, 255, 0}, {243, 255, 0}, {238, 255, 0},
+    {234, 255, 0}, {230, 255, 0}, {226, 255, 0}, {221, 255, 0}, {217, 255, 0},
+    {213, 255, 0}, {209, 255, 0}, {204, 255, 0}, {200, 255, 0}, {196, 255, 0},
+    {191, 255, 0}, {187, 255, 0}, {183, 255, 0}, {179, 255, 0}, {174, 255, 0},
+    {170, 255, 0}, {166, 255, 0}, {162, 255, 0}, {157, 255, 0}, {153, 255, 0},
+    {149, 255, 0}, {145, 255, 0}, {140, 255, 0}, {136, 255, 0}, {132, 255, 0},
+    {127, 255, 0}, {123, 255, 0}, {119, 255, 0}, {115, 255, 0}, {110, 255, 0},
+    {106, 255, 0}, {102, 255, 0}, {98, 255, 0}, {93, 255, 0}, {89, 255, 0},
+    {85, 255, 0}, {81, 255, 0}, {76, 255, 0}, {72, 255, 0}, {68, 255, 0},
+    {63, 255, 0}, {59, 255, 0}, {55, 255, 0}, {51, 255, 0}, {46, 255, 0},
+    {42, 255, 0}, {38, 255, 0}, {34, 255, 0}, {29, 255, 0}, {25, 255, 0},
+    {21, 255, 0}, {17, 255, 0}, {12, 255, 0}, {8, 255, 0}, {4, 255, 0},
+    // 120~179
+    {0, 255, 0}, {0, 255, 4}, {0, 255, 8}, {0, 255, 12}, {0, 255, 17},
+    {0, 255, 21}, {0, 255, 25}, {0, 255, 29}, {0, 255, 34}, {0, 255, 38},
+    {0, 255, 42}, {0, 255, 46}, {0, 255, 51}, {0, 255, 55}, {0, 255, 59},
+    {0, 255, 64}, {0, 255, 68}, {0, 255, 72}, {0, 255, 76}, {0, 255, 81},
+    {0, 255, 85}, {0, 255, 89}, {0, 255, 93}, {0, 255, 98}, {0, 255, 102},
+    {0, 255, 106}, {0, 255, 110}, {0, 255, 115}, {0, 255, 119}, {0, 255, 123},
+    {0, 255, 128}, {0, 255, 132}, {0, 255, 136}, {0, 255, 140}, {0, 255, 145},
+    {0, 255, 149}, {0, 255, 153}, {0, 255, 157}, {0, 255, 162}, {0, 255, 166},
+    {0, 255, 170}, {0, 255, 174}, {0, 255, 179}, {0, 255, 183}, {0, 255, 187},
+    {0, 255, 192}, {0, 255, 196}, {0, 255, 200}, {0, 255, 204}, {0, 255, 209},
+    {0, 255, 213}, {0, 255, 217}, {0, 255, 221}, {0, 255, 226}, {0, 255, 230},
+    {0, 255, 234}, {0, 255, 238}, {0, 255, 243}, {0, 255, 247}, {0, 255, 251},
+    // 180~239
+    {0, 254, 255}, {0, 251, 255}, {0, 247, 255}, {0, 243, 255}, {0, 238, 255},
+    {0, 234, 255}, {0, 230, 255}, {0, 226, 255}, {0, 221, 255}, {0, 217, 255},
+    {0, 213, 255}, {0, 209, 255}, {0, 204, 255}, {0, 200, 255}, {0, 196, 255},
+    {0, 191, 255}, {0, 187, 255}, {0, 183, 255}, {0, 179, 255}, {0, 174, 255},
+    {0, 170, 255}, {0, 166, 255}, {0, 162, 255}, {0, 157, 255}, {0, 153, 255},
+    {0, 149, 255}, {0, 145, 255}, {0, 140, 255}, {0, 136, 255}, {0, 132, 255},
+    {0, 127, 255}, {0, 123, 255}, {0, 119, 255}, {0, 115, 255}, {0, 110, 255},
+    {0, 106, 255}, {0, 102, 255}, {0, 98, 255}, {0, 93, 255}, {0, 89, 255},
+    {0, 85, 255}, {0, 81, 255}, {0, 76, 255}, {0, 72, 255}, {0, 68, 255},
+    {0, 63, 255}, {0, 59, 255}, {0, 55, 255}, {0, 51, 255}, {0, 46, 255},
+    {0, 42, 255}, {0, 38, 255}, {0, 34, 255}, {0, 29, 255}, {0, 25, 255},
+    {0, 21, 255}, {0, 17, 255}, {0, 12, 255}, {0, 8, 255}, {0, 4, 255},
+    // 240~299
+    {0, 0, 255}, {4, 0, 255}, {8, 0, 255}, {12, 0, 255}, {17, 0, 255},
+    {21, 0, 255}, {25, 0, 255}, {29, 0, 255}, {34, 0, 255}, {38, 0, 255},
+    {42, 0, 255}, {46, 0, 255}, {51, 0, 255}, {55, 0, 255}, {59, 0, 255},
+    {64, 0, 255}, {68, 0, 255}, {72, 0, 255}, {76, 0, 255}, {81, 0, 255},
+    {85, 0, 255}, {89, 0, 255}, {93, 0, 255}, {98, 0, 255}, {102, 0, 255},
+    {106, 0, 255}, {110, 0, 255}, {115, 0, 255}, {119, 0, 255}, {123, 0, 255},
+    {128, 0, 255}, {132, 0, 255}, {136, 0, 255}, {140, 0, 255}, {145, 0, 255},
+    {149, 0, 255}, {153, 0, 255}, {157, 0, 255}, {162, 0, 255}, {166, 0, 255},
+    {170, 0, 255}, {174, 0, 255}, {179, 0, 255}, {183, 0, 255}, {187, 0, 255},
+    {192, 0, 255}, {196, 0, 255}, {200, 0, 255}, {204, 0, 255}, {209, 0, 255},
+    {213, 0, 255}, {217, 0, 255}, {221, 0, 255}, {226, 0, 255}, {230, 0, 255},
+    {234, 0, 255}, {238, 0, 255}, {243, 0, 255}, {247, 0, 255}, {251, 0, 255},
+    // 300~359
+    {255, 0, 254}, {255, 0, 251}, {255, 0, 247}, {255, 0, 243}, {255, 0, 238},
+    {255, 0, 234}, {255, 0, 230}, {255, 0, 226}, {255, 0, 221}, {255, 0, 217},
+    {255, 0, 213}, {255, 0, 209}, {255, 0, 204}, {255, 0, 200}, {255, 0, 196},
+    {255, 0, 191}, {255, 0, 187}, {255, 0, 183}, {255, 0, 179}, {255, 0, 174},
+    {255, 0, 170}, {255, 0, 166}, {255, 0, 162}, {255, 0, 157}, {255, 0, 153},
+    {255, 0, 149}, {255, 0, 145}, {255, 0, 140}, {255, 0, 136}, {255, 0, 132},
+    {255, 0, 127}, {255, 0, 123}, {255, 0, 119}, {255, 0, 115}, {255, 0, 110},
+    {255, 0, 106}, {255, 0, 102}, {255, 0, 98}, {255, 0, 93}, {255, 0, 89},
+    {255, 0, 85}, {255, 0, 81}, {255, 0, 76}, {255, 0, 72}, {255, 0, 68},
+    {255, 0, 63}, {255, 0, 59}, {255, 0, 55}, {255, 0, 51}, {255, 0, 46},
+    {255, 0, 42}, {255, 0, 38}, {255, 0, 34}, {255, 0, 29}, {255, 0, 25},
+    {255, 0, 21}, {255, 0, 17}, {255, 0, 12}, {255, 0, 8}, {255, 0, 4}};
 
+/// a × b / 255 的快速近似 (b=255 时精确返回 a)
+static inline uint8_t hsvScale(uint8_t a, uint8_t b) {
+  return (a * (b + 1)) >> 8;
+}
+
+/// HSV → RGB888 分量 (hsvToRgb / hsvToCRGB 共用)
+static inline void hsvWheel(uint16_t hue, uint8_t sat, uint8_t val, uint8_t &r,
+                            uint8_t &g, uint8_t &b) {
   if (sat == 0) {
     r = g = b = val;
-  } else {
-    hue = hue % 360;
-    region = hue / 60;
-    remainder = (hue - (region * 60)) * 256 / 60;
-
-    p = (val * (255 - sat)) >> 8;
-    q = (val * (255 - ((sat * remainder) >> 8))) >> 8;
-    t = (val * (255 - ((sat * (255 - remainder)) >> 8))) >> 8;
-
-    switch (region) {
-    case 0:
-      r = val; g = t; b = p;
-      break;
-    case 1:
-      r = q; g = val; b = p;
-      break;
-    case 2:
-      r = p; g = val; b = t;
-      break;
-    case 3:
-      r = p; g = q; b = val;
-      break;
-    case 4:
-      r = t; g = p; b = val;
-      break;
-    default:
-      r = val; g = p; b = q;
-      break;
-    }
+    return;
   }
+  if (hue >= 360)
+    hue %= 360;
+  const uint8_t *c = HUE_WHEEL[hue];
+  // 先向白色混合 (饱和度)，再整体缩放 (亮度)
+  r = hsvScale(255 - hsvScale(255 - pgm_read_byte(c), sat), val);
+  g = hsvScale(255 - hsvScale(255 - pgm_read_byte(c + 1), sat), val);
+  b = hsvScale(255 - hsvScale(255 - pgm_read_byte(c + 2), sat), val);
+}
+
+uint16_t hsvToRgb(uint16_t hue, uint8_t sat, uint8_t val) {
+  uint8_t r, g, b;
+  hsvWheel(hue, sat, val, r, g, b);
 
   // RGB888转RGB565
   return ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3);
 }
 
+CRGB hsvToCRGB(uint16_t hue, uint8_t sat, uint8_t val) {
+  CRGB c;
+  hsvWheel(hue, sat, val, c.r, c.g, c.b);
+  return c;
+}
+
 // ==================================================================
 // 文字宽度计算
 // ==================================================================
+uint8_t getCharWidth(uint8_t ch) { return CHAR_WIDTH_TABLE[ch]; }
+
 uint16_t getTextWidth(const char *text, bool ignoreUpperCase) {
   uint16_t width = 0;
   for (const char *c = text; *c != '\0'; ++c) {
@@ -18,9 +18,19 @@ uint16_t HEXtoColor(const char *hex);
 /// HEX 颜色字符串 → RGB888 (24位)
 uint32_t hexTo888(const char *hex);
 
-/// HSV → RGB565 (hue: 0-360, sat: 0-255, val: 0-255)
+/// HEX 颜色字符串 → CRGB (不截断到 565，绘制见 ColorDraw.h)
+CRGB hexToCRGB(const char *hex);
+
+/// HSV → RGB565 (hue: 0-360, sat: 0-255, val: 0-255)，色轮查表
+/// 与逐项公式相比每个分量误差不超过 1 个 RGB565 单位
 uint16_t hsvToRgb(uint16_t hue, uint8_t sat, uint8_t val);
 
+/// HSV → CRGB，与 hsvToRgb 同一色轮，保留 8 位分量
+CRGB hsvToCRGB(uint16_t hue, uint8_t sat, uint8_t val);
+
+/// 单个字符的像素宽度 (字符宽度表，0=未定义)
+uint8_t getCharWidth(uint8_t ch);
+
 /// 计算文字的像素宽度 (基于 AwtrixFont 字符宽度表)
 uint16_t getTextWidth(const char *text, bool ignoreUpperCase);
 
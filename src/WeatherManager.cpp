@@ -11,6 +11,8 @@
 #include "Logger.h"
 #include "WeatherManager.h"
 #include "Globals.h"
+#include "HeapTelemetry.h"
+#include "StackMonitor.h"
 #include <ArduinoJson.h>
 #include <HTTPClient.h>
 #include <WiFi.h>
@@ -24,6 +26,7 @@ WeatherManager_ &WeatherManager_::getInstance() {
 WeatherManager_ &WeatherManager = WeatherManager_::getInstance();
 
 void WeatherManager_::setup() {
+  HeapTagScope heapTag(HEAP_TAG_WEATHER);
   lastUpdate = 0;
   startBackgroundTask();
 }
@@ -34,6 +37,8 @@ void WeatherManager_::tick() {
 
 static void weatherTask(void *param) {
   (void)param;
+  // 本任务的全部分配 (HTTPClient、TLS、JSON) 记到天气
+  HeapTelemetry.tagTask(xTaskGetCurrentTaskHandle(), HEAP_TAG_WEATHER);
   for (;;) {
     if (WEATHER_API_KEY.length() > 0 && WiFi.status() == WL_CONNECTED) {
       // LOG_DEBUG("Starting weather fetch");
@@ -45,16 +50,18 @@ static void weatherTask(void *param) {
 
 void WeatherManager_::startBackgroundTask() {
   if (taskHandle == NULL) {
-    // 降低栈大小从 4096 到 3072 (如果流式解析省内存)
-    // 但为了安全起见保持 4096
-    xTaskCreatePinnedToCore(weatherTask, "WeatherTask", 4096, NULL, 1,
-                            &taskHandle, 1);
+    // 栈大小见 WEATHER_TASK_STACK，实际用量由 StackMonitor 采样
+    xTaskCreatePinnedToCore(weatherTask, "WeatherTask", WEATHER_TASK_STACK,
+                            NULL, 1, &taskHandle, 1);
+    StackMonitor.watch(taskHandle, "WeatherTask", WEATHER_TASK_STACK);
     LOG_INFO("[Weather] Background task started");
   }
 }
 
 void WeatherManager_::stopBackgroundTask() {
   if (taskHandle != NULL) {
+    HeapTelemetry.tagTask(taskHandle, HEAP_TAG_NONE);
+    StackMonitor.unwatch(taskHandle);
     vTaskDelete(taskHandle);
     taskHandle = NULL;
     LOG_INFO("[Weather] Background task stopped");
@@ -13,6 +13,9 @@
 
 #include <Arduino.h>
 
+/// 后台任务栈大小 (字节)，可按 getStacks 报告的建议值调整
+#define WEATHER_TASK_STACK 4096
+
 // ==================================================================
 // 天气管理器类
 // ==================================================================
@@ -11,9 +11,13 @@
  */
 
 #include "WebConfigManager.h"
+#include "BootTimeline.h"
 #include "DisplayManager.h"
+#include "HttpApi.h"
 #include "Globals.h"
 #include "Logger.h"
+#include "LoopWatchdog.h"
+#include "TimeSync.h"
 #include <ArduinoJson.h>
 #include <esp_wifi.h>
 
@@ -32,7 +36,7 @@ WebConfigManager_ &WebConfigManager = WebConfigManager_::getInstance();
 /**
  * @brief 初始化配网管理器
  *
- * 检查已保存凭据 → 尝试连接 → 失败则启动 AP 配网
+ * 检查已保存凭据 → 发起异步连接 (不阻塞) → 超时由 tick() 转入 AP 配网
  */
 void WebConfigManager_::setup()
 {
@@ -54,38 +58,21 @@ void WebConfigManager_::setup()
     {
         LOG_INFO("[WebConfig] 已保存的 WiFi: %s", savedSSID.c_str());
 
-        // 尝试连接已保存的网络
+        // 发起连接后立即返回，结果由 tick() 检测 (成功/超时转 AP 配网)
         LOG_INFO("[WebConfig] 尝试连接已保存的 WiFi...");
-        if (tryConnect(savedSSID, savedPassword))
-        {
-            LOG_INFO("[WebConfig] WiFi 连接成功！");
-            connState = WIFI_STATE_CONNECTED;
-            AP_MODE = false;
-
-            // NTP 时间同步
-            configTime(8 * 3600, 0, "ntp.aliyun.com", "pool.ntp.org",
-                       "time.nist.gov");
-            LOG_INFO("[WebConfig] NTP 时间同步已配置 (UTC+8)");
-
-            // 启动 mDNS/SSDP
-            startMDNS();
+        WiFi.mode(WIFI_STA);
+        beginConnect(savedSSID, savedPassword);
 
-            // 显示连接成功画面
-            DisplayManager.setDisplayStatus(DISPLAY_CONNECTED, savedSSID,
-                                            WiFi.localIP().toString());
-            return;
-        }
-        else
-        {
-            LOG_WARN("[WebConfig] 连接已保存的 WiFi 失败");
-        }
+        // 显示连接中动画
+        DisplayManager.setDisplayStatus(DISPLAY_CONNECTING, "", savedSSID);
+        return;
     }
     else
     {
         LOG_INFO("[WebConfig] 未找到已保存的 WiFi 凭据");
     }
 
-    // 连接失败或无凭据，启动 AP 配网模式
+    // 无凭据，启动 AP 配网模式
     startAPMode();
 
     // 通知 DisplayManager 进入 AP 模式显示
@@ -121,16 +108,20 @@ void WebConfigManager_::tick()
             lastConnectMessage = "连接成功！IP: " + WiFi.localIP().toString();
             LOG_INFO("[WebConfig] WiFi 连接成功！IP: %s", WiFi.localIP().toString().c_str());
 
-            // 保存凭据
-            saveCredentials(connectingSSID, connectingPassword);
+            // 保存凭据 (与已保存的相同时跳过 NVS 写入)
+            if (connectingSSID != savedSSID || connectingPassword != savedPassword)
+                saveCredentials(connectingSSID, connectingPassword);
 
-            // NTP 时间同步
-            configTime(8 * 3600, 0, "ntp.aliyun.com", "pool.ntp.org",
-                       "time.nist.gov");
+            // NTP 时间同步 (平滑校时 + 频偏补偿)
+            TimeSync.begin();
 
             // 启动 mDNS/SSDP
             startMDNS();
 
+            // STA 模式 HTTP API (配网门户占用端口 80 时不启动)
+            if (!portalActive)
+                HttpApi.begin();
+
             // 显示连接成功画面 (5秒后自动切换到正常模式)
             DisplayManager.setDisplayStatus(DISPLAY_CONNECTED, connectingSSID,
                                             WiFi.localIP().toString());
@@ -174,11 +165,7 @@ void WebConfigManager_::tick()
 
             if (savedSSID.length() > 0)
             {
-                WiFi.begin(savedSSID.c_str(), savedPassword.c_str());
-                connectStartTime = millis();
-                connState = WIFI_STATE_CONNECTING;
-                connectingSSID = savedSSID;
-                connectingPassword = savedPassword;
+                beginConnect(savedSSID, savedPassword);
 
                 // 更新显示为连接中动画
                 DisplayManager.setDisplayStatus(DISPLAY_CONNECTING, "", savedSSID);
@@ -254,37 +241,22 @@ void WebConfigManager_::clearCredentials()
 }
 
 /**
- * @brief 尝试连接 WiFi
+ * @brief 发起 WiFi 连接 (非阻塞)
  * @param ssid WiFi 名称
  * @param password WiFi 密码
- * @param timeout 连接超时 (毫秒)
- * @return true=连接成功, false=连接失败
+ *
+ * 仅调用 WiFi.begin() 并进入 WIFI_STATE_CONNECTING，
+ * 连接结果与超时 (WIFI_CONNECT_TIMEOUT) 由 tick() 处理
  */
-bool WebConfigManager_::tryConnect(const String &ssid, const String &password,
-                                   unsigned long timeout)
+void WebConfigManager_::beginConnect(const String &ssid, const String &password)
 {
-    WiFi.mode(WIFI_STA);
-    WiFi.begin(ssid.c_str(), password.c_str());
-
     LOG_INFO("[WebConfig] 正在连接 %s", ssid.c_str());
 
-    unsigned long start = millis();
-    while (WiFi.status() != WL_CONNECTED && (millis() - start) < timeout)
-    {
-        delay(500);
-        Serial.print(".");
-    }
-    Serial.println();
-
-    if (WiFi.status() == WL_CONNECTED)
-    {
-        LOG_INFO("[WebConfig] 已连接！IP: %s", WiFi.localIP().toString().c_str());
-        return true;
-    }
-
-    LOG_ERROR("[WebConfig] 连接 %s 失败 (status=%d)", ssid.c_str(), WiFi.status());
-    WiFi.disconnect();
-    return false;
+    WiFi.begin(ssid.c_str(), password.c_str());
+    connectStartTime = millis();
+    connState = WIFI_STATE_CONNECTING;
+    connectingSSID = ssid;
+    connectingPassword = password;
 }
 
 // =====================================================
@@ -300,6 +272,9 @@ void WebConfigManager_::startAPMode()
 {
     LOG_INFO("[WebConfig] 启动 AP 配网模式...");
 
+    // 释放端口 80 给配网 WebServer
+    HttpApi.stop();
+
     // 设置 AP + STA 模式 (保留 STA 以便后续连接)
     WiFi.mode(WIFI_AP_STA);
 
@@ -349,6 +324,10 @@ void WebConfigManager_::stopAPMode()
     portalActive = false;
     AP_MODE = false;
     LOG_INFO("[WebConfig] AP 模式已关闭");
+
+    // 端口 80 已释放，启动 STA 模式 HTTP API
+    if (WiFi.status() == WL_CONNECTED)
+        HttpApi.begin();
 }
 
 /**
@@ -470,7 +449,9 @@ void WebConfigManager_::handleScan()
 {
     LOG_INFO("[WebConfig] 扫描 WiFi 网络...");
 
+    LoopWatchdog.stageBegin(LOOP_STAGE_WIFI_SCAN);
     int n = WiFi.scanNetworks();
+    LoopWatchdog.stageEnd(LOOP_STAGE_WIFI_SCAN);
 
     DynamicJsonDocument doc(2048);
     JsonArray networks = doc.createNestedArray("networks");
@@ -553,14 +534,13 @@ void WebConfigManager_::handleConnect()
 }
 
 /**
- * @brief 处理 WiFi 状态查询请求
+ * @brief 填充 WiFi 状态 JSON
  *
- * 返回当前 WiFi 连接状态、IP 地址、设备信息等
+ * 当前 WiFi 连接状态、IP 地址、设备信息、启动时间线等
+ * (AP 配网模式 /status 与 STA 模式 HttpApi /status 共用)
  */
-void WebConfigManager_::handleStatus()
+void WebConfigManager_::buildStatusJson(JsonDocument &doc)
 {
-    DynamicJsonDocument doc(512);
-
     doc["state"] = (int)connState;
 
     switch (connState)
@@ -596,6 +576,16 @@ void WebConfigManager_::handleStatus()
     doc["savedSSID"] = savedSSID;
     doc["freeHeap"] = ESP.getFreeHeap();
     doc["uptime"] = millis() / 1000;
+    BootTimeline.toJson(doc.createNestedObject("boot"));
+}
+
+/**
+ * @brief 处理 WiFi 状态查询请求
+ */
+void WebConfigManager_::handleStatus()
+{
+    DynamicJsonDocument doc(2048);
+    buildStatusJson(doc);
 
     String output;
     serializeJson(doc, output);
@@ -1504,7 +1494,7 @@ void WebConfigManager_::startMDNS()
 
         // 添加设备信息
         MDNS.addServiceTxt(MDNS_SERVICE, "tcp", "device", "NeoClock");
-        MDNS.addServiceTxt(MDNS_SERVICE, "tcp", "version", "1.0");
+        MDNS.addServiceTxt(MDNS_SERVICE, "tcp", "version", FIRMWARE_VERSION);
     }
     else
     {
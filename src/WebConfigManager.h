@@ -14,6 +14,7 @@
 #define WEB_CONFIG_MANAGER_H
 
 #include <Arduino.h>
+#include <ArduinoJson.h>
 #include <DNSServer.h>
 #include <ESPmDNS.h>
 #include <Preferences.h>
@@ -173,14 +174,13 @@ private:
   void clearCredentials();
 
   /**
-   * @brief 尝试连接 WiFi
+   * @brief 发起 WiFi 连接 (非阻塞)
    * @param ssid WiFi 名称
    * @param password WiFi 密码
-   * @param timeout 连接超时 (毫秒)
-   * @return true=连接成功, false=连接失败
+   *
+   * 进入 WIFI_STATE_CONNECTING，结果由 tick() 检测
    */
-  bool tryConnect(const String &ssid, const String &password,
-                  unsigned long timeout = WIFI_CONNECT_TIMEOUT);
+  void beginConnect(const String &ssid, const String &password);
 
   /// 启动 AP 配网模式
   void startAPMode();
@@ -248,10 +248,16 @@ public:
    */
   static WebConfigManager_ &getInstance();
 
+  /**
+   * @brief 填充 WiFi 状态 JSON (/status 的响应内容)
+   * @param doc 目标 JSON 文档 (建议容量 2048)
+   */
+  void buildStatusJson(JsonDocument &doc);
+
   /**
    * @brief 初始化配网管理器
    *
-   * 检查已保存凭据 → 尝试连接 → 失败则启动 AP 配网
+   * 检查已保存凭据 → 发起异步连接 → 超时则启动 AP 配网 (不阻塞)
    */
   void setup();
 
@@ -11,17 +11,28 @@
  * 矩阵规格: 32×8 LED (WS2812B/SK6812)
  */
 
+#include "BootTimeline.h"
+#include "ClockService.h"
+#include "CustomApps.h"
 #include "DisplayManager.h"
+#include "HeapTelemetry.h"
+#include "HttpApi.h"
 #include "Liveview.h"
 #include "Logger.h"
+#include "LoopWatchdog.h"
+#include "MqttManager.h"
 #include "PeripheryManager.h"
 #include "ServerManager.h"
+#include "StackMonitor.h"
+#include "TimeSync.h"
+#include "TimerManager.h"
 #include "WeatherManager.h"
 #include "WebConfigManager.h"
 #include <Arduino.h>
 #include <ArduinoOTA.h>
 #include <WebSocketsServer.h>
 #include <WiFi.h>
+#include <time.h>
 
 #include "Apps.h"
 
@@ -31,126 +42,210 @@
 WebSocketsServer webSocket(81);
 
 // ==================================================================
-// 系统初始化
+// 启动状态机
 // ==================================================================
 
+/// 启动阶段 (每次 loop() 推进一步，阶段之间照常渲染帧)
+enum BootStage
+{
+  BOOT_FS = 0,    ///< 挂载 LittleFS
+  BOOT_SETTINGS,  ///< 加载全局设置
+  BOOT_APPS,      ///< 加载应用 (时间有效则立即显示时钟)
+  BOOT_PERIPHERY, ///< 外设 (DHT22 首次读取、LDR、按钮)
+  BOOT_NETWORK,   ///< WiFi 配网管理器 (非阻塞连接) + 天气任务
+  BOOT_SERVICES,  ///< WebSocket / Liveview
+  BOOT_DONE       ///< 启动完成
+};
+
+static BootStage bootStage = BOOT_FS;
+
+/// OTA 是否已启用 (WiFi 首次连上时启用)
+static bool otaStarted = false;
+
+/// 时钟是否已有有效时间 (RTC 软复位保持 / 上次同步)
+static bool clockValid()
+{
+  return time(nullptr) > 1700000000; // 2023-11 之后视为有效
+}
+
 /**
- * @brief 系统初始化函数
+ * @brief 初始化 OTA 升级 (需要 WiFi 已连接)
+ */
+static void setupOTA()
+{
+  ArduinoOTA.onStart([]()
+                     { LOG_INFO("[OTA] 开始升级..."); });
+  ArduinoOTA.onEnd([]()
+                   { LOG_INFO("[OTA] 升级完成，重启中..."); });
+  ArduinoOTA.onProgress([](unsigned int progress, unsigned int total)
+                        { LOG_INFO("[OTA] 进度: %u%%", (progress / (total / 100))); });
+  ArduinoOTA.onError([](ota_error_t error)
+                     { LOG_ERROR("[OTA] 错误: %d", error); });
+  ArduinoOTA.begin();
+  otaStarted = true;
+  LOG_INFO("[Main] OTA 升级已启用");
+}
+
+/**
+ * @brief 推进一个启动阶段
  *
- * 初始化顺序：
- *   1. 串口通信
- *   2. LittleFS 文件系统
- *   3. 外设 (DHT22、LDR)
- *   4. LED 矩阵显示
- *   5. 加载配置
- *   6. WiFi 配网管理器 (核心)
- *   7. 天气管理器
- *   8. 应用加载
- *   9. WebSocket 服务器
- *   10. Liveview 实时预览
+ * 每个阶段只做一件事，做完立即返回，让 loop() 继续渲染启动画面/连接动画。
+ * WiFi 连接不在此等待，由 WebConfigManager.tick() 异步检测结果。
  */
-void setup()
+static void bootStep()
 {
-  // 初始化日志系统
-  Logger_Init();
+  switch (bootStage)
+  {
+  case BOOT_FS:
+    LOG_INFO("[Main] 初始化文件系统...");
+    BootTimeline.phaseBegin(BOOT_PHASE_FS);
+    if (!LittleFS.begin(true, "/littlefs"))
+    {
+      LOG_WARN("[Main] LittleFS 挂载失败！正在格式化...");
+    }
+    else
+    {
+      LOG_INFO("[Main] LittleFS 挂载成功");
+    }
+    BootTimeline.phaseEnd(BOOT_PHASE_FS);
+    bootStage = BOOT_SETTINGS;
+    break;
 
-  LOG_INFO("[Main] === NeoClock 矩阵时钟启动 ===");
+  case BOOT_SETTINGS:
+    LOG_INFO("[Main] 加载设置...");
+    BootTimeline.phaseBegin(BOOT_PHASE_SETTINGS);
+    loadSettings();
+    BootTimeline.phaseEnd(BOOT_PHASE_SETTINGS);
+    bootStage = BOOT_APPS;
+    break;
 
-  // 初始化 LittleFS 文件系统
-  LOG_INFO("[Main] 初始化文件系统...");
-  if (!LittleFS.begin(true, "/littlefs"))
-  {
-    LOG_WARN("[Main] LittleFS 挂载失败！正在格式化...");
-  }
-  else
-  {
-    LOG_INFO("[Main] LittleFS 挂载成功");
-  }
+  case BOOT_APPS:
+    LOG_INFO("[Main] 加载应用...");
+    BootTimeline.phaseBegin(BOOT_PHASE_APPS);
+    DisplayManager.loadNativeApps();
+    DisplayManager.applyAllSettings();
+    TimerManager.setup();
+    BootTimeline.phaseEnd(BOOT_PHASE_APPS);
+    // RTC 中已有时间 (软复位后保持) 则立即显示时钟，无需等待 NTP
+    if (clockValid())
+    {
+      DisplayManager.setDisplayStatus(DISPLAY_NORMAL);
+    }
+    bootStage = BOOT_PERIPHERY;
+    break;
 
-  // 初始化外设（传感器等）
-  PeripheryManager.setup();
+  case BOOT_PERIPHERY:
+    BootTimeline.phaseBegin(BOOT_PHASE_PERIPHERY);
+    PeripheryManager.setup();
+    BootTimeline.phaseEnd(BOOT_PHASE_PERIPHERY);
+    bootStage = BOOT_NETWORK;
+    break;
 
-  // 初始化显示
-  DisplayManager.setup();
+  case BOOT_NETWORK:
+    // 自动处理：已保存WiFi凭据→发起连接(不等待)→超时则启动AP配网
+    LOG_INFO("[Main] 启动配网管理器...");
+    BootTimeline.phaseBegin(BOOT_PHASE_NETWORK);
+    BootTimeline.phaseBegin(BOOT_PHASE_WIFI);
+    WebConfigManager.setup();
+    // 时钟已在显示时不用连接动画覆盖它
+    if (clockValid() && WebConfigManager.getState() == WIFI_STATE_CONNECTING)
+    {
+      DisplayManager.setDisplayStatus(DISPLAY_NORMAL);
+    }
+
+    // 启动天气管理器 (后台任务会自动等到WiFi连接)
+    WeatherManager.setup();
+    BootTimeline.phaseEnd(BOOT_PHASE_NETWORK);
+    bootStage = BOOT_SERVICES;
+    break;
 
-  // 加载全局设置
-  LOG_INFO("[Main] 加载设置...");
-  loadSettings();
-
-  // 显示启动画面 (3秒)
-  DisplayManager.clear();
-  DisplayManager.defaultTextColor();
-  DisplayManager.printText(0, 6, "NClock", true, true);
-  DisplayManager.show();
-  delay(3000);
-
-  // ========================================
-  // Web 配网管理器 (核心！)
-  // 自动处理：已保存WiFi凭据→尝试连接→失败则启动AP配网
-  // ========================================
-  LOG_INFO("[Main] 启动配网管理器...");
-  WebConfigManager.setup();
-
-  // 启动天气管理器 (后台任务会自动等到WiFi连接)
-  WeatherManager.setup();
-
-  delay(500); // 给一点时间让后台任务启动
-
-  // 加载应用
-  LOG_INFO("[Main] 加载应用...");
-  DisplayManager.loadNativeApps();
-  DisplayManager.applyAllSettings();
-
-  // 启动WebSocket服务器
-  LOG_INFO("[Main] 启动WebSocket服务器...");
-  ServerManager.setup(&webSocket);
-
-  // 初始化 Liveview
-  LOG_INFO("[Main] 初始化 Liveview...");
-  Liveview.setCallback([](const char *data, size_t length)
-                       {
+  case BOOT_SERVICES:
+    // 启动WebSocket服务器
+    LOG_INFO("[Main] 启动WebSocket服务器...");
+    BootTimeline.phaseBegin(BOOT_PHASE_WEBSOCKET);
+    ServerManager.setup(&webSocket);
+    BootTimeline.phaseEnd(BOOT_PHASE_WEBSOCKET);
+    MqttManager.setup();
+
+    // 初始化 Liveview
+    LOG_INFO("[Main] 初始化 Liveview...");
+    Liveview.setCallback([](const char *data, size_t length)
+                         {
     if (WebConfigManager.isConnected()) {
       // ServerManager.sendLiveviewData(data, length);
     } });
 
-  if (WebConfigManager.isAPMode())
-  {
-    // AP 配网模式提示
-    LOG_WARN("[Main] WiFi 未连接，进入配网模式");
-    LOG_INFO("[Main] 请连接热点: %s", WebConfigManager.getAPName().c_str());
-    LOG_INFO("[Main] 并访问 http://192.168.4.1 进行配网");
-  }
+    if (WebConfigManager.isAPMode())
+    {
+      // AP 配网模式提示
+      LOG_WARN("[Main] WiFi 未连接，进入配网模式");
+      LOG_INFO("[Main] 请连接热点: %s", WebConfigManager.getAPName().c_str());
+      LOG_INFO("[Main] 并访问 http://192.168.4.1 进行配网");
+    }
 
-  LOG_INFO("========================================");
-  LOG_INFO("   系统初始化完成");
-  LOG_INFO("========================================");
+    LOG_INFO("========================================");
+    LOG_INFO("   系统初始化完成 (%lu ms)", millis());
+    LOG_INFO("========================================");
+    LOG_INFO("[Main] 应用数量: %d", (int)Apps.size());
+    LOG_INFO("[Main] Web控制面板: http://[Device IP]");
+    LOG_INFO("[Main] WebSocket: ws://[Device IP]:81");
+    LOG_INFO("========================================");
+    BootTimeline.finish();
+    bootStage = BOOT_DONE;
+    break;
 
-  if (WebConfigManager.isConnected())
-  {
-    LOG_INFO("[Main] WiFi: 已连接 (%s)", WiFi.SSID().c_str());
-    LOG_INFO("[Main] IP 地址: %s", WiFi.localIP().toString().c_str());
-
-    // 初始化 OTA 升级
-    ArduinoOTA.onStart([]()
-                       { LOG_INFO("[OTA] 开始升级..."); });
-    ArduinoOTA.onEnd([]()
-                     { LOG_INFO("[OTA] 升级完成，重启中..."); });
-    ArduinoOTA.onProgress([](unsigned int progress, unsigned int total)
-                          { LOG_INFO("[OTA] 进度: %u%%", (progress / (total / 100))); });
-    ArduinoOTA.onError([](ota_error_t error)
-                       { LOG_ERROR("[OTA] 错误: %d", error); });
-    ArduinoOTA.begin();
-    LOG_INFO("[Main] OTA 升级已启用");
-  }
-  else
-  {
-    LOG_INFO("[Main] 模式: AP 配网 (IP: %s)", WiFi.softAPIP().toString().c_str());
+  case BOOT_DONE:
+  default:
+    break;
   }
+}
+
+// ==================================================================
+// 系统初始化
+// ==================================================================
 
-  LOG_INFO("[Main] 应用数量: %d", Apps.size());
-  LOG_INFO("[Main] Web控制面板: http://[Device IP]");
-  LOG_INFO("[Main] WebSocket: ws://[Device IP]:81");
-  LOG_INFO("========================================");
+/**
+ * @brief 系统初始化函数
+ *
+ * 只做首帧所需的最小初始化 (日志、LED 矩阵)，立即显示启动画面。
+ * 其余初始化由 bootStep() 在 loop() 中逐阶段完成：
+ *   1. LittleFS 文件系统
+ *   2. 加载配置
+ *   3. 应用加载 (RTC 时间有效时立即显示时钟)
+ *   4. 外设 (DHT22、LDR、按钮)
+ *   5. WiFi 配网管理器 (非阻塞) + 天气管理器
+ *   6. WebSocket 服务器 + Liveview 实时预览
+ */
+void setup()
+{
+  // 堆遥测 (从此开始按子系统统计主循环任务的分配)
+  HeapTelemetry.begin();
+
+  // 初始化日志系统
+  Logger_Init();
+
+  LOG_INFO("[Main] === NeoClock 矩阵时钟启动 ===");
+
+  // 启动时间线 (读取上一次启动记录)
+  BootTimeline.begin();
+
+  // 主循环延迟看门狗 (恢复软复位前的超时记录)
+  LoopWatchdog.begin();
+
+  // 任务栈高水位监视 (登记主循环任务)
+  StackMonitor.begin();
+
+  // 时区先于网络设置，RTC 中保持的时间可直接按本地时间显示
+  setenv("TZ", "CST-8", 1);
+  tzset();
+
+  // 初始化显示并立即输出第一帧启动画面
+  BootTimeline.phaseBegin(BOOT_PHASE_DISPLAY);
+  DisplayManager.setup();
+  BootTimeline.phaseEnd(BOOT_PHASE_DISPLAY);
+  DisplayManager.setDisplayStatus(DISPLAY_BOOT, "NClock");
+  DisplayManager.tick();
+  BootTimeline.markFirstFrame();
 }
 
 // ==================================================================
@@ -161,42 +256,112 @@ void setup()
  * @brief 主循环函数
  *
  * 循环顺序 (保证性能和正确性)：
+ *   0. bootStep() - 启动阶段未完成时推进一步
  *   1. WebConfigManager.tick() - 始终需要 (处理配网、DNS、重连等)
  *   2. DisplayManager.tick() - 渲染当前帧到 leds[]
  *   3. Liveview.tick() - 采样 leds[] (纯内存操作，极快)
  *   4. PeripheryManager.tick() - 传感器读取、LDR 更新
- *   5. ServerManager.tick() - WebSocket 收包处理 (ws->loop())
+ *   5. ServerManager.tick() - WebSocket 收包处理 (ws->loop())，HttpApi / MqttManager
  *   6. Liveview.flush() - 发送采样帧 (TCP 缓冲区最宽裕时)
  *
+ * 每个阶段由 LoopWatchdog 计时，超出预算时记录并推送给 WebSocket 客户端。
+ *
  * 性能优化：
  *   - Liveview 采样在 ws->loop() 之前，避免网络延迟影响渲染
  *   - Liveview.flush() 在 ws->loop() 之后，此时 TCP 缓冲区腾空，阻塞概率最低
  */
 void loop()
 {
+  LoopWatchdog.stageBegin(LOOP_STAGE_LOOP);
+
+  // 启动阶段：每帧推进一步，不阻塞渲染
+  if (bootStage != BOOT_DONE)
+  {
+    LoopWatchdog.stageBegin(LOOP_STAGE_BOOT);
+    bootStep();
+    LoopWatchdog.stageEnd(LOOP_STAGE_BOOT);
+  }
+
   // 配网管理器始终需要 tick（处理HTTP请求、DNS、断线重连等）
-  WebConfigManager.tick();
+  if (bootStage > BOOT_NETWORK)
+  {
+    LoopWatchdog.stageBegin(LOOP_STAGE_NETWORK);
+    WebConfigManager.tick();
+    LoopWatchdog.stageEnd(LOOP_STAGE_NETWORK);
+  }
 
-  // 1. 渲染当前帧到 leds[]
+  // 1. 渲染当前帧到 leds[] (时钟服务先刷新本秒的时间缓存)
+  LoopWatchdog.stageBegin(LOOP_STAGE_DISPLAY);
+  TimeSync.tick();
+  ClockService.tick();
   DisplayManager.tick();
+  LoopWatchdog.stageEnd(LOOP_STAGE_DISPLAY);
+  if (DisplayManager.getDisplayStatus() == DISPLAY_NORMAL)
+  {
+    BootTimeline.markFirstApp();
+  }
 
   // 2. 立即采样 leds[]（纯内存操作，≈几十μs，不阻塞渲染）
+  LoopWatchdog.stageBegin(LOOP_STAGE_LIVEVIEW);
   Liveview.tick();
+  LoopWatchdog.stageEnd(LOOP_STAGE_LIVEVIEW);
 
   // 外设管理器始终 tick
-  PeripheryManager.tick();
+  if (bootStage > BOOT_PERIPHERY)
+  {
+    LoopWatchdog.stageBegin(LOOP_STAGE_PERIPHERY);
+    PeripheryManager.tick();
+    LoopWatchdog.stageEnd(LOOP_STAGE_PERIPHERY);
+  }
+
+  // 清理过期的自定义应用，推进闹钟/计时时间轮
+  if (bootStage > BOOT_APPS)
+  {
+    LoopWatchdog.stageBegin(LOOP_STAGE_APPS);
+    CustomApps.tick();
+    TimerManager.tick();
+    LoopWatchdog.stageEnd(LOOP_STAGE_APPS);
+  }
 
   // 3. WebSocket 收包处理（ws->loop），让 TCP 内核缓冲区尽量腾空
-  if (WebConfigManager.isConnected())
+  if (bootStage == BOOT_DONE && WebConfigManager.isConnected())
   {
+    if (!otaStarted)
+    {
+      LOG_INFO("[Main] WiFi: 已连接 (%s)", WiFi.SSID().c_str());
+      LOG_INFO("[Main] IP 地址: %s", WiFi.localIP().toString().c_str());
+      BootTimeline.phaseEnd(BOOT_PHASE_WIFI);
+      setupOTA();
+    }
+    LoopWatchdog.stageBegin(LOOP_STAGE_SERVER);
     ServerManager.tick();
+    LoopWatchdog.stageEnd(LOOP_STAGE_SERVER);
+    LoopWatchdog.stageBegin(LOOP_STAGE_HTTP);
+    HttpApi.tick();
+    LoopWatchdog.stageEnd(LOOP_STAGE_HTTP);
+    LoopWatchdog.stageBegin(LOOP_STAGE_MQTT);
+    MqttManager.tick();
+    LoopWatchdog.stageEnd(LOOP_STAGE_MQTT);
     // OTA 升级处理
+    LoopWatchdog.stageBegin(LOOP_STAGE_OTA);
     ArduinoOTA.handle();
+    LoopWatchdog.stageEnd(LOOP_STAGE_OTA);
   }
 
   // 4. 发送采样帧（在 ws->loop() 之后，TCP 缓冲区最宽裕，阻塞概率最低）
-  if (WebConfigManager.isConnected())
+  if (bootStage == BOOT_DONE && WebConfigManager.isConnected())
   {
+    LoopWatchdog.stageBegin(LOOP_STAGE_LIVEVIEW);
     Liveview.flush();
+    LoopWatchdog.stageEnd(LOOP_STAGE_LIVEVIEW);
   }
+
+  // 定期堆采样 (空闲、最大空闲块、历史最低) 与任务栈高水位采样
+  HeapTelemetry.tick();
+  if (bootStage == BOOT_DONE)
+  {
+    StackMonitor.tick();
+  }
+
+  LoopWatchdog.stageEnd(LOOP_STAGE_LOOP);
 }
@@ -0,0 +1,116 @@
+#!/usr/bin/env python3
+"""
+BDF 点阵字体 → NeoClock 字库 (.ncf) 转换工具
+
+只转换 U+0100 以上的字符 (ASCII/Latin-1 由固件内置 AwtrixFont 显示)。
+可用 --chars 指定一个文本文件，只保留其中出现的字符，生成常用字子集。
+
+用法:
+    python3 tools/bdf2ncf.py font.bdf data/fonts/cjk.ncf --chars tools/fonts/chars.txt
+    pio run -t uploadfs
+
+字体来源、许可证与字表说明见 tools/fonts/README.md。
+
+格式见 src/GlyphCache.h。
+"""
+
+import argparse
+import struct
+import sys
+
+HEIGHT = 8       # 显示高度 (行)
+MAX_WIDTH = 8    # 单字最大列数 (GLYPH_MAX_WIDTH)
+BLOCK_SIZE = 64  # 每块条目数 (GLYPH_MAX_BLOCK)
+MAX_BLOCKS = 256
+
+
+def parse_bdf(path):
+    """返回 {码点: (宽度, [行位图...], bbx_y, 字体上沿)}"""
+    glyphs = {}
+    ascent = HEIGHT
+    with open(path, encoding="latin-1") as f:
+        lines = iter(f.read().splitlines())
+    for line in lines:
+        if line.startswith("FONT_ASCENT"):
+            ascent = int(line.split()[1])
+        if not line.startswith("STARTCHAR"):
+            continue
+        code, dwidth, bbx, rows = -1, 0, (0, 0, 0, 0), []
+        for line in lines:
+            if line.startswith("ENCODING"):
+                code = int(line.split()[1])
+            elif line.startswith("DWIDTH"):
+                dwidth = int(line.split()[1])
+            elif line.startswith("BBX"):
+                bbx = tuple(int(v) for v in line.split()[1:5])
+            elif line.startswith("BITMAP"):
+                for line in lines:
+                    if line.startswith("ENDCHAR"):
+                        break
+                    rows.append(int(line, 16) << (32 - len(line) * 4))
+                break
+        if code > 0:
+            glyphs[code] = (dwidth, bbx, rows, ascent)
+    return glyphs
+
+
+def to_columns(dwidth, bbx, rows, ascent):
+    """行位图 → 列位图 (bit n = 第 n 行)"""
+    w, h, xoff, yoff = bbx
+    top = ascent - (yoff + h)  # 第一行位图在字体中的行号
+    advance = min(max(dwidth, w + xoff), MAX_WIDTH)
+    cols = [0] * advance
+    for r, bits in enumerate(rows):
+        y = top + r
+        if y < 0 or y >= HEIGHT:
+            continue
+        for x in range(w):
+            col = xoff + x
+            if 0 <= col < advance and bits & (1 << (31 - x)):
+                cols[col] |= 1 << y
+    return advance, cols
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument("bdf")
+    parser.add_argument("output")
+    parser.add_argument("--chars", help="只保留该 UTF-8 文本文件中出现的字符")
+    args = parser.parse_args()
+
+    glyphs = parse_bdf(args.bdf)
+    codes = sorted(c for c in glyphs if c >= 0x100)
+    if args.chars:
+        with open(args.chars, encoding="utf-8") as f:
+            wanted = {ord(ch) for ch in f.read() if ord(ch) >= 0x100}
+        codes = [c for c in codes if c in wanted]
+        missing = sorted(wanted - set(codes))
+        if missing:
+            print(f"字体中缺少 {len(missing)} 字: "
+                  + "".join(chr(c) for c in missing[:40]), file=sys.stderr)
+
+    max_glyphs = BLOCK_SIZE * MAX_BLOCKS
+    if len(codes) > max_glyphs:
+        sys.exit(f"字符过多: {len(codes)} > {max_glyphs}，请用 --chars 选取子集")
+
+    index, bitmaps = [], bytearray()
+    for code in codes:
+        advance, cols = to_columns(*glyphs[code])
+        index.append(code << 8 | advance)
+        bitmaps += bytes(cols + [0] * (MAX_WIDTH - len(cols)))
+
+    blocks = [codes[i] for i in range(0, len(codes), BLOCK_SIZE)]
+    with open(args.output, "wb") as f:
+        f.write(b"NCF1")
+        f.write(struct.pack("<HBBHHI", len(codes), HEIGHT, MAX_WIDTH,
+                            BLOCK_SIZE, len(blocks), 0))
+        f.write(struct.pack(f"<{len(blocks)}I", *blocks))
+        f.write(struct.pack(f"<{len(index)}I", *index))
+        f.write(bitmaps)
+
+    size = 16 + len(blocks) * 4 + len(index) * 4 + len(bitmaps)
+    print(f"{len(codes)} 字, {len(blocks)} 块, {size} 字节 → {args.output}")
+
+
+if __name__ == "__main__":
+    main()